@@ -43,7 +43,11 @@ static bool winconinitialized = false;
 static FILE *confp;
 #endif
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
 
 bool Surge::Debug::openConsole()
 {
@@ -130,3 +134,37 @@ Surge::Debug::TimeBlock::~TimeBlock()
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     std::cout << "TimeBlock[" << tag << "]=" << duration.count() << " microsec" << std::endl;
 }
+
+#if SHOW_PAINT_TIMES
+Surge::Debug::TimeB::TimeB(const char *itag) : tag(itag)
+{
+    start = std::chrono::high_resolution_clock::now();
+}
+
+Surge::Debug::TimeB::~TimeB()
+{
+    struct Stats
+    {
+        int64_t count{0}, totalUs{0}, maxUs{0};
+    };
+
+    static std::mutex m;
+    static std::map<std::string, Stats> stats;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::lock_guard<std::mutex> g(m);
+    auto &s = stats[tag];
+
+    s.count++;
+    s.totalUs += us;
+    s.maxUs = std::max(s.maxUs, us);
+
+    if (s.count % 100 == 0)
+    {
+        std::cout << "Block in " << tag << " took " << s.totalUs / s.count << "us on average, "
+                  << s.maxUs << "us at most, over " << s.count << " runs" << std::endl;
+    }
+}
+#endif
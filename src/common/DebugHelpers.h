@@ -55,6 +55,23 @@ struct TimeBlock
     std::chrono::time_point<std::chrono::high_resolution_clock> start;
 };
 
+/*
+ * Like TimeBlock but quiet: it adds the time to a running count, total and maximum for its tag
+ * and reports those every hundred blocks. Only in builds with SHOW_PAINT_TIMES though; otherwise
+ * it compiles to nothing, so it can stay in paint code.
+ */
+struct TimeB
+{
+#if SHOW_PAINT_TIMES
+    TimeB(const char *tag);
+    ~TimeB();
+    const char *tag;
+    std::chrono::time_point<std::chrono::high_resolution_clock> start;
+#else
+    TimeB(const char *) {}
+#endif
+};
+
 } // namespace Debug
 } // namespace Surge
 
@@ -373,6 +373,7 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
         {
             target[i] = 0.f;
             value[i] = 0.f;
+            stepFraction[i] = 1.f;
             changed[i] = true;
         }
         smoothingMode = Modulator::SmoothingMode::LEGACY;
@@ -400,6 +401,16 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
         changed[idx] = true;
     }
 
+    /*
+     * set_target for a change which lands blockPosition (0..1) of the way into the coming block,
+     * so that block only takes the part of a smoothing step after the change
+     */
+    void set_target_in_block(int idx, float f, float blockPosition)
+    {
+        set_target(idx, f);
+        stepFraction[idx] = 1.f - std::clamp(blockPosition, 0.f, 1.f);
+    }
+
     void init(float f)
     {
         assert(NDX == 1);
@@ -497,6 +508,9 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
 
         for (int idx = 0; idx < NDX; ++idx)
         {
+            auto frac = stepFraction[idx];
+            stepFraction[idx] = 1.f;
+
             if (mode == Modulator::SmoothingMode::LEGACY ||
                 mode == Modulator::SmoothingMode::SLOW_EXP ||
                 mode == Modulator::SmoothingMode::FAST_EXP)
@@ -514,7 +528,8 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
                     float a =
                         std::clamp((mode == Modulator::SmoothingMode::FAST_EXP ? 0.99f : 0.9f) *
                                        44100 * samplerate_inv * b,
-                                   0.f, 1.f);
+                                   0.f, 1.f) *
+                        frac;
 
                     value[idx] = (1 - a) * value[idx] + a * target[idx];
                 }
@@ -527,7 +542,7 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
                 // Apply a constant change until we get there
                 // Rate is set so we cover the entire [0, 1] range in 50 blocks at 44.1k
                 float sampf = samplerate / 44100;
-                float da = (target[idx] - startingpoint[idx]) / (50 * sampf);
+                float da = frac * (target[idx] - startingpoint[idx]) / (50 * sampf);
                 float b = target[idx] - value[idx];
 
                 if (fabs(b) < fabs(da))
@@ -542,7 +557,8 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
 
             if (mode == Modulator::SmoothingMode::DIRECT)
             {
-                value[idx] = target[idx];
+                value[idx] = frac < 1.f ? value[idx] + frac * (target[idx] - value[idx])
+                                        : target[idx];
             }
 
             // Just in case #6835 sneaks back
@@ -581,7 +597,7 @@ template <int NDX = 1> class ControllerModulationSourceVector : public Modulatio
     virtual bool is_bipolar() override { return bipolar; }
     virtual void set_bipolar(bool b) override { bipolar = b; }
 
-    float target[NDX], startingpoint[NDX], value[NDX];
+    float target[NDX], startingpoint[NDX], value[NDX], stepFraction[NDX];
     int id; // can be used to assign the controller to a parameter id
     bool bipolar;
     bool changed[NDX];
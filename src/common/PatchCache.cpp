@@ -0,0 +1,756 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "PatchCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+
+#if WINDOWS
+#include "windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "UserDefaults.h"
+#include "fmt/core.h"
+#include "version.h"
+
+namespace Surge
+{
+namespace Storage
+{
+namespace
+{
+// Bump this whenever streamPatch or the header changes
+constexpr uint32_t snapshotFormat = 2;
+
+// A marker with no body: restoring this patch was shown not to match loading it
+constexpr uint32_t sf_uncacheable = 1 << 0;
+
+// Stores between prunes of the directory
+constexpr int storesPerPrune = 64;
+
+struct SnapshotHeader
+{
+    char magic[4];
+    uint32_t format;
+    uint64_t layout;
+    int64_t mtime;
+    uint64_t size, hash;
+    uint32_t prefs, flags;
+    uint32_t pathSize;
+    uint64_t bodySize, bodyHash;
+};
+
+void hashCombine(uint64_t &h, uint64_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); }
+
+uint64_t hashBytes(const void *data, size_t size)
+{
+    return std::hash<std::string_view>{}(std::string_view((const char *)data, size));
+}
+
+struct MappedFile
+{
+    explicit MappedFile(const fs::path &p)
+    {
+#if WINDOWS
+        file = CreateFileW(p.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER sz;
+
+        if (!GetFileSizeEx(file, &sz) || sz.QuadPart == 0)
+        {
+            return;
+        }
+
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (!mapping)
+        {
+            return;
+        }
+
+        auto d = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (d)
+        {
+            data = (const char *)d;
+            size = (size_t)sz.QuadPart;
+        }
+#else
+        fd = open(p.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            return;
+        }
+
+        auto d = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (d != MAP_FAILED)
+        {
+            data = (const char *)d;
+            size = (size_t)st.st_size;
+        }
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if WINDOWS
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (data)
+            munmap((void *)data, size);
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    const char *data{nullptr};
+    size_t size{0};
+
+  private:
+#if WINDOWS
+    HANDLE file{INVALID_HANDLE_VALUE}, mapping{nullptr};
+#else
+    int fd{-1};
+#endif
+};
+
+struct SnapshotWriter
+{
+    static constexpr bool reading = false;
+
+    std::vector<char> &out;
+    bool ok{true};
+
+    template <typename T> void pod(T &t)
+    {
+        static_assert(std::is_trivially_copyable<T>::value);
+        auto p = (const char *)&t;
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    void str(std::string &s)
+    {
+        auto n = (uint32_t)s.size();
+        pod(n);
+        out.insert(out.end(), s.begin(), s.end());
+    }
+
+    template <typename T> void vec(std::vector<T> &v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value);
+        auto n = (uint32_t)v.size();
+        pod(n);
+        auto p = (const char *)v.data();
+        out.insert(out.end(), p, p + n * sizeof(T));
+    }
+};
+
+struct SnapshotReader
+{
+    static constexpr bool reading = true;
+
+    const char *pos, *end;
+    bool ok{true};
+
+    template <typename T> void pod(T &t)
+    {
+        static_assert(std::is_trivially_copyable<T>::value);
+
+        if (!ok || (size_t)(end - pos) < sizeof(T))
+        {
+            ok = false;
+            return;
+        }
+
+        memcpy(&t, pos, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    void str(std::string &s)
+    {
+        uint32_t n{0};
+        pod(n);
+
+        if (!ok || (size_t)(end - pos) < n)
+        {
+            ok = false;
+            return;
+        }
+
+        s.assign(pos, n);
+        pos += n;
+    }
+
+    template <typename T> void vec(std::vector<T> &v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value);
+        uint32_t n{0};
+        pod(n);
+
+        if (!ok || (size_t)(end - pos) / sizeof(T) < n)
+        {
+            ok = false;
+            return;
+        }
+
+        v.resize(n);
+        memcpy(v.data(), pos, n * sizeof(T));
+        pos += n * sizeof(T);
+    }
+};
+
+/*
+ * Everything load_xml sets, in one place for both directions, so capture and restore can't
+ * drift apart. When reading, the values go straight into the patch and its storage. Whatever
+ * load_xml leaves alone for a preset is left out here too.
+ */
+template <typename S>
+void streamPatch(S &s, SurgePatch &patch, SurgeStorage *storage, bool preset)
+{
+    s.pod(patch.streamingRevision);
+    s.pod(patch.currentSynthStreamingRevision);
+    s.pod(patch.correctlyTuneCombFilter);
+
+    if (!preset)
+    {
+        s.str(patch.name);
+        s.str(patch.category);
+    }
+
+    s.str(patch.comment);
+    s.str(patch.author);
+    s.str(patch.license);
+
+    auto nTags = (uint32_t)patch.tags.size();
+    s.pod(nTags);
+
+    if constexpr (S::reading)
+    {
+        patch.tags.clear();
+
+        for (uint32_t i = 0; i < nTags && s.ok; ++i)
+        {
+            std::string t;
+            s.str(t);
+            patch.tags.emplace_back(t);
+        }
+    }
+    else
+    {
+        for (auto &t : patch.tags)
+        {
+            s.str(t.tag);
+        }
+    }
+
+    enum ParamFlags : uint8_t
+    {
+        pf_temposync = 1 << 0,
+        pf_extend_range = 1 << 1,
+        pf_absolute = 1 << 2,
+        pf_deactivated = 1 << 3,
+        pf_porta_constrate = 1 << 4,
+        pf_porta_gliss = 1 << 5,
+        pf_porta_retrigger = 1 << 6,
+    };
+
+    for (auto *p : patch.param_ptr)
+    {
+        if (preset && (p == &patch.fx_bypass ||
+                       (p == &patch.volume && patch.streamingRevision < 17)))
+        {
+            continue;
+        }
+
+        auto val = p->val;
+        uint8_t flags = (p->temposync ? pf_temposync : 0) |
+                        (p->extend_range ? pf_extend_range : 0) |
+                        (p->absolute ? pf_absolute : 0) | (p->deactivated ? pf_deactivated : 0) |
+                        (p->porta_constrate ? pf_porta_constrate : 0) |
+                        (p->porta_gliss ? pf_porta_gliss : 0) |
+                        (p->porta_retrigger ? pf_porta_retrigger : 0);
+        int32_t portaCurve = p->porta_curve, deformType = p->deform_type;
+
+        s.pod(val);
+        s.pod(flags);
+        s.pod(portaCurve);
+        s.pod(deformType);
+
+        if constexpr (S::reading)
+        {
+            if (!s.ok)
+            {
+                return;
+            }
+
+            p->temposync = flags & pf_temposync;
+            p->absolute = flags & pf_absolute;
+            p->deactivated = flags & pf_deactivated;
+            p->porta_constrate = flags & pf_porta_constrate;
+            p->porta_gliss = flags & pf_porta_gliss;
+            p->porta_retrigger = flags & pf_porta_retrigger;
+            p->porta_curve = portaCurve;
+            p->deform_type = deformType;
+
+            // this can move the range and clamp the value, so it goes first like in load_xml
+            p->set_extend_range(flags & pf_extend_range);
+            p->val = val;
+        }
+    }
+
+    s.vec(patch.modulation_global);
+
+    for (auto &sc : patch.scene)
+    {
+        s.vec(sc.modulation_scene);
+        s.vec(sc.modulation_voice);
+        s.pod(sc.monoVoicePriorityMode);
+        s.pod(sc.monoVoiceEnvelopeMode);
+        s.pod(sc.polyVoiceRepeatedKeyMode);
+
+        for (auto &osc : sc.osc)
+        {
+            s.str(osc.wavetable_display_name);
+            s.str(osc.wavetable_formula);
+            s.pod(osc.wavetable_formula_nframes);
+            s.pod(osc.wavetable_formula_res_base);
+            s.pod(osc.extraConfig);
+        }
+
+        for (auto &lfo : sc.lfo)
+        {
+            s.pod(lfo.lfoExtraAmplitude);
+        }
+    }
+
+    auto tam = storage->patchStoredTuningApplicationMode;
+    s.pod(tam);
+    s.pod(storage->hardclipMode);
+    s.pod(storage->sceneHardclipMode);
+    s.pod(storage->unstreamedTempo);
+
+    if constexpr (S::reading)
+    {
+        if (s.ok)
+        {
+            storage->setTuningApplicationMode(tam);
+        }
+    }
+
+    s.pod(patch.stepsequences);
+    s.pod(patch.msegs);
+
+    for (auto &fms : patch.formulamods)
+    {
+        for (auto &fm : fms)
+        {
+            if constexpr (S::reading)
+            {
+                std::string f;
+                s.str(f);
+                fm.setFormula(f);
+            }
+            else
+            {
+                s.str(fm.formulaString);
+            }
+
+            s.pod(fm.interpreter);
+        }
+    }
+
+    for (int i = 0; i < n_customcontrollers; i++)
+    {
+        auto cms = (ControllerModulationSource *)patch.scene[0].modsources[ms_ctrl1 + i];
+        bool bipolar = cms->is_bipolar();
+        float target = cms->target[0];
+
+        s.pod(bipolar);
+        s.pod(target);
+
+        if constexpr (S::reading)
+        {
+            if (s.ok)
+            {
+                cms->reset();
+                cms->set_bipolar(bipolar);
+                cms->init(target);
+            }
+        }
+    }
+
+    s.pod(patch.CustomControllerLabel);
+    s.pod(patch.LFOBankLabel);
+
+    s.pod(patch.patchTuning.tuningStoredInPatch);
+    s.str(patch.patchTuning.scaleContents);
+    s.str(patch.patchTuning.mappingContents);
+    s.str(patch.patchTuning.mappingName);
+}
+} // namespace
+
+PatchCache::PatchCache(SurgeStorage *s, const fs::path &d) : storage(s), dir(d)
+{
+    // anything which moves the parameters or the snapshotted structs around invalidates the cache
+    auto &patch = storage->getPatch();
+
+    hashCombine(layout, std::hash<std::string>{}(Surge::Build::FullVersionStr));
+    hashCombine(layout, ff_revision);
+    hashCombine(layout, patch.param_ptr.size());
+
+    for (auto *p : patch.param_ptr)
+    {
+        hashCombine(layout, std::hash<std::string>{}(p->get_storage_name()));
+    }
+
+    hashCombine(layout, sizeof(ModulationRouting));
+    hashCombine(layout, sizeof(OscillatorStorage::ExtraConfigurationData));
+    hashCombine(layout, sizeof(StepSequencerStorage));
+    hashCombine(layout, sizeof(MSEGStorage));
+
+    prune();
+}
+
+bool PatchCache::makeKey(const fs::path &source, const void *data, int size, Key &key) const
+{
+    std::error_code ec;
+    auto mtime = fs::last_write_time(source, ec);
+
+    if (ec)
+    {
+        return false;
+    }
+
+    key.path = path_to_string(source);
+    key.mtime = (int64_t)mtime.time_since_epoch().count();
+    key.size = (uint64_t)size;
+    key.hash = hashBytes(data, size);
+
+    // load_xml reads these preferences, so a snapshot only holds for the ones it was made with
+    bool restoreSnap = Surge::Storage::getUserDefaultValue(
+        storage, Surge::Storage::RestoreMSEGSnapFromPatch, true);
+    bool overrideTempo = Surge::Storage::getUserDefaultValue(
+        storage, Surge::Storage::OverrideTempoOnPatchLoad, true);
+
+    key.prefs = (restoreSnap ? 1 : 0) | (overrideTempo ? 2 : 0) | (key.preset ? 4 : 0);
+
+    return true;
+}
+
+fs::path PatchCache::snapshotPath(const Key &key) const
+{
+    return dir / fmt::format("{:016x}.sxpc", (uint64_t)std::hash<std::string>{}(key.path));
+}
+
+void PatchCache::load(SurgePatch &patch, const fs::path &source, const void *data, int size,
+                      bool preset)
+{
+    Key key;
+    key.preset = preset;
+    bool keyed = makeKey(source, data, size, key);
+    auto restored = keyed ? restore(patch, key) : kMissing;
+
+    if (restored == kRestored)
+    {
+        patch.load_patch_wavetables(data, size);
+        stats.restored++;
+        return;
+    }
+
+    if (restored == kUncacheable)
+    {
+        stats.skipped++;
+    }
+
+    patch.load_patch_xml(data, size, preset);
+
+    // DAW state is per session, and a patch from a newer Surge should keep reporting that
+    bool cacheable = keyed && restored == kMissing && !patch.dawExtraState.isPopulated &&
+                     patch.streamingRevision <= patch.currentSynthStreamingRevision;
+
+    if (cacheable)
+    {
+        std::vector<char> snapshot;
+        SnapshotWriter w{snapshot};
+        streamPatch(w, patch, storage, key.preset);
+
+        store(patch, key, snapshot, data, size);
+    }
+
+    // the snapshot doesn't hold the wavetables, so either way they are only built here
+    patch.load_patch_wavetables(data, size);
+}
+
+PatchCache::Restored PatchCache::restore(SurgePatch &patch, const Key &key)
+{
+    MappedFile f(snapshotPath(key));
+
+    if (!f.data || f.size < sizeof(SnapshotHeader))
+    {
+        return kMissing;
+    }
+
+    SnapshotHeader h;
+    memcpy(&h, f.data, sizeof(h));
+
+    if (memcmp(h.magic, "SXPC", 4) || h.format != snapshotFormat || h.layout != layout ||
+        h.mtime != key.mtime || h.size != key.size || h.hash != key.hash ||
+        h.prefs != key.prefs || h.pathSize != key.path.size() ||
+        f.size - sizeof(h) < (uint64_t)h.pathSize + h.bodySize ||
+        memcmp(f.data + sizeof(h), key.path.data(), h.pathSize))
+    {
+        return kMissing;
+    }
+
+    auto body = f.data + sizeof(h) + h.pathSize;
+
+    if (hashBytes(body, h.bodySize) != h.bodyHash)
+    {
+        return kMissing;
+    }
+
+    if (h.flags & sf_uncacheable)
+    {
+        return kUncacheable;
+    }
+
+    SnapshotReader r{body, body + h.bodySize};
+    streamPatch(r, patch, storage, key.preset);
+
+    if (!r.ok || r.pos != r.end)
+    {
+        // we may have got part way, so start the real load from a clean patch
+        patch.init_default_values();
+        return kMissing;
+    }
+
+    return kRestored;
+}
+
+void PatchCache::store(SurgePatch &patch, const Key &key, const std::vector<char> &snapshot,
+                       const void *data, int size)
+{
+    /*
+     * Prove the snapshot first: restore it over a reset patch, the way the next load will,
+     * and check the result saves exactly like the patch load_xml gave us. The wavetables are
+     * loaded the same way after either, so they are left out of it.
+     */
+    void *loaded{nullptr}, *restored{nullptr};
+    auto loadedSize = patch.save_xml(&loaded);
+
+    patch.init_default_values();
+
+    SnapshotReader r{snapshot.data(), snapshot.data() + snapshot.size()};
+    streamPatch(r, patch, storage, key.preset);
+
+    auto restoredSize = patch.save_xml(&restored);
+    bool same = r.ok && loadedSize == restoredSize && !memcmp(loaded, restored, loadedSize);
+
+    free(loaded);
+    free(restored);
+
+    if (!same)
+    {
+        // keep loading this one from XML, and put back the state we just trampled
+        stats.uncacheable++;
+        patch.init_default_values();
+        patch.load_patch_xml(data, size, key.preset);
+        write(key, {}, sf_uncacheable);
+        return;
+    }
+
+    if (write(key, snapshot, 0))
+    {
+        stats.stored++;
+    }
+}
+
+bool PatchCache::write(const Key &key, const std::vector<char> &snapshot, uint32_t flags)
+{
+    SnapshotHeader h;
+    memcpy(h.magic, "SXPC", 4);
+    h.format = snapshotFormat;
+    h.layout = layout;
+    h.mtime = key.mtime;
+    h.size = key.size;
+    h.hash = key.hash;
+    h.prefs = key.prefs;
+    h.flags = flags;
+    h.pathSize = (uint32_t)key.path.size();
+    h.bodySize = snapshot.size();
+    h.bodyHash = hashBytes(snapshot.data(), snapshot.size());
+
+    // write beside the snapshot and move it in, so a reader never sees half a file
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+#if WINDOWS
+    auto pid = (uint64_t)GetCurrentProcessId();
+#else
+    auto pid = (uint64_t)getpid();
+#endif
+
+    // other processes, and other caches in this one, may be writing the same snapshot
+    auto dest = snapshotPath(key);
+    auto temp = dest;
+    temp += fmt::format(".{:x}.{:x}.tmp", pid, (uintptr_t)this);
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+
+        if (!out)
+        {
+            return false;
+        }
+
+        out.write((const char *)&h, sizeof(h));
+        out.write(key.path.data(), key.path.size());
+        out.write(snapshot.data(), snapshot.size());
+
+        if (!out)
+        {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, dest, ec);
+
+    if (ec)
+    {
+        fs::remove(temp, ec);
+        return false;
+    }
+
+    if (++storesSincePrune >= storesPerPrune)
+    {
+        prune();
+    }
+
+    return true;
+}
+
+void PatchCache::prune()
+{
+    storesSincePrune = 0;
+
+    struct Entry
+    {
+        fs::path path;
+        fs::file_time_type time;
+        uint64_t size;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total{0};
+    auto now = fs::file_time_type::clock::now();
+    std::error_code ec;
+
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator();
+         it.increment(ec))
+    {
+        auto p = it->path();
+        auto ext = p.extension();
+
+        if (ext != ".sxpc" && ext != ".tmp")
+        {
+            continue;
+        }
+
+        std::error_code tec, sec;
+        auto time = fs::last_write_time(p, tec);
+        auto size = fs::file_size(p, sec);
+
+        if (tec || sec)
+        {
+            continue;
+        }
+
+        // a temp file an hour old was left by a writer which never got to move it in
+        auto age = now - time;
+
+        if (age > maxAge || (ext == ".tmp" && age > std::chrono::hours(1)))
+        {
+            fs::remove(p, tec);
+            continue;
+        }
+
+        if (ext == ".sxpc")
+        {
+            entries.push_back({p, time, (uint64_t)size});
+            total += size;
+        }
+    }
+
+    if (total <= maxBytes)
+    {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const auto &a, const auto &b) { return a.time < b.time; });
+
+    for (auto &e : entries)
+    {
+        if (total <= maxBytes)
+        {
+            break;
+        }
+
+        if (fs::remove(e.path, ec))
+        {
+            total -= e.size;
+        }
+    }
+}
+} // namespace Storage
+} // namespace Surge
@@ -0,0 +1,112 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_PATCHCACHE_H
+#define SURGE_SRC_COMMON_PATCHCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * A directory of binary snapshots of patches as load_xml leaves them: parameter values and
+ * flags, modulation routings, step sequences, MSEGs, formulae, labels and the rest of the
+ * streamed state, with every streaming revision fix-up already applied. Each snapshot is
+ * keyed by the path it was read from and checked against that file's modification time,
+ * size and contents, so reloading a patch is a memory mapped read and some copies rather
+ * than an XML parse. XML stays the patch format; these files are only ever a cache and can be
+ * deleted at any time.
+ *
+ * A snapshot is only written once restoring it over a freshly reset patch has been shown to
+ * save the same XML as the real load did, so streamed state added to load_xml without being
+ * added here makes that patch uncacheable rather than wrong. One which fails gets a marker in
+ * place of its snapshot, so it isn't proven again until the file changes. Snapshots are in
+ * native byte order and are tied to the build which wrote them.
+ *
+ * The directory is pruned, oldest first, to maxBytes and maxAge when the cache is opened and
+ * every so many stores after that.
+ */
+struct PatchCache
+{
+    PatchCache(SurgeStorage *storage, const fs::path &dir);
+
+    /*
+     * Loads the fxp chunk data, which was read from source, into the patch just like
+     * load_patch(data, size, preset) would, after init_default_values.
+     */
+    void load(SurgePatch &patch, const fs::path &source, const void *data, int size,
+              bool preset);
+
+    const fs::path &getDirectory() const { return dir; }
+
+    struct Stats
+    {
+        // skipped are loads of patches already marked uncacheable
+        int restored{0}, stored{0}, uncacheable{0}, skipped{0};
+    } stats;
+
+    static constexpr uint64_t maxBytes = 64 * 1024 * 1024;
+    static constexpr std::chrono::hours maxAge{24 * 60};
+
+    void prune();
+
+  private:
+    struct Key
+    {
+        std::string path;
+        int64_t mtime{0};
+        uint64_t size{0}, hash{0};
+        uint32_t prefs{0};
+        bool preset{false};
+    };
+
+    bool makeKey(const fs::path &source, const void *data, int size, Key &key) const;
+    fs::path snapshotPath(const Key &key) const;
+
+    enum Restored
+    {
+        kRestored,
+        kMissing,
+        kUncacheable
+    };
+
+    Restored restore(SurgePatch &patch, const Key &key);
+    void store(SurgePatch &patch, const Key &key, const std::vector<char> &snapshot,
+               const void *data, int size);
+    bool write(const Key &key, const std::vector<char> &snapshot, uint32_t flags);
+
+    SurgeStorage *storage;
+    fs::path dir;
+    uint64_t layout{0};
+    int storesSincePrune{0};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_PATCHCACHE_H
@@ -26,10 +26,13 @@
 #include <iterator>
 #include <chrono>
 #include <functional>
+#include <algorithm>
+#include <atomic>
 
 #include "sqlite3.h"
 #include "SurgeStorage.h"
 #include "DebugHelpers.h"
+#include "RenderWorkerPool.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 #include "PatchFileHeaderStructs.h"
@@ -240,7 +243,7 @@ struct TxnGuard
 
 struct PatchDB::WriterWorker
 {
-    static constexpr const char *schema_version = "14"; // I will rebuild if this is not my version
+    static constexpr const char *schema_version = "15"; // I will rebuild if this is not my version
 
     static constexpr const char *setup_sql = R"SQL(
 DROP TABLE IF EXISTS "Patches";
@@ -269,6 +272,8 @@ CREATE TABLE PatchFeature (
       feature_ivalue int,
       feature_svalue varchar(64)
 );
+CREATE INDEX patches_path ON Patches (path);
+CREATE INDEX patchfeature_patch_id ON PatchFeature (patch_id);
 CREATE TABLE Category (
       id integer primary key,
       name varchar(2048),
@@ -290,6 +295,15 @@ CREATE TABLE IF NOT EXISTS Favorites (
     path varchar(2048)
 );
 )SQL";
+    // FIXME features should be an enum or something
+
+    enum FeatureType
+    {
+        INT,
+        STRING
+    };
+    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
+
     struct EnQAble
     {
         virtual ~EnQAble() = default;
@@ -307,7 +321,19 @@ CREATE TABLE IF NOT EXISTS Favorites (
         std::string catname;
         CatType type;
 
-        void go(WriterWorker &w) override { w.parseFXPIntoDB(*this); }
+        // What parseFXP read from the file, which can happen on any thread ahead of the write
+        bool parsed{false}, exists{false}, valid{false};
+        std::string pathString;
+        int64_t lastWriteTime{0};
+        std::vector<feature> features;
+        std::string searchOver;
+
+        void go(WriterWorker &w) override
+        {
+            if (!parsed)
+                w.parseFXP(*this);
+            w.writeFXPIntoDB(*this);
+        }
     };
 
     struct EnQDebugMsg : public EnQAble
@@ -402,11 +428,49 @@ CREATE TABLE IF NOT EXISTS Favorites (
 #if TRACE_DB
         std::cout << "<<<< Closing r/w DB" << std::endl;
 #endif
+        finalizeCachedStatements();
         if (dbh)
             sqlite3_close(dbh);
         dbh = nullptr;
     }
 
+    /*
+     * The statements used for every patch are prepared once per open of the write connection
+     * and reused, rather than prepared and finalized for each patch. closeDb finalizes them.
+     */
+    std::unordered_map<std::string, std::unique_ptr<SQL::Statement>> cachedStatements;
+    SQL::Statement &cachedStatement(const std::string &sql)
+    {
+        auto &st = cachedStatements[sql];
+        if (!st)
+        {
+            st = std::make_unique<SQL::Statement>(dbh, sql);
+        }
+        else
+        {
+            // this also clears out a statement left mid step by an earlier exception
+            sqlite3_reset(st->s);
+            sqlite3_clear_bindings(st->s);
+        }
+        return *st;
+    }
+
+    void finalizeCachedStatements()
+    {
+        for (auto &[sql, st] : cachedStatements)
+        {
+            try
+            {
+                st->finalize();
+            }
+            catch (const SQL::Exception &e)
+            {
+                storage->reportError(e.what(), "PatchDB - Finalize");
+            }
+        }
+        cachedStatements.clear();
+    }
+
     std::string dbname;
     fs::path dbpath;
 
@@ -522,9 +586,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
             qCV.notify_all();
             qThread.join();
             // clean up all the prepared statements
-            if (dbh)
-                sqlite3_close(dbh);
-            dbh = nullptr;
+            closeDb();
         }
 
         if (rodbh)
@@ -534,14 +596,6 @@ CREATE TABLE IF NOT EXISTS Favorites (
         }
     }
 
-    // FIXME features should be an enum or something
-
-    enum FeatureType
-    {
-        INT,
-        STRING
-    };
-    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
     std::vector<feature> extractFeaturesFromXML(const char *xml)
     {
         std::vector<feature> res;
@@ -648,7 +702,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
     std::atomic<bool> waiting{false};
     void loadQueueFunction()
     {
-        static constexpr auto transChunkSize = 10; // How many FXP to load in a single txn
+        static constexpr auto transChunkSize = 256; // How many FXP to load in a single txn
         int lock_retries{0};
         while (keepRunning)
         {
@@ -673,10 +727,14 @@ CREATE TABLE IF NOT EXISTS Favorites (
                                         : pathQ.begin() + transChunkSize;
                     std::copy(b, e, std::back_inserter(doThis));
                     pathQ.erase(b, e);
+                    inFlight = doThis.size();
                 }
             }
             if (!doThis.empty())
             {
+                // read and parse the patches before taking the write lock
+                parseFXPs(doThis);
+
                 if (!dbh)
                     openDb();
                 if (dbh == nullptr)
@@ -733,115 +791,96 @@ CREATE TABLE IF NOT EXISTS Favorites (
                         storage->reportError(e.what(), "Patch DB");
                     }
                 }
+
+                inFlight = 0;
             }
         }
     }
 
-    void parseFXPIntoDB(const EnQPatch &p)
+    /*
+     * Reads and parses every patch in items which hasn't been yet, spread over the shared
+     * background pool when we can have it. None of this touches the database.
+     */
+    struct ParseJob
+    {
+        WriterWorker *worker;
+        std::vector<EnQPatch *> &todo;
+        std::atomic<size_t> next{0};
+    };
+
+    static void parseFXPsJob(void *ctx, int)
     {
-        sqlite3_stmt *insertStmt = nullptr, *insfeatureStmt = nullptr, *dropIdStmt = nullptr;
+        auto job = static_cast<ParseJob *>(ctx);
+        size_t i;
 
-        if (!fs::exists(p.path))
+        while ((i = job->next++) < job->todo.size())
         {
-#if TRACE_DB
-            std::cout << "    - Warning: Non existent " << path_to_string(p.path) << std::endl;
-#endif
-            return;
+            job->worker->parseFXP(*job->todo[i]);
         }
-        // Check with
-        auto qtime = fs::last_write_time(p.path);
-        int64_t qtimeInt =
-            std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
+    }
 
-        bool patchLoaded = false;
-        std::vector<int> dropIds;
-        try
+    void parseFXPs(const std::vector<EnQAble *> &items)
+    {
+        std::vector<EnQPatch *> todo;
+        for (auto *q : items)
         {
-            auto exists = SQL::Statement(
-                dbh, "SELECT id, last_write_time from Patches WHERE Patches.Path LIKE ?1");
-            const auto path(p.path.u8string());
-            exists.bind(1, path);
+            auto *p = dynamic_cast<EnQPatch *>(q);
+            if (p && !p->parsed)
+                todo.push_back(p);
+        }
 
-            // Drop all the ones with this path independent of time if I'm adding
-            while (exists.step())
-            {
-                auto id = exists.col_int(0);
-                auto t = exists.col_int64(1);
-                dropIds.push_back(id);
-            }
+        if (todo.empty())
+            return;
 
-            exists.finalize();
+        ParseJob job{this, todo};
+        Surge::Threading::RenderWorkerPool::Lease pool;
 
-            if (!dropIds.empty())
-            {
-                auto drop = SQL::Statement(dbh, "DELETE FROM Patches WHERE ID=?1;");
-                for (auto did : dropIds)
-                {
-                    drop.bind(1, did);
-                    while (drop.step())
-                    {
-                    }
-                    drop.clearBindings();
-                    drop.reset();
-                }
-
-                drop.finalize();
+        if (todo.size() > 1)
+        {
+            pool = Surge::Threading::RenderWorkerPool::leaseBackgroundPool();
+        }
 
-                auto dropF = SQL::Statement(dbh, "DELETE FROM PatchFeature WHERE PATCH_ID=?1;");
-                for (auto did : dropIds)
-                {
-                    dropF.bind(1, did);
-                    while (dropF.step())
-                    {
-                    }
-                    dropF.clearBindings();
-                    dropF.reset();
-                }
+        int helpers = pool ? std::min(pool->size(), (int)todo.size() - 1) : 0;
 
-                dropF.finalize();
-            }
-        }
-        catch (const SQL::Exception &e)
+        for (int w = 0; w < helpers; ++w)
         {
-            if (storage)
-            {
-                storage->reportError(e.what(), "PatchDB - Load Check");
-            }
-            return;
+            pool->post(w, parseFXPsJob, &job, 0);
         }
 
-        if (patchLoaded)
-            return;
+        parseFXPsJob(&job, 0);
 
-        int64_t patchid = -1;
-        try
+        for (int w = 0; w < helpers; ++w)
         {
-            auto ins = SQL::Statement(dbh, "INSERT INTO PATCHES ( \"path\", \"name\", "
-                                           "\"category\", \"category_type\", \"last_write_time\" ) "
-                                           "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
-            const auto path(p.path.u8string());
-            ins.bind(1, path);
-            ins.bind(2, p.name);
-            ins.bind(3, p.catname);
-            ins.bind(4, (int)p.type);
-            ins.bindi64(5, qtimeInt);
-
-            ins.step();
+            pool->join(w);
+        }
+    }
 
-            // No real need to encapsulate this
-            patchid = sqlite3_last_insert_rowid(dbh);
+    void parseFXP(EnQPatch &p)
+    {
+        p.parsed = true;
 
-            ins.finalize();
-        }
-        catch (const SQL::Exception &e)
+        try
         {
-            if (storage)
+            if (!fs::exists(p.path))
             {
-                storage->reportError(e.what(), "PatchDB - Insert Patch");
+#if TRACE_DB
+                std::cout << "    - Warning: Non existent " << path_to_string(p.path) << std::endl;
+#endif
+                return;
             }
+
+            auto qtime = fs::last_write_time(p.path);
+            p.lastWriteTime =
+                std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
+        }
+        catch (const fs::filesystem_error &)
+        {
             return;
         }
 
+        p.exists = true;
+        p.pathString = p.path.u8string();
+
         std::ostringstream searchName;
         searchName << p.name << " ";
 
@@ -910,16 +949,100 @@ CREATE TABLE IF NOT EXISTS Favorites (
         stream.read(xmlData.data(), xmlData.size());
         if (!stream)
             return;
+
+        p.features = extractFeaturesFromXML(xmlData.data());
+        for (const auto &f : p.features)
+        {
+            if (std::get<0>(f) == "TAG")
+            {
+                searchName << " " << std::get<3>(f);
+            }
+        }
+
+        p.searchOver = searchName.str();
+        p.valid = true;
+    }
+
+    void writeFXPIntoDB(const EnQPatch &p)
+    {
+        if (!p.exists)
+            return;
+
         try
         {
-            auto ins =
-                SQL::Statement(dbh, "INSERT INTO PATCHFEATURE ( \"patch_id\", \"feature\", "
-                                    "\"feature_type\", \"feature_ivalue\", \"feature_svalue\" ) "
-                                    "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
-            auto feat = extractFeaturesFromXML(xmlData.data());
-            for (const auto &f : feat)
+            auto &exists = cachedStatement("SELECT id FROM Patches WHERE Patches.path = ?1");
+            exists.bind(1, p.pathString);
+
+            // Drop all the ones with this path independent of time if I'm adding
+            std::vector<int> dropIds;
+            while (exists.step())
+            {
+                dropIds.push_back(exists.col_int(0));
+            }
+
+            if (!dropIds.empty())
+            {
+                auto &drop = cachedStatement("DELETE FROM Patches WHERE id = ?1");
+                auto &dropF = cachedStatement("DELETE FROM PatchFeature WHERE patch_id = ?1");
+                for (auto did : dropIds)
+                {
+                    drop.bind(1, did);
+                    drop.step();
+                    drop.reset();
+
+                    dropF.bind(1, did);
+                    dropF.step();
+                    dropF.reset();
+                }
+            }
+        }
+        catch (const SQL::Exception &e)
+        {
+            if (storage)
+            {
+                storage->reportError(e.what(), "PatchDB - Load Check");
+            }
+            return;
+        }
+
+        int64_t patchid = -1;
+        try
+        {
+            auto &ins = cachedStatement("INSERT INTO PATCHES ( \"path\", \"name\", "
+                                        "\"category\", \"category_type\", \"last_write_time\" ) "
+                                        "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
+            ins.bind(1, p.pathString);
+            ins.bind(2, p.name);
+            ins.bind(3, p.catname);
+            ins.bind(4, (int)p.type);
+            ins.bindi64(5, p.lastWriteTime);
+
+            ins.step();
+
+            // No real need to encapsulate this
+            patchid = sqlite3_last_insert_rowid(dbh);
+        }
+        catch (const SQL::Exception &e)
+        {
+            if (storage)
+            {
+                storage->reportError(e.what(), "PatchDB - Insert Patch");
+            }
+            return;
+        }
+
+        // a file we couldn't read still gets its row, just with nothing to search on
+        if (!p.valid)
+            return;
+
+        try
+        {
+            auto &ins =
+                cachedStatement("INSERT INTO PATCHFEATURE ( \"patch_id\", \"feature\", "
+                                "\"feature_type\", \"feature_ivalue\", \"feature_svalue\" ) "
+                                "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
+            for (const auto &f : p.features)
             {
-                const auto &ftype = std::get<0>(f);
                 ins.bindi64(1, patchid);
                 ins.bind(2, std::get<0>(f));
                 ins.bind(3, (int)std::get<1>(f));
@@ -930,13 +1053,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
 
                 ins.clearBindings();
                 ins.reset();
-                if (ftype == "TAG")
-                {
-                    searchName << " " << std::get<3>(f);
-                }
             }
-
-            ins.finalize();
         }
         catch (const SQL::Exception &e)
         {
@@ -947,15 +1064,13 @@ CREATE TABLE IF NOT EXISTS Favorites (
             return;
         }
 
-        auto sns = searchName.str();
         try
         {
-            auto ins = SQL::Statement(dbh, "UPDATE PATCHES SET search_over=?1 WHERE id=?2");
-            ins.bind(1, sns);
-            ins.bind(2, patchid);
+            auto &ins = cachedStatement("UPDATE PATCHES SET search_over=?1 WHERE id=?2");
+            ins.bind(1, p.searchOver);
+            ins.bindi64(2, patchid);
 
             ins.step();
-            ins.finalize();
         }
         catch (const SQL::Exception &e)
         {
@@ -1121,6 +1236,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
     std::mutex qLock;
     std::condition_variable qCV;
     std::deque<EnQAble *> pathQ;
+    std::atomic<int> inFlight{0}; // taken off pathQ but not yet written
     std::atomic<bool> keepRunning{true};
 
     /*
@@ -1465,7 +1581,7 @@ PatchDB::readAllPatchPathsWithIdAndModTime()
 int PatchDB::numberOfJobsOutstanding()
 {
     std::lock_guard<std::mutex> guard(worker->qLock);
-    return worker->pathQ.size();
+    return worker->pathQ.size() + worker->inFlight;
 }
 
 int PatchDB::waitForJobsOutstandingComplete(int maxWaitInMS)
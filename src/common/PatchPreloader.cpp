@@ -0,0 +1,225 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "PatchPreloader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "PatchFileHeaderStructs.h"
+#include "sst/basic-blocks/mechanics/endian-ops.h"
+
+namespace Surge
+{
+namespace Storage
+{
+PatchPreloader::PatchPreloader(SurgeStorage *s) : storage(s)
+{
+    thread = std::thread([this]() { run(); });
+}
+
+PatchPreloader::~PatchPreloader()
+{
+    {
+        std::lock_guard<std::mutex> g(m);
+        quitting = true;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void PatchPreloader::preload(const std::vector<int> &ids)
+{
+    // resolve the paths here, since the patch list belongs to the caller's side
+    std::vector<std::pair<int, fs::path>> w;
+
+    for (auto id : ids)
+    {
+        if (id >= 0 && id < storage->patch_list.size())
+        {
+            w.emplace_back(id, storage->patch_list[id].path);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> g(m);
+        wanted = std::move(w);
+        changed = true;
+    }
+    cv.notify_one();
+}
+
+bool PatchPreloader::isReady(int id, const fs::path &path)
+{
+    return withEntry(id, path, [](const Entry &) {});
+}
+
+std::unique_ptr<PatchPreloader::Entry> PatchPreloader::read(int id, const fs::path &path)
+{
+    using namespace sst::io;
+
+    std::filebuf f;
+
+    if (!f.open(path, std::ios::binary | std::ios::in))
+    {
+        return nullptr;
+    }
+
+    fxChunkSetCustom fxp;
+
+    if (f.sgetn(reinterpret_cast<char *>(&fxp), sizeof(fxp)) != sizeof(fxp) ||
+        mech::endian_read_int32BE(fxp.chunkMagic) != 'CcnK' ||
+        mech::endian_read_int32BE(fxp.fxMagic) != 'FPCh' ||
+        mech::endian_read_int32BE(fxp.fxID) != 'cjs3')
+    {
+        return nullptr;
+    }
+
+    auto e = std::make_unique<Entry>();
+    e->id = id;
+    e->path = path;
+    e->chunkSize = mech::endian_read_int32BE(fxp.chunkSize);
+
+    if (e->chunkSize <= 0)
+    {
+        return nullptr;
+    }
+
+    e->chunk.reset(new char[e->chunkSize]);
+
+    if (f.sgetn(e->chunk.get(), e->chunkSize) != e->chunkSize)
+    {
+        return nullptr;
+    }
+
+    // the same walk as SurgePatch::load_patch_wavetables, building into tables of our own
+    if (e->chunkSize <= (int)sizeof(patch_header) || memcmp(e->chunk.get(), "sub3", 4))
+    {
+        return e;
+    }
+
+    auto ph = (const patch_header *)e->chunk.get();
+    auto end = e->chunk.get() + e->chunkSize;
+    auto dr = e->chunk.get() + sizeof(patch_header) + mech::endian_read_int32LE(ph->xmlsize);
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int osc = 0; osc < n_oscs; osc++)
+        {
+            auto wtsize = mech::endian_read_int32LE(ph->wtsize[sc][osc]);
+
+            if (!wtsize)
+            {
+                continue;
+            }
+
+            if (wtsize < sizeof(wt_header) || dr + wtsize > end)
+            {
+                return e;
+            }
+
+            auto wth = (wt_header *)dr;
+            auto wt = std::make_unique<Wavetable>();
+
+            if (wt->BuildWT(dr + sizeof(wt_header), *wth, false))
+            {
+                e->wavetables.push_back(std::move(wt));
+            }
+
+            dr += wtsize;
+        }
+    }
+
+    return e;
+}
+
+void PatchPreloader::run()
+{
+    while (true)
+    {
+        std::vector<std::pair<int, fs::path>> todo;
+        std::vector<std::unique_ptr<Entry>> dropped;
+
+        {
+            std::unique_lock<std::mutex> l(m);
+            cv.wait(l, [this]() { return changed || quitting; });
+
+            if (quitting)
+            {
+                return;
+            }
+
+            changed = false;
+
+            auto isWanted = [this](const Entry &e) {
+                return std::find(wanted.begin(), wanted.end(), std::make_pair(e.id, e.path)) !=
+                       wanted.end();
+            };
+
+            for (auto &e : ready)
+            {
+                if (!isWanted(*e))
+                {
+                    dropped.push_back(std::move(e));
+                }
+            }
+
+            ready.erase(std::remove(ready.begin(), ready.end(), nullptr), ready.end());
+
+            for (auto &w : wanted)
+            {
+                if (std::none_of(ready.begin(), ready.end(), [&w](const auto &e) {
+                        return e->id == w.first && e->path == w.second;
+                    }))
+                {
+                    todo.push_back(w);
+                }
+            }
+        }
+
+        // everything we let go of is freed here, not on whichever thread asked for the change
+        dropped.clear();
+
+        for (auto &w : todo)
+        {
+            if (changed || quitting)
+            {
+                break;
+            }
+
+            auto e = read(w.first, w.second);
+
+            if (e)
+            {
+                std::lock_guard<std::mutex> g(m);
+
+                if (std::find(wanted.begin(), wanted.end(), w) != wanted.end())
+                {
+                    ready.push_back(std::move(e));
+                }
+            }
+        }
+    }
+}
+} // namespace Storage
+} // namespace Surge
@@ -0,0 +1,112 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_PATCHPRELOADER_H
+#define SURGE_SRC_COMMON_PATCHPRELOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * A prefetch cache for a set of patches from the patch list (the neighbours of the current
+ * one, say, or a setlist). A background thread reads each one's fxp chunk into memory and
+ * builds the wavetables embedded in it; holding those built tables keeps their data in the
+ * shared wavetable cache, so when the patch is loaded its BuildWT calls find the data rather
+ * than mip-mapping it again. The load itself is unchanged: SurgeSynthesizer still fades out,
+ * halts the engine and copies the patch in on its loader thread, it just skips the disk and
+ * the wavetable builds. Only the loading side uses this, never the audio thread.
+ */
+struct PatchPreloader
+{
+    explicit PatchPreloader(SurgeStorage *storage);
+    ~PatchPreloader();
+
+    // Replaces the preloaded set with these patch_list ids. Any thread.
+    void preload(const std::vector<int> &ids);
+
+    struct Entry
+    {
+        int id{-1};
+        fs::path path;
+        std::unique_ptr<char[]> chunk;
+        int chunkSize{0};
+        std::vector<std::unique_ptr<Wavetable>> wavetables;
+    };
+
+    // Never blocks, so it says no if the background thread holds the set right now
+    bool isReady(int id, const fs::path &path);
+
+    /*
+     * Calls f(entry) for the patch_list id and path if it is ready, holding the set so it
+     * can't change under f, and says whether it did. Never blocks. An entry read before the
+     * patch list was rescanned may be for another file under the same id, so the caller passes
+     * the path it got from the list along with the id.
+     */
+    template <typename F> bool withEntry(int id, const fs::path &path, F &&f)
+    {
+        std::unique_lock<std::mutex> l(m, std::try_to_lock);
+
+        if (!l.owns_lock())
+        {
+            return false;
+        }
+
+        for (auto &e : ready)
+        {
+            if (e->id == id && e->path == path)
+            {
+                f(*e);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+  private:
+    std::unique_ptr<Entry> read(int id, const fs::path &path);
+    void run();
+
+    SurgeStorage *storage;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::vector<std::pair<int, fs::path>> wanted;
+    std::vector<std::unique_ptr<Entry>> ready;
+    std::atomic<bool> changed{false}, quitting{false};
+    std::thread thread;
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_PATCHPRELOADER_H
@@ -0,0 +1,190 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "RenderWorkerPool.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define SURGE_RWP_X86 1
+#endif
+
+namespace Surge
+{
+namespace Threading
+{
+static uint64_t getFloatingPointMode()
+{
+#if SURGE_RWP_X86
+    return _mm_getcsr();
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    return fpcr;
+#else
+    return 0;
+#endif
+}
+
+static void setFloatingPointMode(uint64_t mode)
+{
+#if SURGE_RWP_X86
+    _mm_setcsr((unsigned int)mode);
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+    asm volatile("msr fpcr, %0" : : "r"(mode));
+#else
+    (void)mode;
+#endif
+}
+
+// backgroundPoolMutex guards backgroundPoolRef; backgroundPoolUseMutex is what a Lease holds
+static std::mutex backgroundPoolMutex, backgroundPoolUseMutex;
+static std::weak_ptr<RenderWorkerPool> backgroundPoolRef;
+
+RenderWorkerPool::RenderWorkerPool(int nWorkers)
+{
+    for (int i = 0; i < nWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (auto &w : workers)
+    {
+        auto wp = w.get();
+        w->thread = std::thread([this, wp]() { run(*wp); });
+    }
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    quitting = true;
+
+    for (auto &w : workers)
+    {
+        {
+            std::lock_guard<std::mutex> g(w->m);
+        }
+        w->cv.notify_one();
+        w->thread.join();
+    }
+}
+
+void RenderWorkerPool::post(int worker, job_t job, void *ctx, int arg)
+{
+    auto &w = *workers[worker];
+
+    w.job = job;
+    w.ctx = ctx;
+    w.arg = arg;
+    w.fpMode = getFloatingPointMode();
+    w.state.store(kPosted, std::memory_order_release);
+
+    /*
+     * The worker only holds the lock while it checks the state and goes to sleep, so passing
+     * through it is brief, and means the worker either saw kPosted or is already waiting for
+     * this wakeup.
+     */
+    {
+        std::lock_guard<std::mutex> g(w.m);
+    }
+    w.cv.notify_one();
+}
+
+void RenderWorkerPool::join(int worker)
+{
+    auto &w = *workers[worker];
+
+    int expected = kPosted;
+    if (w.state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+    {
+        w.job(w.ctx, w.arg);
+    }
+    else
+    {
+        while (w.state.load(std::memory_order_acquire) != kDone)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    w.state.store(kIdle, std::memory_order_relaxed);
+}
+
+void RenderWorkerPool::run(Worker &w)
+{
+    while (!quitting)
+    {
+        int expected = kPosted;
+        if (w.state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+        {
+            setFloatingPointMode(w.fpMode);
+            w.job(w.ctx, w.arg);
+            w.state.store(kDone, std::memory_order_release);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> l(w.m);
+        w.cv.wait(l, [&w, this]() { return quitting || w.state == kPosted; });
+    }
+}
+
+std::shared_ptr<RenderWorkerPool> RenderWorkerPool::backgroundPool()
+{
+    std::lock_guard<std::mutex> g(backgroundPoolMutex);
+
+    auto pool = backgroundPoolRef.lock();
+
+    if (!pool)
+    {
+        int hw = (int)std::thread::hardware_concurrency();
+        pool = std::make_shared<RenderWorkerPool>(std::clamp(hw - 1, 0, 7));
+        backgroundPoolRef = pool;
+    }
+
+    return pool;
+}
+
+RenderWorkerPool::Lease RenderWorkerPool::leaseBackgroundPool()
+{
+    Lease l;
+    l.lock = std::unique_lock<std::mutex>(backgroundPoolUseMutex, std::try_to_lock);
+
+    if (!l.lock.owns_lock())
+    {
+        return l;
+    }
+
+    {
+        std::lock_guard<std::mutex> g(backgroundPoolMutex);
+        l.pool = backgroundPoolRef.lock();
+    }
+
+    if (l.pool && l.pool->size() == 0)
+    {
+        l.pool.reset();
+    }
+
+    return l;
+}
+} // namespace Threading
+} // namespace Surge
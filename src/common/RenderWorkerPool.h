@@ -0,0 +1,112 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_RENDERWORKERPOOL_H
+#define SURGE_SRC_COMMON_RENDERWORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * A tiny pool of helper threads for the audio thread to hand a job per worker to within a
+ * block. post() only passes through a worker's lock to wake it, which the worker never holds
+ * for longer than it takes to go to sleep, and join() runs the job on the calling thread if
+ * the worker hasn't picked it up yet, so a worker which is asleep or descheduled costs at
+ * worst what rendering serially would have cost. Idle workers sleep until posted to.
+ *
+ * Jobs are a plain function pointer and context so posting doesn't allocate. They run with
+ * the posting thread's floating point mode (flush to zero and friends), so a job gives the
+ * same result whichever thread ends up running it.
+ */
+struct RenderWorkerPool
+{
+    typedef void (*job_t)(void *ctx, int arg);
+
+    explicit RenderWorkerPool(int nWorkers);
+    ~RenderWorkerPool();
+
+    int size() const { return (int)workers.size(); }
+
+    // One thread only, usually the audio thread. Each worker holds at most one job, which must
+    // be joined before the next post to it.
+    void post(int worker, job_t job, void *ctx, int arg);
+    void join(int worker);
+
+    /*
+     * A pool for the building done off the audio thread, such as mip-mapping a large wavetable
+     * or parsing patches for the database, so that doesn't start and stop threads each time.
+     * Every SurgeStorage holds it through backgroundPool(), so it lasts while any of them do.
+     * Only one thread uses it at a time: a Lease taken while it's busy, or while there is none,
+     * is empty, and the work just runs on the calling thread.
+     */
+    static std::shared_ptr<RenderWorkerPool> backgroundPool();
+
+    struct Lease
+    {
+        std::shared_ptr<RenderWorkerPool> pool;
+        std::unique_lock<std::mutex> lock;
+
+        explicit operator bool() const { return pool != nullptr; }
+        RenderWorkerPool *operator->() const { return pool.get(); }
+    };
+    static Lease leaseBackgroundPool();
+
+  private:
+    enum State
+    {
+        kIdle,
+        kPosted,
+        kRunning,
+        kDone
+    };
+
+    struct Worker
+    {
+        std::atomic<int> state{kIdle};
+        job_t job{nullptr};
+        void *ctx{nullptr};
+        int arg{0};
+        uint64_t fpMode{0};
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    void run(Worker &w);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> quitting{false};
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_RENDERWORKERPOOL_H
@@ -34,6 +34,8 @@
 #include "version.h"
 #include "fmt/core.h"
 #include <locale>
+#include <string_view>
+#include <unordered_map>
 #include <fmt/format.h>
 #include "UnitConversions.h"
 
@@ -839,7 +841,7 @@ void SurgePatch::init_default_values()
         for (auto &osc : scene[sc].osc)
         {
             osc.type.val.i = 0;
-            osc.queue_xmldata = 0;
+            osc.queue_snapshot_pending.store(false, std::memory_order_release);
             osc.queue_type = -1;
             osc.keytrack.val.b = true;
             osc.retrigger.val.b = false;
@@ -1111,6 +1113,12 @@ void SurgePatch::update_controls(
 }
 
 void SurgePatch::load_patch(const void *data, int datasize, bool preset)
+{
+    load_patch_xml(data, datasize, preset);
+    load_patch_wavetables(data, datasize);
+}
+
+void SurgePatch::load_patch_xml(const void *data, int datasize, bool preset)
 {
     using namespace sst::io;
 
@@ -1118,78 +1126,92 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
         return;
     assert(datasize);
     assert(data);
-    void *end = (char *)data + datasize;
-    patch_header *ph = (patch_header *)data;
-    ph->xmlsize = mech::endian_read_int32LE(ph->xmlsize);
+    auto ph = (const patch_header *)data;
 
     if (!memcmp(ph->tag, "sub3", 4))
     {
-        char *dr = (char *)data + sizeof(patch_header);
-        load_xml(dr, ph->xmlsize, preset);
-        dr += ph->xmlsize;
+        load_xml((const char *)data + sizeof(patch_header),
+                 mech::endian_read_int32LE(ph->xmlsize), preset);
+    }
+    else
+    {
+        load_xml(data, datasize, preset);
+    }
+}
 
-        for (int sc = 0; sc < n_scenes; sc++)
+void SurgePatch::load_patch_wavetables(const void *data, int datasize)
+{
+    using namespace sst::io;
+
+    if (datasize <= 4)
+        return;
+    assert(datasize);
+    assert(data);
+    const void *end = (const char *)data + datasize;
+    auto ph = (const patch_header *)data;
+
+    if (memcmp(ph->tag, "sub3", 4))
+        return;
+
+    auto dr = (const char *)data + sizeof(patch_header) + mech::endian_read_int32LE(ph->xmlsize);
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int osc = 0; osc < n_oscs; osc++)
         {
-            for (int osc = 0; osc < n_oscs; osc++)
+            auto wtsize = mech::endian_read_int32LE(ph->wtsize[sc][osc]);
+
+            if (wtsize)
             {
-                ph->wtsize[sc][osc] = mech::endian_read_int32LE(ph->wtsize[sc][osc]);
-                if (ph->wtsize[sc][osc])
-                {
-                    wt_header *wth = (wt_header *)dr;
-                    if (wth > end)
-                        return;
+                wt_header *wth = (wt_header *)dr;
+                if (wth > end)
+                    return;
 
-                    scene[sc].osc[osc].wt.queue_id = -1;
-                    scene[sc].osc[osc].wt.current_id = -1;
-                    scene[sc].osc[osc].wt.queue_filename = "";
-                    scene[sc].osc[osc].wt.current_filename = "";
+                scene[sc].osc[osc].wt.queue_id = -1;
+                scene[sc].osc[osc].wt.current_id = -1;
+                scene[sc].osc[osc].wt.queue_filename = "";
+                scene[sc].osc[osc].wt.current_filename = "";
 
-                    void *d = (void *)((char *)dr + sizeof(wt_header));
+                void *d = (void *)((char *)dr + sizeof(wt_header));
 
-                    storage->waveTableDataMutex.lock();
-                    scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
+                storage->waveTableDataMutex.lock();
+                scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
 
-                    bool hadName{true};
+                bool hadName{true};
 
-                    if (scene[sc].osc[osc].wavetable_display_name.empty())
-                    {
-                        hadName = false;
+                if (scene[sc].osc[osc].wavetable_display_name.empty())
+                {
+                    hadName = false;
 
-                        if (scene[sc].osc[osc].wt.flags & wtf_is_sample)
-                        {
-                            scene[sc].osc[osc].wavetable_display_name = "(Patch Sample)";
-                        }
-                        else
-                        {
-                            scene[sc].osc[osc].wavetable_display_name = "(Patch Wavetable)";
-                        }
+                    if (scene[sc].osc[osc].wt.flags & wtf_is_sample)
+                    {
+                        scene[sc].osc[osc].wavetable_display_name = "(Patch Sample)";
+                    }
+                    else
+                    {
+                        scene[sc].osc[osc].wavetable_display_name = "(Patch Wavetable)";
                     }
+                }
 
-                    storage->waveTableDataMutex.unlock();
+                storage->waveTableDataMutex.unlock();
 
-                    if (hadName && scene[sc].osc[osc].wt.current_id < 0)
+                if (hadName && scene[sc].osc[osc].wt.current_id < 0)
+                {
+                    for (int i = 0;
+                         i < storage->wt_list.size() && scene[sc].osc[osc].wt.current_id < 0;
+                         ++i)
                     {
-                        for (int i = 0;
-                             i < storage->wt_list.size() && scene[sc].osc[osc].wt.current_id < 0;
-                             ++i)
+                        if (scene[sc].osc[osc].wavetable_display_name == storage->wt_list[i].name)
                         {
-                            if (scene[sc].osc[osc].wavetable_display_name ==
-                                storage->wt_list[i].name)
-                            {
-                                scene[sc].osc[osc].wt.current_id = i;
-                            }
+                            scene[sc].osc[osc].wt.current_id = i;
                         }
                     }
-
-                    dr += ph->wtsize[sc][osc];
                 }
+
+                dr += wtsize;
             }
         }
     }
-    else
-    {
-        load_xml(data, datasize, preset);
-    }
 }
 
 unsigned int SurgePatch::save_patch(void **data)
@@ -1449,26 +1471,32 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
         }
     }
 
-    TiXmlElement *p;
+    /*
+     * Saved patches have their parameters in param_ptr order, so usually the one we want is
+     * just the next element. When it isn't (older patches, or ones with params missing) look it
+     * up by name in an index of the first element of each name, built in one pass, rather than
+     * scanning the siblings for every param.
+     */
+    std::unordered_map<std::string_view, TiXmlElement *> paramElements;
+    paramElements.reserve(n);
+
+    for (auto c = parameters->FirstChildElement(); c; c = c->NextSiblingElement())
+    {
+        paramElements.emplace(c->Value(), c);
+    }
+
+    TiXmlElement *p = nullptr;
 
     for (int i = 0; i < n; i++)
     {
-        if (!i)
-        {
-            p = TINYXML_SAFE_TO_ELEMENT(parameters->FirstChild(param_ptr[i]->get_storage_name()));
-        }
-        else
-        {
-            if (p)
-            {
-                p = TINYXML_SAFE_TO_ELEMENT(p->NextSibling(param_ptr[i]->get_storage_name()));
-            }
+        auto sname = param_ptr[i]->get_storage_name();
 
-            if (!p)
-            {
-                p = TINYXML_SAFE_TO_ELEMENT(
-                    parameters->FirstChild(param_ptr[i]->get_storage_name()));
-            }
+        p = p ? p->NextSiblingElement() : nullptr;
+
+        if (!p || strcmp(p->Value(), sname) != 0)
+        {
+            auto pe = paramElements.find(sname);
+            p = pe == paramElements.end() ? nullptr : pe->second;
         }
 
         if (p)
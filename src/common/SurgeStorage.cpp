@@ -23,6 +23,7 @@
 #include "DSPUtils.h"
 #include "SurgeStorage.h"
 #include <set>
+#include <algorithm>
 #include <numeric>
 #include <cctype>
 #include <map>
@@ -49,6 +50,9 @@
 #endif
 #include "FxPresetAndClipboardManager.h"
 #include "ModulatorPresetManager.h"
+#include "PatchCache.h"
+#include "WavetableLoader.h"
+#include "RenderWorkerPool.h"
 #include "SurgeMemoryPools.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 
@@ -64,8 +68,45 @@ using namespace std;
 
 std::string SurgeStorage::skipPatchLoadDataPathSentinel = "<SKIP-PATCH-SENTINEL>";
 
-SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : otherscene_clients(0)
+#if STORAGE_USES_INDEPENDENT_RNG
+thread_local SurgeStorage::RNGGen *SurgeStorage::activeRngGen{nullptr};
+#endif
+thread_local int SurgeStorage::modRoutingPublishDeferrals{0};
+
+SurgeStorage::SharedTables::SharedTables()
+{
+    namespace tabl = sst::basic_blocks::tables;
+    sincTableProvider = std::make_unique<tabl::SurgeSincTableProvider>();
+    static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
+    static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
+    static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
+}
+
+SurgeStorage::SharedTables::~SharedTables() = default;
+
+std::shared_ptr<SurgeStorage::SharedTables> SurgeStorage::SharedTables::getShared()
+{
+    // Only a weak reference is kept here, so the tables go away with the last storage
+    static std::mutex sharedMutex;
+    static std::weak_ptr<SharedTables> shared;
+
+    std::lock_guard<std::mutex> g(sharedMutex);
+    auto res = shared.lock();
+    if (!res)
+    {
+        res = std::make_shared<SharedTables>();
+        shared = res;
+    }
+    return res;
+}
+
+SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config)
+    : sharedTables(config.shareReadOnlyTables ? SharedTables::getShared()
+                                              : std::make_shared<SharedTables>()),
+      WindowWT(sharedTables->windowWT), otherscene_clients(0)
 {
+    backgroundPool = Surge::Threading::RenderWorkerPool::backgroundPool();
+
     auto suppliedDataPath = config.suppliedDataPath;
     bool loadWtAndPatch = true;
     loadWtAndPatch = !skipLoadWtAndPatch && suppliedDataPath != skipPatchLoadDataPathSentinel &&
@@ -94,14 +135,13 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 
     _patch.reset(new SurgePatch(this));
 
-    namespace tabl = sst::basic_blocks::tables;
-    sincTableProvider = std::make_unique<tabl::SurgeSincTableProvider>();
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
-    static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
-    sinctable = sincTableProvider->sinctable;
-    sinctable1X = sincTableProvider->sinctable1X;
-    sinctableI16 = sincTableProvider->sinctableI16;
+    // so the audio thread always has a routing to read, even before the first block
+    publishModulationRouting();
+    acquireModulationRouting();
+
+    sinctable = sharedTables->sincTableProvider->sinctable;
+    sinctable1X = sharedTables->sincTableProvider->sinctable1X;
+    sinctableI16 = sharedTables->sincTableProvider->sinctableI16;
 
     for (int s = 0; s < n_scenes; s++)
         for (int m = 0; m < n_modsources; ++m)
@@ -144,6 +184,12 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
 
     init_tables();
 
+#if STORAGE_USES_INDEPENDENT_RNG
+    // These would otherwise all get the same clock based seed
+    for (auto &sr : sceneRngGen)
+        sr.g.seed(rngGen.g());
+#endif
+
     pitch_bend = 0;
     last_key[0] = 60;
     last_key[1] = 60;
@@ -425,31 +471,40 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
         refresh_patchlist();
     }
 
-#if HAS_JUCE
-    if (!load_wt_wt_mem(SurgeSharedBinary::windows_wt, SurgeSharedBinary::windows_wtSize,
-                        &WindowWT))
-    {
-        WindowWT.size = 0;
-        std::ostringstream oss;
-        oss << "Unable to load 'windows.wt' from memory. "
-            << "This is a fatal internal software error which should never occur!";
-        reportError(oss.str(), "Resource Loading Error");
-    }
-#else
-    if (fs::exists(datapath / "windows.wt"))
     {
-        std::string metadata;
-        if (!load_wt_wt(path_to_string(datapath / "windows.wt"), &WindowWT, metadata))
+        std::lock_guard<std::mutex> g(sharedTables->windowWTMutex);
+        if (!sharedTables->windowWTLoaded)
         {
-            WindowWT.size = 0;
-            std::ostringstream oss;
-            oss << "Unable to load 'windows.wt' from file. "
-                << "This is a fatal internal software error which should never occur!";
-            reportError(oss.str(), "Resource Loading Error");
-            _DBGCOUT << oss.str() << std::endl;
+#if HAS_JUCE
+            sharedTables->windowWTLoaded = load_wt_wt_mem(
+                SurgeSharedBinary::windows_wt, SurgeSharedBinary::windows_wtSize, &WindowWT);
+            if (!sharedTables->windowWTLoaded)
+            {
+                WindowWT.size = 0;
+                std::ostringstream oss;
+                oss << "Unable to load 'windows.wt' from memory. "
+                    << "This is a fatal internal software error which should never occur!";
+                reportError(oss.str(), "Resource Loading Error");
+            }
+#else
+            if (fs::exists(datapath / "windows.wt"))
+            {
+                std::string metadata;
+                sharedTables->windowWTLoaded =
+                    load_wt_wt(path_to_string(datapath / "windows.wt"), &WindowWT, metadata);
+                if (!sharedTables->windowWTLoaded)
+                {
+                    WindowWT.size = 0;
+                    std::ostringstream oss;
+                    oss << "Unable to load 'windows.wt' from file. "
+                        << "This is a fatal internal software error which should never occur!";
+                    reportError(oss.str(), "Resource Loading Error");
+                    _DBGCOUT << oss.str() << std::endl;
+                }
+            }
+#endif
         }
     }
-#endif
 
     // Tuning library support
     currentScale = Tunings::evenTemperament12NoteScale();
@@ -698,7 +753,8 @@ void SurgeStorage::initializePatchDb(bool force)
         }
         else
         {
-            if (awid[p.path.u8string()].second < p.lastModTime)
+            // anything changed on disk, newer or not, is reindexed; the rest is left alone
+            if (awid[p.path.u8string()].second != p.lastModTime)
             {
                 addThese.push_back(p);
             }
@@ -1258,8 +1314,54 @@ void SurgeStorage::refresh_wtlistFrom(bool isUser, const fs::path &p, const std:
         wt_list, wt_category);
 }
 
+void SurgeStorage::setBackgroundWavetableLoading(bool b)
+{
+    if (b && !wavetableLoader)
+    {
+        wavetableLoader = std::make_unique<Surge::Storage::WavetableLoader>(this);
+    }
+    else if (!b)
+    {
+        wavetableLoader.reset();
+    }
+}
+
+void SurgeStorage::cancelBackgroundWavetableLoads()
+{
+    if (!wavetableLoader)
+    {
+        return;
+    }
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int o = 0; o < n_oscs; o++)
+        {
+            wavetableLoader->cancel(sc, o);
+        }
+    }
+}
+
+void SurgeStorage::setPatchCacheDirectory(const fs::path &dir)
+{
+    if (dir.empty())
+    {
+        patchCache.reset();
+    }
+    else if (!patchCache || patchCache->getDirectory() != dir)
+    {
+        patchCache = std::make_unique<Surge::Storage::PatchCache>(this, dir);
+    }
+}
+
 void SurgeStorage::perform_queued_wtloads()
 {
+    if (wavetableLoader)
+    {
+        wavetableLoader->service();
+        return;
+    }
+
     SurgePatch &patch =
         getPatch(); // Change here is for performance and ease of debugging, simply not calling
                     // getPatch so many times. Code should behave identically.
@@ -2375,9 +2477,49 @@ void SurgeStorage::clipboard_paste(
         }
     }
 
+    publishModulationRouting();
     modRoutingMutex.unlock();
 }
 
+bool OscillatorStorage::queueSnapshot(TiXmlElement *e)
+{
+    // the audio thread may be reading it
+    if (queue_snapshot_pending.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    auto &q = queue_snapshot;
+    q = QueuedSnapshot{};
+
+    if (e)
+    {
+        for (int k = 0; k < n_osc_params; k++)
+        {
+            auto lbl = "p" + std::to_string(k);
+            double d = 0;
+
+            q.hasFloat[k] = e->QueryDoubleAttribute(lbl.c_str(), &d) == TIXML_SUCCESS;
+            q.fval[k] = (float)d;
+            q.hasInt[k] = e->QueryIntAttribute(lbl.c_str(), &q.ival[k]) == TIXML_SUCCESS;
+
+            lbl = "p" + std::to_string(k) + "_deform_type";
+            q.hasDeformType[k] =
+                e->QueryIntAttribute(lbl.c_str(), &q.deform_type[k]) == TIXML_SUCCESS;
+
+            lbl = "p" + std::to_string(k) + "_extend_range";
+            q.hasExtendRange[k] =
+                e->QueryIntAttribute(lbl.c_str(), &q.extend_range[k]) == TIXML_SUCCESS;
+        }
+
+        q.hasRetrigger = e->QueryIntAttribute("retrigger", &q.retrigger) == TIXML_SUCCESS;
+    }
+
+    queue_snapshot_pending.store(e != nullptr, std::memory_order_release);
+
+    return true;
+}
+
 TiXmlElement *SurgeStorage::getSnapshotSection(const char *name)
 {
     TiXmlElement *e = TINYXML_SAFE_TO_ELEMENT(snapshotloader.FirstChild(name));
@@ -2556,12 +2698,152 @@ void SurgeStorage::load_midi_controllers()
 
 SurgeStorage::~SurgeStorage()
 {
+    // the loader and publisher threads work on our patch
+    wavetableLoader.reset();
+    stopModulationRoutingPublisher();
+
 #ifndef SURGE_SKIP_ODDSOUND_MTS
     if (oddsound_mts_active_as_main)
         disconnect_as_oddsound_main();
 
     deinitialize_oddsound();
 #endif
+
+    delete publishedModRouting.exchange(nullptr);
+}
+
+uint64_t SurgeStorage::publishModulationRouting()
+{
+    std::lock_guard<std::recursive_mutex> g(modRoutingMutex);
+
+    if (modRoutingPublishDeferrals > 0 && modRoutingPublisher)
+    {
+        // The publisher can't get the lock until we let go of it, so it sees all our edits
+        modRoutingPublishRequested = true;
+        {
+            std::lock_guard<std::mutex> pg(modRoutingPublisherMutex);
+        }
+        modRoutingPublisherCV.notify_one();
+
+        return modRoutingVersionCounter + 1;
+    }
+
+    auto snap = std::make_unique<ModulationRoutingSnapshot>();
+    snap->version = ++modRoutingVersionCounter;
+    snap->global = getPatch().modulation_global;
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        snap->scene[sc] = getPatch().scene[sc].modulation_scene;
+        snap->voice[sc] = getPatch().scene[sc].modulation_voice;
+
+        auto &c = snap->voiceCompiled[sc];
+        int slotFor[n_modsources][max_lfo_indices];
+        std::fill(&slotFor[0][0], &slotFor[0][0] + n_modsources * max_lfo_indices, -1);
+
+        for (const auto &r : snap->voice[sc])
+        {
+            // A muted routing adds nothing
+            if (r.muted || r.source_id < 0 || r.source_id >= n_modsources || r.source_index < 0 ||
+                r.source_index >= max_lfo_indices)
+                continue;
+
+            auto &slot = slotFor[r.source_id][r.source_index];
+            if (slot < 0)
+            {
+                slot = (int)c.sourceId.size();
+                c.sourceId.push_back(r.source_id);
+                c.sourceIndex.push_back(r.source_index);
+                c.sourceIsLFO.push_back(isLFO((modsources)r.source_id));
+            }
+
+            c.sourceSlot.push_back(slot);
+            c.destination.push_back(r.destination_id);
+            c.depth.push_back(r.depth);
+        }
+    }
+
+    auto old = publishedModRouting.exchange(snap.release());
+    if (old)
+    {
+        retiredModRouting.emplace_back(old);
+    }
+
+    reclaimModulationRouting();
+
+    return modRoutingVersionCounter;
+}
+
+void SurgeStorage::startModulationRoutingPublisher()
+{
+    if (!modRoutingPublisher)
+    {
+        modRoutingPublisher =
+            std::make_unique<std::thread>([this]() { runModulationRoutingPublisher(); });
+    }
+}
+
+void SurgeStorage::stopModulationRoutingPublisher()
+{
+    if (!modRoutingPublisher)
+        return;
+
+    modRoutingPublisherQuitting = true;
+    {
+        std::lock_guard<std::mutex> g(modRoutingPublisherMutex);
+    }
+    modRoutingPublisherCV.notify_one();
+    modRoutingPublisher->join();
+    modRoutingPublisher.reset();
+}
+
+void SurgeStorage::runModulationRoutingPublisher()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> l(modRoutingPublisherMutex);
+            modRoutingPublisherCV.wait(l, [this]() {
+                return modRoutingPublishRequested || modRoutingPublisherQuitting;
+            });
+        }
+
+        if (modRoutingPublisherQuitting)
+            return;
+
+        modRoutingPublishRequested = false;
+        publishModulationRouting();
+    }
+}
+
+SurgeStorage::ModulationRoutingPublishDeferral::ModulationRoutingPublishDeferral()
+{
+    modRoutingPublishDeferrals++;
+}
+
+SurgeStorage::ModulationRoutingPublishDeferral::~ModulationRoutingPublishDeferral()
+{
+    modRoutingPublishDeferrals--;
+}
+
+void SurgeStorage::acquireModulationRouting()
+{
+    audioModRouting = publishedModRouting.load();
+    audioModRoutingVersion = audioModRouting->version;
+}
+
+void SurgeStorage::reclaimModulationRouting()
+{
+    /*
+     * The audio thread stores the version of the snapshot it's on after loading it, and only
+     * ever loads the newest. So anything older than that version can't be loaded any more,
+     * while a snapshot it has loaded but not yet announced is at least as new as the last
+     * version it did announce, and is kept.
+     */
+    auto inUse = audioModRoutingVersion.load();
+
+    retiredModRouting.erase(std::remove_if(retiredModRouting.begin(), retiredModRouting.end(),
+                                           [inUse](const auto &r) { return r->version < inUse; }),
+                            retiredModRouting.end());
 }
 
 double shafted_tanh(double x) { return (exp(x) - exp(-x * 1.2)) / (exp(x) + exp(-x)); }
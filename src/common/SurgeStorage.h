@@ -35,6 +35,8 @@
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <cstdint>
 #include <fstream>
 #include <iterator>
@@ -649,9 +651,33 @@ struct OscillatorStorage : public CountedSetUserData // The counted set is the w
     int wavetable_formula_res_base = 5, // 32 * 2^this
         wavetable_formula_nframes = 10;
 
-    void *queue_xmldata;
     int queue_type;
 
+    /*
+     * The settings of an oscillator snapshot (from the oscillator menu) parsed ahead of time, so
+     * loadOscalgos only has to copy them in on the audio thread. Numeric attributes are kept as
+     * both float and int since which one applies depends on the type being switched to.
+     */
+    struct QueuedSnapshot
+    {
+        bool hasFloat[n_osc_params], hasInt[n_osc_params];
+        float fval[n_osc_params];
+        int ival[n_osc_params];
+        bool hasDeformType[n_osc_params], hasExtendRange[n_osc_params];
+        int deform_type[n_osc_params], extend_range[n_osc_params];
+        bool hasRetrigger;
+        int retrigger;
+    } queue_snapshot{};
+
+    // Set with release once queue_snapshot is written; the audio thread clears it once applied
+    std::atomic<bool> queue_snapshot_pending{false};
+
+    /*
+     * UI thread. Parses e into queue_snapshot and sets it pending; set queue_type first. Says
+     * false, leaving the queued snapshot alone, if the audio thread hasn't applied the last one.
+     */
+    bool queueSnapshot(TiXmlElement *e);
+
     struct ExtraConfigurationData
     {
         static constexpr size_t max_config = 64;
@@ -1054,6 +1080,9 @@ class SurgePatch
     void formulaFromXMLElement(FormulaModulatorStorage *ms, TiXmlElement *parent) const;
 
     void load_patch(const void *data, int size, bool preset);
+    // load_patch in its two halves, so the XML half can be restored from a PatchCache instead
+    void load_patch_xml(const void *data, int size, bool preset);
+    void load_patch_wavetables(const void *data, int size);
     unsigned int save_patch(void **data);
     Parameter *parameterFromOSCName(std::string stName);
 
@@ -1205,6 +1234,8 @@ struct ScenesOutputData
 
 struct FxUserPreset;
 struct ModulatorPreset;
+struct PatchCache;
+struct WavetableLoader;
 } // namespace Storage
 namespace Memory
 {
@@ -1214,6 +1245,10 @@ namespace Formula
 {
 struct GlobalData;
 }
+namespace Threading
+{
+struct RenderWorkerPool;
+}
 } // namespace Surge
 
 namespace sst::basic_blocks::tables
@@ -1229,7 +1264,28 @@ class alignas(16) SurgeStorage
     // this will be a pointer to an aligned 2 x BLOCK_SIZE_OS array
     float audio_otherscene alignas(16)[2][BLOCK_SIZE_OS];
 
-    std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+    /*
+     * Tables which depend on neither the sample rate, the tuning nor the patch: the sinc
+     * tables and the window oscillator wavetable. Unless the config asks otherwise, every
+     * SurgeStorage alive at the same time shares one reference counted copy of these, so a
+     * host running many instances (an FX on every track, say) only builds and holds them
+     * once. Nothing may write to them after construction.
+     */
+    struct SharedTables
+    {
+        SharedTables();
+        ~SharedTables();
+
+        std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+
+        // Loaded by the first SurgeStorage to use this, since that needs a data path
+        Wavetable windowWT;
+        bool windowWTLoaded{false};
+        std::mutex windowWTMutex;
+
+        static std::shared_ptr<SharedTables> getShared();
+    };
+    std::shared_ptr<SharedTables> sharedTables;
     float *sinctable, *sinctable1X;
     int16_t *sinctableI16;
 
@@ -1251,6 +1307,8 @@ class alignas(16) SurgeStorage
         fs::path extraThirdPartyWavetablesPath{};
         fs::path extraUsersWavetablesPath{};
         bool scanWavetableAndPatches{true};
+        // Set to false to give this storage its own copy of the SharedTables
+        bool shareReadOnlyTables{true};
 
         static SurgeStorageConfig fromDataPath(const std::string &s)
         {
@@ -1386,6 +1444,24 @@ class alignas(16) SurgeStorage
 
     void perform_queued_wtloads();
 
+    /*
+     * Queued wavetables normally load at the top of the next block, right there on the audio
+     * thread, which is what headless users expect. The plugin turns on background loading
+     * instead (see WavetableLoader). A patch load cancels any background load still in flight,
+     * since it sets the wavetables itself.
+     */
+    void setBackgroundWavetableLoading(bool b);
+    bool getBackgroundWavetableLoading() const { return (bool)wavetableLoader; }
+    void cancelBackgroundWavetableLoads();
+
+    /*
+     * With a cache directory set, patches loaded by path come back from a binary snapshot
+     * after their first load rather than through the XML parser (see PatchCache). An empty
+     * path turns this off, which is the default.
+     */
+    void setPatchCacheDirectory(const fs::path &dir);
+    std::unique_ptr<Surge::Storage::PatchCache> patchCache;
+
     void load_wt(int id, Wavetable *wt, OscillatorStorage *);
     void load_wt(std::string filename, Wavetable *wt, OscillatorStorage *);
     bool load_wt_wt(std::string filename, Wavetable *wt, std::string &metadata);
@@ -1460,8 +1536,90 @@ class alignas(16) SurgeStorage
     void storeMidiMappingToName(std::string name);
 
     std::mutex waveTableDataMutex;
+    std::unique_ptr<Surge::Storage::WavetableLoader> wavetableLoader;
+
+    // Keeps RenderWorkerPool::backgroundPool() around for wavetable and patch database builds
+    std::shared_ptr<Surge::Threading::RenderWorkerPool> backgroundPool;
+
+    /*
+     * The editing side (UI, patch load, OSC, clipboard) changes the modulation_* vectors in
+     * the patch holding modRoutingMutex, then calls publishModulationRouting(), which copies
+     * them into a new immutable snapshot and swaps it in atomically.
+     *
+     * The audio thread never waits on modRoutingMutex. It picks up the latest snapshot with
+     * acquireModulationRouting() at the top of each block, and the voice and scene modulation
+     * code reads routings only from audioModulationRouting(). Retired snapshots are deleted by
+     * the publishing side once the audio thread has moved on to a later version, so the audio
+     * thread never frees one either.
+     *
+     * The few edits the audio thread makes itself (loadFx clearing the routings onto a replaced
+     * effect, or a changed oscillator type clearing the routings onto the oscillator) only
+     * try_lock modRoutingMutex, and put the change off to the next block if the editing side
+     * has it. They happen while a ModulationRoutingPublishDeferral is alive on the audio
+     * thread, so publishModulationRouting() doesn't build anything; it wakes the publisher
+     * thread, which publishes for it. Either way it returns the version of the first snapshot
+     * which will have the edits so far.
+     */
+    struct ModulationRoutingSnapshot
+    {
+        uint64_t version{0};
+        std::vector<ModulationRouting> global;
+        std::vector<ModulationRouting> scene[n_scenes], voice[n_scenes];
+
+        /*
+         * The voice routings flattened for SurgeVoice::applyModulationToLocalcopy. Each
+         * distinct (source, index) pair is listed once so a voice reads each source output once
+         * per block, and the unmuted routings are kept in their original order as parallel
+         * arrays pointing into that source list, so sums onto a shared destination happen in
+         * the same order as before.
+         */
+        struct CompiledVoiceRouting
+        {
+            static constexpr int maxSources = n_modsources * max_lfo_indices;
+
+            std::vector<int> sourceId, sourceIndex;
+            std::vector<char> sourceIsLFO;
+
+            std::vector<int> sourceSlot, destination;
+            std::vector<float> depth;
+        } voiceCompiled[n_scenes];
+    };
+
     std::recursive_mutex modRoutingMutex;
-    Wavetable WindowWT;
+    uint64_t publishModulationRouting();
+    void acquireModulationRouting();
+    const ModulationRoutingSnapshot &audioModulationRouting() const { return *audioModRouting; }
+
+    // Without a publisher thread, a deferred publish happens right away after all
+    void startModulationRoutingPublisher();
+
+    struct ModulationRoutingPublishDeferral
+    {
+        ModulationRoutingPublishDeferral();
+        ~ModulationRoutingPublishDeferral();
+    };
+
+  private:
+    void reclaimModulationRouting();
+    void stopModulationRoutingPublisher();
+    void runModulationRoutingPublisher();
+
+    static thread_local int modRoutingPublishDeferrals;
+    std::unique_ptr<std::thread> modRoutingPublisher;
+    std::mutex modRoutingPublisherMutex;
+    std::condition_variable modRoutingPublisherCV;
+    std::atomic<bool> modRoutingPublishRequested{false}, modRoutingPublisherQuitting{false};
+
+    std::atomic<ModulationRoutingSnapshot *> publishedModRouting{nullptr};
+    ModulationRoutingSnapshot *audioModRouting{nullptr};
+    std::atomic<uint64_t> audioModRoutingVersion{0};
+    uint64_t modRoutingVersionCounter{0};
+    // guarded by modRoutingMutex
+    std::vector<std::unique_ptr<ModulationRoutingSnapshot>> retiredModRouting;
+
+  public:
+    // Refers to sharedTables->windowWT
+    Wavetable &WindowWT;
 
     // hardclip
     enum HardClipMode
@@ -1748,6 +1906,22 @@ class alignas(16) SurgeStorage
         std::uniform_int_distribution<uint32_t> u32;
     } rngGen;
 
+    /*
+     * With parallel scene rendering on, the audio thread API below draws from a scene's own
+     * generator while that scene renders its voices, so scenes can render on different threads
+     * without racing on rngGen or depending on the order in which the other scene drew.
+     * SurgeSynthesizer sets sceneRngGensActive once per block; while it is off the thread local
+     * is never read and every draw comes from rngGen as it always has. See
+     * SurgeSynthesizer::renderScene.
+     */
+    RNGGen sceneRngGen[n_scenes];
+    bool sceneRngGensActive{false};
+    static thread_local RNGGen *activeRngGen;
+    inline RNGGen &currentRngGen()
+    {
+        return (sceneRngGensActive && activeRngGen) ? *activeRngGen : rngGen;
+    }
+
 #define DEBUG_RNG_THREADING 0
 #if DEBUG_RNG_THREADING
     std::thread::id audioThreadID{0};
@@ -1770,22 +1944,26 @@ class alignas(16) SurgeStorage
     inline int rand()
     {
         runningOnAudioThread();
-        return rngGen.d(rngGen.g);
+        auto &r = currentRngGen();
+        return r.d(r.g);
     }
     inline uint32_t rand_u32()
     {
         runningOnAudioThread();
-        return rngGen.u32(rngGen.g);
+        auto &r = currentRngGen();
+        return r.u32(r.g);
     }
     inline float rand_pm1()
     {
         runningOnAudioThread();
-        return rngGen.pm1(rngGen.g);
+        auto &r = currentRngGen();
+        return r.pm1(r.g);
     }
     inline float rand_01()
     {
         runningOnAudioThread();
-        return rngGen.z1(rngGen.g);
+        auto &r = currentRngGen();
+        return r.z1(r.g);
     }
 // void seed_rand(int s) { rngGen.g.seed(s); }
 #else
@@ -40,6 +40,8 @@
 #endif
 
 #include "SurgeMemoryPools.h"
+#include "PatchPreloader.h"
+#include "RenderWorkerPool.h"
 
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/Clippers.h"
@@ -67,6 +69,12 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
     load_fx_needed = true;
     process_input = false; // hosts set this if there are input busses
 
+    // publishes the routing edits made on the audio thread
+    storage.startModulationRoutingPublisher();
+
+    // its thread sleeps until something is preloaded
+    patchPreloader = std::make_unique<Surge::Storage::PatchPreloader>(&storage);
+
     fx_suspend_bitmask = 0;
 
     for (int i = 0; i < n_fx_slots; ++i)
@@ -101,6 +109,11 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
         fx_reload_mod[i] = false;
     }
 
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        voices[sc].setSlotBase(&voices_array[sc][0]);
+    }
+
     stopSound();
 
     for (int i = 0; i < MAX_VOICES; i++)
@@ -128,6 +141,11 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
 
     midiSoftTakeover =
         (bool)Surge::Storage::getUserDefaultValue(&storage, Surge::Storage::MIDISoftTakeover, 0);
+    sampleAccurateMIDI =
+        (bool)Surge::Storage::getUserDefaultValue(&storage, Surge::Storage::SampleAccurateMIDI, 0);
+
+    setParallelSceneRendering((bool)Surge::Storage::getUserDefaultValue(
+        &storage, Surge::Storage::ParallelSceneRendering, 0));
 
     patch.polylimit.val.i = DEFAULT_POLYLIMIT;
 
@@ -544,7 +562,7 @@ void SurgeSynthesizer::playNoteByFrequency(float freq, char velocity, int32_t id
 
 void SurgeSynthesizer::softkillVoice(int s)
 {
-    list<SurgeVoice *>::iterator iter, max_playing, max_released;
+    VoiceList::iterator iter, max_playing, max_released;
     int max_age = -1, max_age_release = -1;
     iter = voices[s].begin();
 
@@ -579,7 +597,7 @@ void SurgeSynthesizer::softkillVoice(int s)
 // only allow 'margin' number of voices to be softkilled simultaneously
 void SurgeSynthesizer::enforcePolyphonyLimit(int s, int margin)
 {
-    list<SurgeVoice *>::iterator iter;
+    VoiceList::iterator iter;
 
     int paddedPoly = std::min((storage.getPatch().polylimit.val.i + margin), MAX_VOICES - 1);
     if (voices[s].size() > paddedPoly)
@@ -675,23 +693,17 @@ void SurgeSynthesizer::freeVoice(SurgeVoice *v)
     }
 
     int foundScene{-1}, foundIndex{-1};
-    for (int i = 0; i < MAX_VOICES; i++)
+    for (int sc = 0; sc < n_scenes; sc++)
     {
-        if (voices_usedby[0][i] && (v == &voices_array[0][i]))
+        // voices keep their slot in voices_array for as long as they play
+        auto slot = v - voices_array[sc].data();
+        if (slot >= 0 && slot < MAX_VOICES && voices_usedby[sc][slot])
         {
             assert(foundScene == -1);
             assert(foundIndex == -1);
-            foundScene = 0;
-            foundIndex = i;
-            voices_usedby[0][i] = 0;
-        }
-        if (voices_usedby[1][i] && (v == &voices_array[1][i]))
-        {
-            assert(foundScene == -1);
-            assert(foundIndex == -1);
-            foundScene = 1;
-            foundIndex = i;
-            voices_usedby[1][i] = 0;
+            foundScene = sc;
+            foundIndex = (int)slot;
+            voices_usedby[sc][slot] = 0;
         }
     }
     v->freeAllocatedElements();
@@ -843,6 +855,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                     &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                     &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                     host_originating_key, host_originating_channel, 0.f, 0.f);
+                nvoice->startOffset = eventSampleOffset;
             }
         }
         break;
@@ -851,7 +864,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
     case pm_mono_fp:
     case pm_latch:
     {
-        list<SurgeVoice *>::const_iterator iter;
+        VoiceList::const_iterator iter;
         bool glide = false;
 
         int primode = storage.getPatch().scene[scene].monoVoicePriorityMode;
@@ -988,6 +1001,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         detune, &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegReuse, fegReuse);
+                    nvoice->startOffset = eventSampleOffset;
 
                     if (wasGated && pkeyToReuse > 0)
                     {
@@ -1077,7 +1091,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
         if (createVoice)
         {
-            list<SurgeVoice *>::const_iterator iter;
+            VoiceList::const_iterator iter;
             SurgeVoice *recycleThis{nullptr};
             float aegStart{0.}, fegStart{0.};
             for (iter = voices[scene].begin(); iter != voices[scene].end(); iter++)
@@ -1133,6 +1147,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         detune, &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegStart, fegStart);
+                    nvoice->startOffset = eventSampleOffset;
                 }
             }
             else
@@ -1173,7 +1188,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
 void SurgeSynthesizer::releaseScene(int s)
 {
-    list<SurgeVoice *>::const_iterator iter;
+    VoiceList::const_iterator iter;
     for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
     {
         freeVoice(*iter);
@@ -1319,7 +1334,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
                                                 int32_t host_noteid)
 {
     channelState[channel].keyState[key].keystate = 0;
-    list<SurgeVoice *>::const_iterator iter;
+    VoiceList::const_iterator iter;
     for (int s = 0; s < n_scenes; s++)
     {
         bool do_switch = false;
@@ -2004,12 +2019,26 @@ void SurgeSynthesizer::pitchBend(char channel, int value)
 
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_pitchbend])
-                ->set_target(storage.pitch_bend);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_pitchbend],
+                                storage.pitch_bend);
         }
     }
 }
 
+void SurgeSynthesizer::setControllerTarget(ModulationSource *ms, float f)
+{
+    auto cms = (ControllerModulationSource *)ms;
+
+    if (eventSampleOffset > 0)
+    {
+        cms->set_target_in_block(0, f, eventSampleOffset * BLOCK_SIZE_INV);
+    }
+    else
+    {
+        cms->set_target(f);
+    }
+}
+
 void SurgeSynthesizer::channelAftertouch(char channel, int value)
 {
     float fval = (float)value / 127.f;
@@ -2020,8 +2049,7 @@ void SurgeSynthesizer::channelAftertouch(char channel, int value)
     {
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_aftertouch])
-                ->set_target(fval);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_aftertouch], fval);
         }
     }
 }
@@ -2132,8 +2160,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
     case 1:
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_modwheel])
-                ->set_target(fval);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_modwheel], fval);
         }
 
         modwheelCC = value;
@@ -2142,8 +2169,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
     case 2:
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_breath])
-                ->set_target(fval);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_breath], fval);
         }
         break;
     case 6:
@@ -2174,8 +2200,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
     case 11:
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_expression])
-                ->set_target(fval);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_expression], fval);
         }
         break;
     case 32:
@@ -2191,8 +2216,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
     {
         for (int sc = 0; sc < n_scenes; sc++)
         {
-            ((ControllerModulationSource *)storage.getPatch().scene[sc].modsources[ms_sustain])
-                ->set_target(fval);
+            setControllerTarget(storage.getPatch().scene[sc].modsources[ms_sustain], fval);
         }
 
         sustainpedalCC = value;
@@ -2408,9 +2432,7 @@ void SurgeSynthesizer::channelController(char channel, int cc, int value)
                 this->setParameterSmoothed(i, fval);
 
                 // Notify audio thread param change listeners (OSC, e.g.)
-                // (which run on juce messenger thread)
-                for (const auto &it : audioThreadParamListeners)
-                    (it.second)(storage.getPatch().param_ptr[i]->oscName, fval, "");
+                queueAudioParamEvent(AudioParamEvent::PARAM_VALUE, i, fval);
 
                 int j = 0;
                 while (j < 7)
@@ -2586,7 +2608,7 @@ void SurgeSynthesizer::stopSound()
 
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::const_iterator iter;
+        VoiceList::const_iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             freeVoice(*iter);
@@ -2986,7 +3008,7 @@ void SurgeSynthesizer::switch_toggled()
 {
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::iterator iter;
+        VoiceList::iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             SurgeVoice *v = *iter;
@@ -2997,7 +3019,23 @@ void SurgeSynthesizer::switch_toggled()
 
 bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
 {
+    /*
+     * FX changes edit the routing. A full reload (patch load) waits for the editing side, but
+     * otherwise we are on the audio thread, so we only try the lock and if the UI is holding it
+     * we leave load_fx_needed set and come back next block. On the audio thread the publisher
+     * thread publishes our edits, and until we run the snapshot with them the slots they were
+     * for go unmodulated.
+     */
+    std::unique_lock<std::recursive_mutex> lockModulation(storage.modRoutingMutex,
+                                                          std::defer_lock);
+    if (force_reload_all)
+        lockModulation.lock();
+    else if (!lockModulation.try_lock())
+        return false;
+
     load_fx_needed = false;
+
+    uint32_t routingChanged = 0;
     bool localSendFX[n_fx_slots];
     for (int s = 0; s < n_fx_slots; s++)
     {
@@ -3009,6 +3047,7 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
             localSendFX[s] = true;
             storage.getPatch().isDirty = true;
             fx_reload[s] = false;
+            routingChanged |= 1U << s;
 
             std::lock_guard<std::mutex> g(fxSpawnMutex);
 
@@ -3189,10 +3228,32 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
         }
     }
 
+    if (routingChanged)
+    {
+        fxRoutingStale |= routingChanged;
+        fxRoutingStaleVersion = storage.publishModulationRouting();
+    }
+
     // if (something_changed) storage.getPatch().update_controls(false);
     return true;
 }
 
+bool SurgeSynthesizer::routesToStaleFx(int dst_id) const
+{
+    for (int s = 0; s < n_fx_slots; ++s)
+    {
+        const auto &fxs = storage.getPatch().fx[s];
+
+        if ((fxRoutingStale & (1U << s)) && dst_id >= fxs.p[0].id &&
+            dst_id <= fxs.p[n_fx_params - 1].id)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool SurgeSynthesizer::loadOscalgos()
 {
     bool algosChanged{false};
@@ -3207,18 +3268,15 @@ bool SurgeSynthesizer::loadOscalgos()
             {
                 algosChanged = true;
                 // clear assigned modulation, and echo to OSC if we change osc type, see issue #2224
-                if (osc_st.queue_type != osc_st.type.val.i)
+                // if the editing side has the routing right now, change type next block instead
+                if (osc_st.queue_type != osc_st.type.val.i && !clear_osc_modulation(s, i))
                 {
-                    clear_osc_modulation(s, i);
+                    continue;
                 }
 
                 // Notify audio thread param change listeners (OSC, e.g.)
-                // (which run on juce messenger thread)
-                std::stringstream sb;
-                sb << "/param/" << (char)('a' + s) << "/osc/" << i + 1 << "/type";
                 auto new_type = osc_st.queue_type;
-                for (const auto &it : audioThreadParamListeners)
-                    (it.second)(sb.str(), new_type, osc_type_names[new_type]);
+                queueAudioParamEvent(AudioParamEvent::OSC_TYPE, s * n_oscs + i, new_type);
 
                 osc_st.type.val.i = osc_st.queue_type;
                 storage.getPatch().update_controls(false, &osc_st);
@@ -3228,69 +3286,55 @@ bool SurgeSynthesizer::loadOscalgos()
                 localResendOscParams[s][i] = true;
             }
 
-            TiXmlElement *e = (TiXmlElement *)osc_st.queue_xmldata;
-            if (e)
+            if (osc_st.queue_snapshot_pending.load(std::memory_order_acquire))
             {
+                // parsed on the UI thread by queueSnapshot, so this is just copies
+                const auto &q = osc_st.queue_snapshot;
                 storage.getPatch().isDirty = true;
 
+                auto notify = [this](AudioParamEvent::Type t, const Parameter &p, float v) {
+                    queueAudioParamEvent(t, p.id, v);
+                };
+
                 for (int k = 0; k < n_osc_params; k++)
                 {
-                    std::string oname = osc_st.p[k].oscName;
-                    std::string sx = osc_st.p[k].get_name();
+                    auto &p = osc_st.p[k];
 
-                    double d;
-                    int j;
-                    std::string lbl;
-
-                    lbl = fmt::format("p{:d}", k);
-
-                    if (osc_st.p[k].valtype == vt_float)
+                    if (p.valtype == vt_float)
                     {
-                        if (e->QueryDoubleAttribute(lbl.c_str(), &d) == TIXML_SUCCESS)
+                        if (q.hasFloat[k])
                         {
-                            osc_st.p[k].val.f = (float)d;
-                            for (const auto &it : audioThreadParamListeners)
-                                (it.second)(oname, d, sx);
+                            p.val.f = q.fval[k];
+                            notify(AudioParamEvent::PARAM_VALUE_NAMED, p, q.fval[k]);
                         }
                     }
                     else
                     {
-                        if (e->QueryIntAttribute(lbl.c_str(), &j) == TIXML_SUCCESS)
+                        if (q.hasInt[k])
                         {
-                            osc_st.p[k].val.i = j;
-                            for (const auto &it : audioThreadParamListeners)
-                                (it.second)(oname, j, sx);
+                            p.val.i = q.ival[k];
+                            notify(AudioParamEvent::PARAM_VALUE_NAMED, p, q.ival[k]);
                         }
                     }
 
-                    lbl = fmt::format("p{:d}_deform_type", k);
-
-                    if (e->QueryIntAttribute(lbl.c_str(), &j) == TIXML_SUCCESS)
+                    if (q.hasDeformType[k])
                     {
-                        osc_st.p[k].deform_type = j;
-                        for (const auto &it : audioThreadParamListeners)
-                            (it.second)(oname, j, sx);
+                        p.deform_type = q.deform_type[k];
+                        notify(AudioParamEvent::PARAM_DEFORM, p, q.deform_type[k]);
                     }
 
-                    lbl = fmt::format("p{:d}_extend_range", k);
-
-                    if (e->QueryIntAttribute(lbl.c_str(), &j) == TIXML_SUCCESS)
+                    if (q.hasExtendRange[k])
                     {
-                        osc_st.p[k].set_extend_range(j);
-                        for (const auto &it : audioThreadParamListeners)
-                            (it.second)(oname, j, sx);
+                        p.set_extend_range(q.extend_range[k]);
+                        notify(AudioParamEvent::PARAM_EXTEND_RANGE, p, q.extend_range[k]);
                     }
                 }
 
-                int rt;
-                if (e->QueryIntAttribute("retrigger", &rt) == TIXML_SUCCESS)
+                if (q.hasRetrigger)
                 {
-                    osc_st.retrigger.val.b = rt;
-                    std::stringstream sb;
-                    sb << "/param/" << (char)('a' + s) << "/osc/" << i + 1 << "/retrigger";
-                    std::string sx = rt > 0 ? "On" : "Off";
-                    for (const auto &it : audioThreadParamListeners)
-                        (it.second)(sb.str(), rt, sx);
+                    osc_st.retrigger.val.b = q.retrigger;
+                    queueAudioParamEvent(AudioParamEvent::OSC_RETRIGGER, s * n_oscs + i,
+                                         q.retrigger);
                 }
 
                 /*
@@ -3300,7 +3344,7 @@ bool SurgeSynthesizer::loadOscalgos()
                 {
                     refresh_editor = true;
                 }
-                osc_st.queue_xmldata = 0;
+                osc_st.queue_snapshot_pending.store(false, std::memory_order_release);
             }
         }
     }
@@ -3319,6 +3363,82 @@ bool SurgeSynthesizer::loadOscalgos()
     return true;
 }
 
+void SurgeSynthesizer::drainAudioParamEvents()
+{
+    auto &st = audioParamEventStats;
+    auto &evs = drainedAudioParamEvents;
+    auto &index = drainedAudioParamEventIndex;
+
+    evs.clear();
+    index.clear();
+
+    // keep the latest value of each, in the order they first changed
+    while (auto e = audioParamEvents.pop())
+    {
+        st.drained.fetch_add(1, std::memory_order_release);
+
+        auto key = ((uint64_t)e->type << 32) | (uint32_t)e->id;
+        auto it = index.find(key);
+
+        if (it != index.end())
+        {
+            evs[it->second].value = e->value;
+            st.coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            index.emplace(key, evs.size());
+            evs.push_back(*e);
+        }
+    }
+
+    auto &patch = storage.getPatch();
+
+    for (const auto &e : evs)
+    {
+        std::string oname, valstr;
+        Parameter *p = nullptr;
+
+        if (e.type <= AudioParamEvent::PARAM_EXTEND_RANGE)
+        {
+            if (e.id < 0 || (size_t)e.id >= patch.param_ptr.size())
+                continue;
+
+            p = patch.param_ptr[e.id];
+        }
+
+        switch (e.type)
+        {
+        case AudioParamEvent::PARAM_VALUE:
+            oname = p->oscName;
+            break;
+        case AudioParamEvent::PARAM_VALUE_NAMED:
+            oname = p->oscName;
+            valstr = p->get_name();
+            break;
+        case AudioParamEvent::PARAM_DEFORM:
+            oname = p->oscName + "/deform+";
+            break;
+        case AudioParamEvent::PARAM_EXTEND_RANGE:
+            oname = p->oscName + "/extend+";
+            break;
+        case AudioParamEvent::OSC_TYPE:
+            oname = fmt::format("/param/{:c}/osc/{:d}/type", 'a' + e.id / n_oscs,
+                                e.id % n_oscs + 1);
+            valstr = osc_type_names[(int)e.value];
+            break;
+        case AudioParamEvent::OSC_RETRIGGER:
+            oname = fmt::format("/param/{:c}/osc/{:d}/retrigger", 'a' + e.id / n_oscs,
+                                e.id % n_oscs + 1);
+            valstr = e.value > 0 ? "On" : "Off";
+            break;
+        }
+
+        for (const auto &it : audioThreadParamListeners)
+            (it.second)(oname, e.value, valstr);
+    }
+}
+
 bool SurgeSynthesizer::isModulatorDistinctPerScene(modsources modsource) const
 {
     if (modsource >= ms_lfo1 && modsource <= ms_slfo6)
@@ -3685,10 +3805,13 @@ void SurgeSynthesizer::muteModulation(long ptag, modsources modsource, int modso
     if (!isValidModulation(ptag, modsource))
         return;
 
+    std::unique_lock<std::recursive_mutex> lockModulation(storage.modRoutingMutex);
     ModulationRouting *r = getModRouting(ptag, modsource, modsourceScene, index);
     if (r)
     {
         r->muted = mute;
+        storage.publishModulationRouting();
+        lockModulation.unlock();
         storage.getPatch().isDirty = true;
 
         for (auto l : modListeners)
@@ -3785,9 +3908,12 @@ void SurgeSynthesizer::applyParameterPolyphonicModulation(Parameter *p, int32_t
     }
 }
 
-void SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
+bool SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
 {
-    storage.modRoutingMutex.lock();
+    // called on the audio thread, so don't wait for the editing side
+    if (!storage.modRoutingMutex.try_lock())
+        return false;
+
     vector<ModulationRouting>::iterator iter;
 
     int pid = storage.getPatch().scene[scene].osc[entry].p[0].param_id_in_scene;
@@ -3811,7 +3937,10 @@ void SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
         else
             iter++;
     }
+    storage.publishModulationRouting();
     storage.modRoutingMutex.unlock();
+
+    return true;
 }
 
 bool SurgeSynthesizer::supportsIndexedModulator(int scene, modsources modsource) const
@@ -3894,6 +4023,7 @@ void SurgeSynthesizer::clearModulation(long ptag, modsources modsource, int mods
         {
             storage.modRoutingMutex.lock();
             modlist->erase(modlist->begin() + i);
+            storage.publishModulationRouting();
             storage.modRoutingMutex.unlock();
             storage.getPatch().isDirty = true;
 
@@ -3972,6 +4102,7 @@ bool SurgeSynthesizer::setModDepth01(long ptag, modsources modsource, int modsou
             modlist->at(found_id).depth = value;
         }
     }
+    storage.publishModulationRouting();
     storage.modRoutingMutex.unlock();
 
     for (auto l : modListeners)
@@ -4252,6 +4383,8 @@ void loadPatchInBackgroundThread(SurgeSynthesizer *sy)
     return;
 }
 
+void SurgeSynthesizer::preloadPatches(const std::vector<int> &ids) { patchPreloader->preload(ids); }
+
 void SurgeSynthesizer::processAudioThreadOpsWhenAudioEngineUnavailable(bool dangerMode)
 {
     if (!audio_processing_active || dangerMode)
@@ -4454,19 +4587,18 @@ void SurgeSynthesizer::processControl()
             // for(int i=0; i<n_lfos_scene; i++)
             // storage.getPatch().scene[s].modsources[ms_slfo1+i]->process_block();
 
-            int n = storage.getPatch().scene[s].modulation_scene.size();
-            for (int i = 0; i < n; i++)
+            for (const auto &r : storage.audioModulationRouting().scene[s])
             {
-                int src_id = storage.getPatch().scene[s].modulation_scene[i].source_id;
-                int src_index = storage.getPatch().scene[s].modulation_scene[i].source_index;
+                int src_id = r.source_id;
+                int src_index = r.source_index;
                 if (storage.getPatch().scene[s].modsources[src_id])
                 {
-                    int dst_id = storage.getPatch().scene[s].modulation_scene[i].destination_id;
-                    float depth = storage.getPatch().scene[s].modulation_scene[i].depth;
+                    int dst_id = r.destination_id;
+                    float depth = r.depth;
                     storage.getPatch().scenedata[s][dst_id].f +=
                         depth *
                         storage.getPatch().scene[s].modsources[src_id]->get_output(src_index) *
-                        (1.0 - storage.getPatch().scene[s].modulation_scene[i].muted);
+                        (1.0 - r.muted);
                 }
             }
 
@@ -4489,19 +4621,28 @@ void SurgeSynthesizer::processControl()
 
     loadOscalgos();
 
-    int n = storage.getPatch().modulation_global.size();
-    for (int i = 0; i < n; i++)
+    if (fxRoutingStale && storage.audioModulationRouting().version >= fxRoutingStaleVersion)
     {
-        int src_id = storage.getPatch().modulation_global[i].source_id;
-        int src_index = storage.getPatch().modulation_global[i].source_index;
-        int dst_id = storage.getPatch().modulation_global[i].destination_id;
-        float depth = storage.getPatch().modulation_global[i].depth;
-        int source_scene = storage.getPatch().modulation_global[i].source_scene;
+        fxRoutingStale = 0;
+    }
+
+    for (const auto &r : storage.audioModulationRouting().global)
+    {
+        int src_id = r.source_id;
+        int src_index = r.source_index;
+        int dst_id = r.destination_id;
+        float depth = r.depth;
+        int source_scene = r.source_scene;
+
+        if (fxRoutingStale && routesToStaleFx(dst_id))
+        {
+            continue;
+        }
 
         storage.getPatch().globaldata[dst_id].f +=
             depth *
             storage.getPatch().scene[source_scene].modsources[src_id]->get_output(src_index) *
-            (1 - storage.getPatch().modulation_global[i].muted);
+            (1 - r.muted);
     }
 
     if (switch_toggled_queued)
@@ -4566,6 +4707,9 @@ void SurgeSynthesizer::process()
 #endif
     processRunning = 0;
 
+    // Any routing edits made from here on are published by the publisher thread
+    SurgeStorage::ModulationRoutingPublishDeferral deferModulationRoutingPublish;
+
 #if DEBUG
     memset(endedHostNoteIds, 0, 512 * sizeof(int32_t));
 #endif
@@ -4673,7 +4817,7 @@ void SurgeSynthesizer::process()
         }
     }
 
-    storage.modRoutingMutex.lock();
+    storage.acquireModulationRouting();
     processControl();
 
     amp.set_target_smoothed(
@@ -4707,121 +4851,53 @@ void SurgeSynthesizer::process()
         }
     }
 
-    list<SurgeVoice *>::iterator iter;
-
     for (int sc = 0; sc < n_scenes; sc++)
     {
         play_scene[sc] = (!voices[sc].empty());
     }
 
-    int FBentry[n_scenes];
-    int vcount = 0;
+    // Scenes keep drawing from their own generators in blocks that fall back to serial rendering,
+    // so the output doesn't depend on which blocks managed to render in parallel
+    bool renderParallel = parallelSceneRendering;
+    storage.sceneRngGensActive = renderParallel;
 
-    for (int s = 0; s < n_scenes; s++)
+    if (renderParallel && canRenderScenesInParallel())
     {
-        FBentry[s] = 0;
-        iter = voices[s].begin();
-        while (iter != voices[s].end())
+        for (int s = 1; s < n_scenes; s++)
         {
-            SurgeVoice *v = *iter;
-            assert(v);
-            bool resume = v->process_block(FBQ[s][FBentry[s] >> 2], FBentry[s] & 3);
-            FBentry[s]++;
-
-            vcount++;
-
-            if (!resume)
-            {
-                freeVoice(v);
-                iter = voices[s].erase(iter);
-            }
-            else
-                iter++;
+            sceneRenderPool->post(s - 1, renderSceneJob, this, s);
         }
 
-        storage.modRoutingMutex.unlock();
+        renderScene(0);
 
-        using sst::filters::FilterType, sst::filters::FilterSubType;
-        fbq_global g;
-        if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
-        {
-            g.FU1ptr = nullptr;
-        }
-        else
-        {
-            g.FU1ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[0].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[0].subtype.val.i));
-        }
-        if (storage.getPatch().scene[s].filterunit[1].type.deactivated)
+        for (int s = 1; s < n_scenes; s++)
         {
-            g.FU2ptr = nullptr;
+            sceneRenderPool->join(s - 1);
         }
-        else
-        {
-            g.FU2ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[1].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[1].subtype.val.i));
-        }
-
-        if (storage.getPatch().scene[s].wsunit.type.deactivated)
-        {
-            g.WSptr = nullptr;
-        }
-        else
-        {
-            g.WSptr =
-                sst::waveshapers::GetQuadWaveshaper(static_cast<sst::waveshapers::WaveshaperType>(
-                    storage.getPatch().scene[s].wsunit.type.val.i));
-        }
-
-        FBQFPtr ProcessQuadFB =
-            GetFBQPointer(storage.getPatch().scene[s].filterblock_configuration.val.i,
-                          g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
-
-        for (int e = 0; e < FBentry[s]; e += 4)
-        {
-            int units = FBentry[s] - e;
-            for (int i = units; i < 4; i++)
-            {
-                FBQ[s][e >> 2].FU[0].active[i] = 0;
-                FBQ[s][e >> 2].FU[1].active[i] = 0;
-                FBQ[s][e >> 2].FU[2].active[i] = 0;
-                FBQ[s][e >> 2].FU[3].active[i] = 0;
-            }
-            ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
-        }
-
-        if (s == 0 && storage.otherscene_clients > 0)
+    }
+    else
+    {
+        for (int s = 0; s < n_scenes; s++)
         {
-            // Make available for scene B
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
+            renderScene(s);
         }
+    }
 
-        iter = voices[s].begin();
-
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            v->GetQFB(); // save filter state in voices after quad processing is done
-            iter++;
-        }
+    // Free finished voices in the same order as rendering them serially used to
+    int vcount = 0;
 
-        storage.modRoutingMutex.lock();
+    for (int s = 0; s < n_scenes; s++)
+    {
+        vcount += sceneVoiceCount[s];
 
-        // mute scene
-        if (storage.getPatch().scene[s].volume.deactivated)
+        for (int i = 0; i < endedVoiceCount[s]; ++i)
         {
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
+            auto v = endedVoices[s][i];
+            freeVoice(v);
+            voices[s].remove(v);
         }
     }
 
-    storage.modRoutingMutex.unlock();
     storage.activeVoiceCount = vcount;
 
     // TODO: FIX SCENE ASSUMPTION
@@ -5066,6 +5142,179 @@ SurgeSynthesizer::PluginLayer *SurgeSynthesizer::getParent()
     return _parent;
 }
 
+void SurgeSynthesizer::setParallelSceneRendering(bool b)
+{
+    // The pool is never torn down while the synth lives, so the audio thread can keep using it
+    // for the rest of a block in which this is turned off
+    if (b && !sceneRenderPool)
+    {
+        sceneRenderPool = std::make_unique<Surge::Threading::RenderWorkerPool>(n_scenes - 1);
+    }
+
+    parallelSceneRendering = b;
+}
+
+bool SurgeSynthesizer::canRenderScenesInParallel()
+{
+    if (!sceneRenderPool || sceneRenderPool->size() < n_scenes - 1)
+        return false;
+
+    // Scene B reads scene A's output through its audio input oscillators
+    if (storage.otherscene_clients > 0)
+        return false;
+
+    // Voice formula LFOs evaluate in the one audio Lua state
+    for (int s = 0; s < n_scenes; s++)
+    {
+        if (voices[s].empty())
+            continue;
+
+        for (int l = 0; l < n_lfos_voice; ++l)
+        {
+            if (storage.getPatch().scene[s].lfo[l].shape.val.i == lt_formula)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void SurgeSynthesizer::renderSceneJob(void *synth, int scene)
+{
+    static_cast<SurgeSynthesizer *>(synth)->renderScene(scene);
+}
+
+void SurgeSynthesizer::renderScene(int s)
+{
+#if STORAGE_USES_INDEPENDENT_RNG
+    if (storage.sceneRngGensActive)
+    {
+        SurgeStorage::activeRngGen = &storage.sceneRngGen[s];
+    }
+#endif
+
+    int FBentry = 0;
+    endedVoiceCount[s] = 0;
+
+    int nVoices = (int)voices[s].size();
+    bool batchOscillators = SurgeVoice::planBatchedOscillators(voices[s].begin(), nVoices);
+
+    if (batchOscillators)
+    {
+        for (auto iter = voices[s].begin(); iter != voices[s].end(); ++iter)
+        {
+            (*iter)->prepareBlock(FBQ[s][FBentry >> 2], FBentry & 3);
+            FBentry++;
+        }
+
+        SurgeVoice::renderBatchedOscillators(voices[s].begin(), nVoices);
+        FBentry = 0;
+    }
+
+    for (auto iter = voices[s].begin(); iter != voices[s].end(); ++iter)
+    {
+        SurgeVoice *v = *iter;
+        assert(v);
+        bool resume = batchOscillators ? v->renderBlock(FBQ[s][FBentry >> 2], FBentry & 3)
+                                       : v->process_block(FBQ[s][FBentry >> 2], FBentry & 3);
+        FBentry++;
+
+        // freeVoice looks at every scene's voices, so it has to wait until they're all done
+        if (!resume)
+        {
+            endedVoices[s][endedVoiceCount[s]++] = v;
+        }
+    }
+
+    sceneVoiceCount[s] = FBentry;
+
+    using sst::filters::FilterType, sst::filters::FilterSubType;
+    fbq_global g;
+    if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
+    {
+        g.FU1ptr = nullptr;
+    }
+    else
+    {
+        g.FU1ptr = sst::filters::GetQFPtrFilterUnit(
+            static_cast<FilterType>(storage.getPatch().scene[s].filterunit[0].type.val.i),
+            static_cast<FilterSubType>(storage.getPatch().scene[s].filterunit[0].subtype.val.i));
+    }
+    if (storage.getPatch().scene[s].filterunit[1].type.deactivated)
+    {
+        g.FU2ptr = nullptr;
+    }
+    else
+    {
+        g.FU2ptr = sst::filters::GetQFPtrFilterUnit(
+            static_cast<FilterType>(storage.getPatch().scene[s].filterunit[1].type.val.i),
+            static_cast<FilterSubType>(storage.getPatch().scene[s].filterunit[1].subtype.val.i));
+    }
+
+    if (storage.getPatch().scene[s].wsunit.type.deactivated)
+    {
+        g.WSptr = nullptr;
+    }
+    else
+    {
+        g.WSptr = sst::waveshapers::GetQuadWaveshaper(static_cast<sst::waveshapers::WaveshaperType>(
+            storage.getPatch().scene[s].wsunit.type.val.i));
+    }
+
+    FBQFPtr ProcessQuadFB =
+        GetFBQPointer(storage.getPatch().scene[s].filterblock_configuration.val.i,
+                      g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+
+    for (int e = 0; e < FBentry; e += 4)
+    {
+        int units = FBentry - e;
+        for (int i = units; i < 4; i++)
+        {
+            FBQ[s][e >> 2].FU[0].active[i] = 0;
+            FBQ[s][e >> 2].FU[1].active[i] = 0;
+            FBQ[s][e >> 2].FU[2].active[i] = 0;
+            FBQ[s][e >> 2].FU[3].active[i] = 0;
+        }
+        ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
+    }
+
+    if (s == 0 && storage.otherscene_clients > 0)
+    {
+        // Make available for scene B
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
+    }
+
+    int ended = 0;
+    for (auto iter = voices[s].begin(); iter != voices[s].end(); ++iter)
+    {
+        // endedVoices is in list order, and those are about to be freed anyway
+        if (ended < endedVoiceCount[s] && endedVoices[s][ended] == *iter)
+        {
+            ended++;
+            continue;
+        }
+
+        SurgeVoice *v = *iter;
+        assert(v);
+        v->GetQFB(); // save filter state in voices after quad processing is done
+    }
+
+    // mute scene
+    if (storage.getPatch().scene[s].volume.deactivated)
+    {
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
+    }
+
+#if STORAGE_USES_INDEPENDENT_RNG
+    if (storage.sceneRngGensActive)
+    {
+        SurgeStorage::activeRngGen = nullptr;
+    }
+#endif
+}
+
 void SurgeSynthesizer::populateDawExtraState()
 {
     auto &des = storage.getPatch().dawExtraState;
@@ -5299,6 +5548,7 @@ void SurgeSynthesizer::swapMetaControllers(int c1, int c2)
         }
     }
 
+    storage.publishModulationRouting();
     storage.modRoutingMutex.unlock();
 
     refresh_editor = true;
@@ -5484,6 +5734,7 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
     {
         mv->erase(mv->begin() + *dt);
     }
+    storage.publishModulationRouting();
 
     if (m != FXReorderMode::COPY)
     {
@@ -26,6 +26,7 @@
 #include "SurgeVoice.h"
 #include "Effect.h"
 #include "BiquadFilter.h"
+#include "VoiceSlotList.h"
 #include <set>
 #include <sst/filters/HalfRateFilter.h>
 
@@ -51,6 +52,18 @@ struct parametermeta
     bool hide, expert, meta;
 };
 
+namespace Surge
+{
+namespace Storage
+{
+struct PatchPreloader;
+}
+namespace Threading
+{
+struct RenderWorkerPool;
+}
+} // namespace Surge
+
 class alignas(16) SurgeSynthesizer
 {
   public:
@@ -103,6 +116,17 @@ class alignas(16) SurgeSynthesizer
     void channelAftertouch(char channel, int value);
     void channelController(char channel, int cc, int value);
     void programChange(char channel, int value);
+
+    /*
+     * How many samples into the coming block the events being applied right now land. A host
+     * wrapper in sampleAccurateMIDI mode applies each block's events before calling process()
+     * and sets this for each of them: voices started then begin at that sample, and pitch
+     * bend, aftertouch and the wheel, breath, expression and sustain controllers only smooth
+     * over the rest of the block. Left at 0, everything lands at the block start.
+     */
+    int eventSampleOffset{0};
+    void setControllerTarget(ModulationSource *ms, float f);
+
     void allNotesOff();
     void allSoundOff();
     void setSamplerate(float sr);
@@ -113,6 +137,18 @@ class alignas(16) SurgeSynthesizer
     int getMpeMainChannel(int voiceChannel, int key);
     void process();
 
+    /*
+     * Opt in to rendering the scenes' voices and filter chains on helper threads, with the
+     * audio thread taking scene A. While this is on each scene draws from its own RNG while
+     * rendering and freeing finished voices waits until all scenes are done, so the output
+     * doesn't depend on thread timing; with it off the random stream is the usual rngGen one.
+     * Patches where the scenes can't be separated (scene A fed to scene B's audio input, or
+     * voice formula LFOs, which share a Lua state) still render serially. Call this from the
+     * UI thread.
+     */
+    void setParallelSceneRendering(bool b);
+    bool getParallelSceneRendering() const { return parallelSceneRendering; }
+
     PluginLayer *getParent();
 
     // protected:
@@ -376,7 +412,7 @@ class alignas(16) SurgeSynthesizer
     void clearModulation(long ptag, modsources modsource, int modsourceScene, int index,
                          bool clearEvenIfInvalid);
     // clear the modulation routings on the algorithm-specific sliders
-    void clear_osc_modulation(int scene, int entry);
+    bool clear_osc_modulation(int scene, int entry);
 
     /*
      * The modulation API (setModDepth01 etc...) is called from all sorts of places
@@ -424,11 +460,26 @@ class alignas(16) SurgeSynthesizer
     void enqueuePatchForLoad(const void *data, int size); // safe from any thread
     void processEnqueuedPatchIfNeeded();                  // only safe from audio thread
 
-    void loadRaw(const void *data, int size, bool preset = false);
+    // source is the file the data came from, if any, which lets the patch cache have a go
+    void loadRaw(const void *data, int size, bool preset = false, const fs::path &source = {});
     void loadPatch(int id);
     bool loadPatchByPath(const char *fxpPath, int categoryId, const char *name,
                          bool forceIsPreset = true);
+    // loadPatchByPath once the file is read
+    void loadPatchChunk(const void *data, int size, int categoryId, const char *name,
+                        bool forceIsPreset, const fs::path &source);
     void selectRandomPatch();
+
+    /*
+     * Keeps these patch_list ids (the neighbours of the current patch, a setlist...) read and
+     * ready on a background thread, replacing any earlier set. loadPatch takes one which is
+     * ready from memory with its wavetables already built, so the engine is halted for less
+     * time while it loads; the fade out and the loader thread are the same as for any load.
+     * jogPatch keeps the patch it goes to and the ones either side of it preloaded.
+     */
+    void preloadPatches(const std::vector<int> &ids);
+    void preloadNeighbouringPatches(int id);
+    std::unique_ptr<Surge::Storage::PatchPreloader> patchPreloader;
     std::unique_ptr<std::thread> patchLoadThread;
 
     // if increment is true, we go to next patch, else go to previous patch
@@ -460,11 +511,63 @@ class alignas(16) SurgeSynthesizer
 
     //==============================================================================
     // Parameter changes coming from within the synth (e.g. from MIDI-learned input)
-    // are communicated to listeners here
+    // are communicated to listeners here. The audio thread only queues a compact event for
+    // each; drainAudioParamEvents, called off the audio thread (once a UI frame, say),
+    // coalesces them to the latest value of each and calls the listeners with their addresses.
     std::unordered_map<std::string, std::function<void(const std::string oscname, const float fval,
                                                        std::string valstr)>>
         audioThreadParamListeners;
 
+    struct AudioParamEvent
+    {
+        enum Type : uint8_t
+        {
+            PARAM_VALUE,        // param id's OSC name and value
+            PARAM_VALUE_NAMED,  // and its display name as the string
+            PARAM_DEFORM,       // param id's deform type
+            PARAM_EXTEND_RANGE, // param id's extend range
+            OSC_TYPE,           // oscillator id (scene * n_oscs + osc) changed type to value
+            OSC_RETRIGGER       // or had its retrigger set to value
+        } type{PARAM_VALUE};
+
+        int32_t id{0};
+        float value{0.f};
+    };
+
+    static constexpr size_t audioParamEventCapacity{1024};
+    sst::cpputils::SimpleRingBuffer<AudioParamEvent, audioParamEventCapacity> audioParamEvents;
+
+    struct AudioParamEventStats
+    {
+        // queued and dropped are written by the audio thread, the rest by the draining thread
+        std::atomic<uint64_t> queued{0}, dropped{0}, drained{0}, coalesced{0};
+    } audioParamEventStats;
+
+    // Audio thread. Drops the event, and counts it, if the queue is full; so a stalled consumer
+    // costs notifications rather than blocking or overwriting ones not yet read.
+    void queueAudioParamEvent(AudioParamEvent::Type type, int32_t id, float value)
+    {
+        if (audioThreadParamListeners.empty())
+            return;
+
+        auto &st = audioParamEventStats;
+        auto queued = st.queued.load(std::memory_order_relaxed);
+
+        if (queued - st.drained.load(std::memory_order_acquire) >= audioParamEventCapacity - 1)
+        {
+            st.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        audioParamEvents.push({type, id, value});
+        st.queued.store(queued + 1, std::memory_order_release);
+    }
+
+    // Any one thread other than the audio thread
+    void drainAudioParamEvents();
+    std::vector<AudioParamEvent> drainedAudioParamEvents; // drainAudioParamEvents' scratch
+    std::unordered_map<uint64_t, size_t> drainedAudioParamEventIndex;
+
     void addAudioParamListener(std::string key,
                                std::function<void(const std::string oscname, const float fval,
                                                   std::string valstr)> const &l)
@@ -490,6 +593,7 @@ class alignas(16) SurgeSynthesizer
     std::atomic<int> hasUpdatedMidiCC;
     std::atomic<int> modwheelCC, pitchbendMIDIVal, sustainpedalCC;
     std::atomic<bool> midiSoftTakeover;
+    std::atomic<bool> sampleAccurateMIDI{false};
 
     float vu_peak[8];
     std::atomic<float> cpu_level{0.f};
@@ -504,7 +608,8 @@ class alignas(16) SurgeSynthesizer
     bool approachingAllSoundOff{false};
     // TODO: FIX SCENE ASSUMPTION (for halfbandA/B - use std::array)
     sst::filters::HalfRate::HalfRateFilter halfbandA, halfbandB, halfbandIN;
-    std::list<SurgeVoice *> voices[n_scenes];
+    typedef Surge::VoiceSlotList<SurgeVoice, MAX_VOICES> VoiceList;
+    VoiceList voices[n_scenes];
     std::unique_ptr<Effect> fx[n_fx_slots];
     std::atomic<bool> halt_engine;
     MidiChannelState channelState[16];
@@ -539,6 +644,12 @@ class alignas(16) SurgeSynthesizer
         FxStorage(fxslot_global4)}; // used for synchronisation of parameter init
     bool fx_reload_mod[n_fx_slots];
 
+    // FX slots whose routings loadFx changed, left unmodulated until the audio thread runs a
+    // snapshot of at least fxRoutingStaleVersion
+    uint32_t fxRoutingStale{0};
+    uint64_t fxRoutingStaleVersion{0};
+    bool routesToStaleFx(int dst_id) const;
+
     struct FXModSyncItem
     {
         int source_id;
@@ -586,6 +697,17 @@ class alignas(16) SurgeSynthesizer
     ControllerModulationSource mControlInterpolator[num_controlinterpolators];
     bool mControlInterpolatorUsed[num_controlinterpolators];
 
+    std::atomic<bool> parallelSceneRendering{false};
+    std::unique_ptr<Surge::Threading::RenderWorkerPool> sceneRenderPool;
+    bool canRenderScenesInParallel();
+    void renderScene(int scene);
+    static void renderSceneJob(void *synth, int scene);
+
+    // Written by renderScene, which may run off the audio thread, and consumed after the join
+    int sceneVoiceCount[n_scenes]{};
+    int endedVoiceCount[n_scenes]{};
+    SurgeVoice *endedVoices[n_scenes][MAX_VOICES];
+
     int GetFreeControlInterpolatorIndex();
     int GetControlInterpolatorIndex(int Idx);
     void ReleaseControlInterpolator(int Idx);
@@ -30,9 +30,11 @@
 #include <fstream>
 #include <iterator>
 #include "SurgeMemoryPools.h"
+#include "PatchPreloader.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 #include "PatchFileHeaderStructs.h"
+#include "PatchCache.h"
 
 namespace mech = sst::basic_blocks::mechanics;
 
@@ -119,6 +121,10 @@ void SurgeSynthesizer::jogPatch(bool increment, bool insideCategory)
 
         patchid_queue = storage.patchOrdering[order];
     }
+
+    // so jogging on from here doesn't have to wait for the disk
+    preloadNeighbouringPatches(patchid_queue);
+
     processAudioThreadOpsWhenAudioEngineUnavailable();
     return;
 }
@@ -202,10 +208,53 @@ void SurgeSynthesizer::loadPatch(int id)
     patchid = id;
 
     Patch e = storage.patch_list[id];
-    loadPatchByPath(path_to_string(e.path).c_str(), e.category, e.name.c_str());
+
+    // a preloaded patch is already read, and the wavetable cache has its wavetables built
+    bool preloaded = patchPreloader && patchPreloader->withEntry(id, e.path, [&](const auto &pe) {
+        loadPatchChunk(pe.chunk.get(), pe.chunkSize, e.category, e.name.c_str(), true, pe.path);
+    });
+
+    if (!preloaded)
+    {
+        loadPatchByPath(path_to_string(e.path).c_str(), e.category, e.name.c_str());
+    }
+
     storage.getPatch().isDirty = false;
 }
 
+void SurgeSynthesizer::preloadNeighbouringPatches(int id)
+{
+    int p = storage.patch_list.size();
+
+    if (id < 0 || id >= p)
+    {
+        return;
+    }
+
+    // the patch itself, and where jogPatch inside its category would go from it either way
+    auto category = storage.patch_list[id].category;
+    std::vector<int> ids{id};
+
+    for (int step : {1, -1})
+    {
+        int order = storage.patch_list[id].order;
+
+        do
+        {
+            order = (order + step + p) % p;
+        } while (storage.patch_list[storage.patchOrdering[order]].category != category);
+
+        auto n = storage.patchOrdering[order];
+
+        if (std::find(ids.begin(), ids.end(), n) == ids.end())
+        {
+            ids.push_back(n);
+        }
+    }
+
+    preloadPatches(ids);
+}
+
 bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, const char *patchName,
                                        bool forceIsPreset)
 {
@@ -266,6 +315,15 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
 
     f.close();
 
+    loadPatchChunk(data.get(), cs, categoryId, patchName, forceIsPreset, string_to_path(fxpPath));
+
+    return true;
+}
+
+void SurgeSynthesizer::loadPatchChunk(const void *data, int size, int categoryId,
+                                      const char *patchName, bool forceIsPreset,
+                                      const fs::path &source)
+{
     storage.getPatch().comment = "";
     storage.getPatch().author = "";
 
@@ -281,8 +339,7 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
     current_category_id = categoryId;
     storage.getPatch().name = patchName;
 
-    loadRaw(data.get(), cs, forceIsPreset);
-    data.reset();
+    loadRaw(data, size, forceIsPreset, source);
 
     // OK so at this point we may have loaded a patch with a tuning override
     if (storage.getPatch().patchTuning.tuningStoredInPatch)
@@ -372,8 +429,6 @@ bool SurgeSynthesizer::loadPatchByPath(const char *fxpPath, int categoryId, cons
     // Notify the host display that the patch name has changed
     storage.getPatch().isDirty = false;
     updateDisplay();
-
-    return true;
 }
 
 void SurgeSynthesizer::enqueuePatchForLoad(const void *data, int size)
@@ -418,16 +473,28 @@ void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
     }
 }
 
-void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
+void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset, const fs::path &source)
 {
     halt_engine = true;
     stopSound();
+    // the patch brings its own wavetables, so nothing queued before it should land after it
+    storage.cancelBackgroundWavetableLoads();
     for (int s = 0; s < n_scenes; s++)
         for (int i = 0; i < n_customcontrollers; i++)
             storage.getPatch().scene[s].modsources[ms_ctrl1 + i]->reset();
 
     storage.getPatch().init_default_values();
-    storage.getPatch().load_patch(data, size, preset);
+
+    if (storage.patchCache && !source.empty())
+    {
+        storage.patchCache->load(storage.getPatch(), source, data, size, preset);
+    }
+    else
+    {
+        storage.getPatch().load_patch(data, size, preset);
+    }
+
+    storage.publishModulationRouting();
     storage.getPatch().update_controls(false, nullptr, true);
     for (int i = 0; i < n_fx_slots; i++)
     {
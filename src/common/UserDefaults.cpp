@@ -66,6 +66,12 @@ std::string defaultKeyToString(DefaultKey k)
     case MIDISoftTakeover:
         r = "MIDISoftTakeover";
         break;
+    case SampleAccurateMIDI:
+        r = "sampleAccurateMIDI";
+        break;
+    case ParallelSceneRendering:
+        r = "parallelSceneRendering";
+        break;
     case RestoreMSEGSnapFromPatch:
         r = "restoreMSEGSnapFromPatch";
         break;
@@ -341,6 +347,9 @@ std::string defaultKeyToString(DefaultKey k)
     case FXUnitDefaultZoom:
         r = "fxUnitDefaultZoom";
         break;
+    case FXUnitBackgroundTypeChange:
+        r = "fxUnitBackgroundTypeChange";
+        break;
 
     case MenuAndEditKeybindingsFollowKeyboardFocus:
         r = "menuAndEditKeybindingsFollowKeyboardFocus";
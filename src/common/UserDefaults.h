@@ -98,6 +98,8 @@ enum DefaultKey
     UseCh2Ch3ToPlayScenesIndividually,
     MenuBasedMIDILearnChannel,
     MIDISoftTakeover,
+    SampleAccurateMIDI,
+    ParallelSceneRendering,
 
     SmoothingMode,
     MonoPedalMode,
@@ -167,6 +169,7 @@ enum DefaultKey
     // Surge XT Effects specific defaults
     FXUnitAssumeFixedBlock,
     FXUnitDefaultZoom,
+    FXUnitBackgroundTypeChange,
 
     IgnoreMIDIProgramChange_Deprecated, // better PC support means skip this
 
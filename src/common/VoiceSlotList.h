@@ -0,0 +1,141 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_VOICESLOTLIST_H
+#define SURGE_SRC_COMMON_VOICESLOTLIST_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace Surge
+{
+/*
+ * The playing voices of a scene, in the order they started. The voices themselves live in a
+ * fixed array owned by the synth; this holds pointers to them in one contiguous run, so walking
+ * the playing voices never chases list nodes and starting or ending a note never allocates.
+ *
+ * Alongside the order we keep a bitmask of which slots of the voice array are in the list, so
+ * a voice's slot index is stable for as long as it plays and membership is a single bit test.
+ *
+ * The interface is the subset of std::list we used, so iteration, erase-while-iterating and
+ * front() read as they did. Note that erase() invalidates iterators past the erased element.
+ */
+template <typename T, int N> struct VoiceSlotList
+{
+    static_assert(N > 0 && N <= 64, "The active slot mask is a single uint64_t");
+
+    typedef T *value_type;
+    typedef T **iterator;
+    typedef T *const *const_iterator;
+
+    // The voice array the slot indices refer to. Has to be set before pushing anything.
+    void setSlotBase(T *b) { base = b; }
+
+    iterator begin() { return order; }
+    iterator end() { return order + count; }
+    const_iterator begin() const { return order; }
+    const_iterator end() const { return order + count; }
+
+    size_t size() const { return (size_t)count; }
+    bool empty() const { return count == 0; }
+
+    T *front() const
+    {
+        assert(count > 0);
+        return order[0];
+    }
+    T *back() const
+    {
+        assert(count > 0);
+        return order[count - 1];
+    }
+
+    int slotOf(const T *v) const
+    {
+        assert(base && v >= base && v < base + N);
+        return (int)(v - base);
+    }
+    bool contains(const T *v) const
+    {
+        return base && v >= base && v < base + N && (activeMask & bit(slotOf(v)));
+    }
+    uint64_t activeSlots() const { return activeMask; }
+
+    void push_back(T *v)
+    {
+        assert(count < N);
+        assert(!contains(v));
+        order[count++] = v;
+        activeMask |= bit(slotOf(v));
+    }
+
+    iterator erase(iterator it)
+    {
+        assert(it >= begin() && it < end());
+        activeMask &= ~bit(slotOf(*it));
+
+        for (auto q = it + 1; q < end(); ++q)
+        {
+            *(q - 1) = *q;
+        }
+        count--;
+
+        return it;
+    }
+
+    // Removes v if present, keeping the others in order. Returns whether it was there.
+    bool remove(T *v)
+    {
+        if (!contains(v))
+            return false;
+
+        for (auto it = begin(); it != end(); ++it)
+        {
+            if (*it == v)
+            {
+                erase(it);
+                return true;
+            }
+        }
+
+        assert(false);
+        return false;
+    }
+
+    void clear()
+    {
+        count = 0;
+        activeMask = 0;
+    }
+
+  private:
+    static uint64_t bit(int slot) { return (uint64_t)1 << slot; }
+
+    T *order[N]{};
+    int count{0};
+    uint64_t activeMask{0};
+    T *base{nullptr};
+};
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_VOICESLOTLIST_H
@@ -0,0 +1,263 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "WavetableLoader.h"
+
+#include <chrono>
+
+namespace Surge
+{
+namespace Storage
+{
+WavetableLoader::WavetableLoader(SurgeStorage *s) : storage(s)
+{
+    thread = std::thread([this]() { run(); });
+}
+
+WavetableLoader::~WavetableLoader()
+{
+    quitting = true;
+
+    {
+        std::lock_guard<std::mutex> g(m);
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void WavetableLoader::service()
+{
+    auto &patch = storage->getPatch();
+    bool requested = false;
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        for (int o = 0; o < n_oscs; o++)
+        {
+            auto &osc = patch.scene[sc].osc[o];
+            auto &slot = slots[sc][o];
+
+            bool queued = osc.wt.queue_id != -1 || !osc.wt.queue_filename.empty();
+
+            if (!queued && !slot.hasResult)
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> l(slot.m, std::try_to_lock);
+
+            if (!l.owns_lock())
+            {
+                continue;
+            }
+
+            if (queued)
+            {
+                request(slot, osc);
+                requested = true;
+            }
+
+            if (slot.result && slot.resultSerial == slot.serial && install(slot, osc))
+            {
+                slot.hasResult = false;
+            }
+        }
+    }
+
+    if (requested)
+    {
+        // A lost wakeup just means the loader notices on its timeout
+        pending = true;
+        cv.notify_one();
+    }
+}
+
+void WavetableLoader::request(Slot &slot, OscillatorStorage &osc)
+{
+    slot.requested = true;
+    slot.serial++;
+
+    // Swapping rather than copying the name means nothing allocates here
+    std::swap(slot.filename, osc.wt.queue_filename);
+    osc.wt.queue_filename.clear();
+
+    if (osc.wt.queue_id != -1)
+    {
+        slot.id = osc.wt.queue_id;
+        osc.wt.queue_id = -1;
+    }
+    else
+    {
+        slot.id = -1;
+
+        if (!uses_wavetabledata(osc.type.val.i))
+        {
+            osc.queue_type = ot_wavetable;
+        }
+    }
+}
+
+bool WavetableLoader::install(Slot &slot, OscillatorStorage &osc)
+{
+    // Whatever we swap out is freed on the loader thread, so wait until it's done the last one
+    if (slot.retired)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> l(storage->waveTableDataMutex, std::try_to_lock);
+
+    if (!l.owns_lock())
+    {
+        return false;
+    }
+
+    auto &built = *slot.result;
+    bool fromFile = slot.resultFromFile;
+    bool wasBuilt = osc.wt.everBuilt;
+
+    if (built.wt.everBuilt)
+    {
+        osc.wt.Swap(built.wt);
+        std::swap(osc.wavetable_display_name, built.wavetable_display_name);
+        std::swap(osc.wavetable_formula, built.wavetable_formula);
+        std::swap(osc.wavetable_formula_res_base, built.wavetable_formula_res_base);
+        std::swap(osc.wavetable_formula_nframes, built.wavetable_formula_nframes);
+    }
+    else
+    {
+        // the load failed, which leaves the old table playing, as it always has
+        osc.wt.current_id = built.wt.current_id;
+    }
+
+    osc.wt.is_dnd_imported = fromFile;
+    osc.wt.refresh_display = true;
+
+    if (fromFile ? osc.wt.everBuilt : wasBuilt)
+    {
+        storage->getPatch().isDirty = true;
+    }
+
+    slot.retired = std::move(slot.result);
+
+    return true;
+}
+
+void WavetableLoader::cancel(int scene, int osc)
+{
+    auto &slot = slots[scene][osc];
+    std::unique_ptr<OscillatorStorage> dropped;
+
+    {
+        std::lock_guard<std::mutex> g(slot.m);
+        slot.serial++;
+        slot.requested = false;
+        slot.hasResult = false;
+        dropped = std::move(slot.result);
+    }
+}
+
+void WavetableLoader::run()
+{
+    using namespace std::chrono_literals;
+
+    while (!quitting)
+    {
+        pending = false;
+
+        for (int sc = 0; sc < n_scenes && !quitting; sc++)
+        {
+            for (int o = 0; o < n_oscs && !quitting; o++)
+            {
+                auto &slot = slots[sc][o];
+
+                std::unique_ptr<OscillatorStorage> retired;
+                bool requested = false;
+                int id = -1;
+                std::string filename;
+                uint64_t serial = 0;
+
+                {
+                    std::lock_guard<std::mutex> g(slot.m);
+                    retired = std::move(slot.retired);
+
+                    if (slot.requested)
+                    {
+                        requested = true;
+                        slot.requested = false;
+                        id = slot.id;
+                        filename = std::move(slot.filename);
+                        slot.filename.clear();
+                        serial = slot.serial;
+                    }
+                }
+
+                // This is the point of the retired slot, the old table gets freed here
+                retired.reset();
+
+                if (!requested)
+                {
+                    continue;
+                }
+
+                auto built = std::make_unique<OscillatorStorage>();
+
+                if (id != -1)
+                {
+                    storage->load_wt(id, &built->wt, built.get());
+                }
+                else
+                {
+                    int wtidx = -1, ct = 0;
+                    for (const auto &wti : storage->wt_list)
+                    {
+                        if (path_to_string(wti.path) == filename)
+                        {
+                            wtidx = ct;
+                        }
+                        ct++;
+                    }
+
+                    built->wt.current_id = wtidx;
+                    built->wt.queue_filename = filename;
+                    storage->load_wt(filename, &built->wt, built.get());
+                }
+
+                std::lock_guard<std::mutex> g(slot.m);
+
+                // if it was queued again or cancelled meanwhile, this one is just dropped
+                if (serial == slot.serial)
+                {
+                    slot.result = std::move(built);
+                    slot.resultSerial = serial;
+                    slot.resultFromFile = (id == -1);
+                    slot.hasResult = true;
+                }
+            }
+        }
+
+        std::unique_lock<std::mutex> l(m);
+        cv.wait_for(l, 10ms, [this]() { return quitting || pending; });
+    }
+}
+} // namespace Storage
+} // namespace Surge
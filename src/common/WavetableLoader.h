@@ -0,0 +1,94 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_WAVETABLELOADER_H
+#define SURGE_SRC_COMMON_WAVETABLELOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * Services the wavetable queue (queue_id and queue_filename) off the audio thread. service()
+ * runs at the top of a block: it hands newly queued loads to a loader thread, which reads and
+ * builds each one into a scratch OscillatorStorage, and swaps any finished ones into their
+ * oscillator. So the audio thread never waits on the disk or the mip-mapper, a wavetable change
+ * lands on a block boundary, and whatever it replaced is freed back on the loader thread.
+ *
+ * A slot queued again before its previous load lands only ever shows the newest one.
+ */
+struct WavetableLoader
+{
+    explicit WavetableLoader(SurgeStorage *storage);
+    ~WavetableLoader();
+
+    // Audio thread. Never blocks; anything it can't do now waits for the next block.
+    void service();
+
+    // The slot is about to be loaded synchronously, so drop anything in flight for it
+    void cancel(int scene, int osc);
+
+  private:
+    struct Slot
+    {
+        // The audio thread only ever try_locks this
+        std::mutex m;
+
+        bool requested{false};
+        int id{-1};
+        std::string filename;
+        uint64_t serial{0};
+
+        std::unique_ptr<OscillatorStorage> result;
+        uint64_t resultSerial{0};
+        bool resultFromFile{false};
+        std::atomic<bool> hasResult{false};
+
+        std::unique_ptr<OscillatorStorage> retired;
+    };
+
+    void request(Slot &slot, OscillatorStorage &osc);
+    bool install(Slot &slot, OscillatorStorage &osc);
+    void run();
+
+    SurgeStorage *storage;
+    Slot slots[n_scenes][n_oscs];
+
+    std::atomic<bool> quitting{false}, pending{false};
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread thread;
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_WAVETABLELOADER_H
@@ -0,0 +1,255 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "EffectHandoff.h"
+
+#include <cstring>
+#include <thread>
+
+#include "Effect.h"
+
+namespace Surge
+{
+namespace FX
+{
+bool EffectHandoff::ready() const
+{
+    // A dropped offer stays ours until the audio thread says it has let go of it, and the effect
+    // it was for may run until the replacement is taken
+    auto ss = swapSt.load(std::memory_order_acquire);
+
+    return st.load(std::memory_order_acquire) == kIdle && !incomingDropped &&
+           (ss == kSwapIdle || ss == kSwapTaken);
+}
+
+bool EffectHandoff::offer(std::shared_ptr<Effect> e, int blocks)
+{
+    if (!ready())
+    {
+        return false;
+    }
+
+    prime(e.get());
+
+    incoming = std::move(e);
+    crossfadeBlocks = blocks;
+    st.store(kOffered, std::memory_order_release);
+
+    return true;
+}
+
+bool EffectHandoff::commit()
+{
+    if (st.load(std::memory_order_acquire) != kRetired || incomingDropped)
+    {
+        return false;
+    }
+
+    // The audio thread is done with the old effect, so this is where it gets freed
+    current = std::move(incoming);
+    st.store(kIdle, std::memory_order_release);
+
+    return true;
+}
+
+void EffectHandoff::replace(std::shared_ptr<Effect> e)
+{
+    prime(e.get());
+
+    int s = kOffered;
+
+    if (st.compare_exchange_strong(s, kIdle, std::memory_order_acq_rel))
+    {
+        incoming.reset();
+    }
+    else if (s != kIdle)
+    {
+        // The audio thread has taken the offer. It drops its reference, and collect() ours.
+        incomingDropped = true;
+        dropIncoming.store(true, std::memory_order_release);
+    }
+
+    int ss = swapSt.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        if (ss == kSwapTaking)
+        {
+            // the audio thread is in the middle of a couple of pointer swaps
+            std::this_thread::yield();
+            ss = swapSt.load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (ss == kSwapOffered &&
+            !swapSt.compare_exchange_weak(ss, kSwapIdle, std::memory_order_acq_rel))
+        {
+            continue;
+        }
+
+        break;
+    }
+
+    if (ss != kSwapOffered)
+    {
+        // The audio thread is running current, so hold on to it until it has swapped it out
+        outgoing = std::move(current);
+    }
+
+    // Otherwise we just withdrew current before the audio thread ever saw it, and outgoing
+    // already holds what it is running. Either way swap may hold something the audio thread gave
+    // back, which is freed here.
+    current = std::move(e);
+    swap = current;
+    swapSt.store(kSwapOffered, std::memory_order_release);
+}
+
+void EffectHandoff::collect()
+{
+    int ss = kSwapTaken;
+
+    if (swapSt.compare_exchange_strong(ss, kSwapIdle, std::memory_order_acq_rel))
+    {
+        swap.reset();
+        outgoing.reset();
+    }
+
+    if (incomingDropped && !dropIncoming.load(std::memory_order_acquire))
+    {
+        incoming.reset();
+        incomingDropped = false;
+
+        int s = kRetired;
+        st.compare_exchange_strong(s, kIdle, std::memory_order_acq_rel);
+    }
+}
+
+void EffectHandoff::prime(Effect *e)
+{
+    if (!e)
+    {
+        return;
+    }
+
+    float dataL alignas(16)[BLOCK_SIZE], dataR alignas(16)[BLOCK_SIZE];
+    memset(dataL, 0, sizeof(dataL));
+    memset(dataR, 0, sizeof(dataR));
+    e->process(dataL, dataR);
+}
+
+bool EffectHandoff::beginBlock()
+{
+    bool notify = false;
+
+    // Take the replacement first; anything dropped before it was offered is then visible below
+    int ss = kSwapOffered;
+    bool swapping = swapSt.compare_exchange_strong(ss, kSwapTaking, std::memory_order_acquire,
+                                                   std::memory_order_relaxed);
+
+    if (dropIncoming.load(std::memory_order_acquire))
+    {
+        if (st.load(std::memory_order_relaxed) == kCrossfading)
+        {
+            audioIncoming.reset();
+            st.store(kIdle, std::memory_order_release);
+        }
+
+        dropIncoming.store(false, std::memory_order_release);
+        notify = true;
+    }
+
+    if (swapping)
+    {
+        audio.swap(swap);
+        swapSt.store(kSwapTaken, std::memory_order_release);
+        notify = true;
+    }
+
+    int s = kOffered;
+
+    if (st.compare_exchange_strong(s, kCrossfading, std::memory_order_acq_rel))
+    {
+        audioIncoming = incoming;
+        crossfadeBlock = 0;
+
+        if (crossfadeBlocks <= 0)
+        {
+            // the building side still holds what we were running
+            audio = std::move(audioIncoming);
+            st.store(kRetired, std::memory_order_release);
+            notify = true;
+        }
+    }
+
+    return notify;
+}
+
+bool EffectHandoff::process(float *dataL, float *dataR)
+{
+    if (st.load(std::memory_order_relaxed) != kCrossfading)
+    {
+        if (audio)
+        {
+            audio->process_ringout(dataL, dataR, true);
+        }
+
+        return false;
+    }
+
+    // Either side of the crossfade may be an empty slot, which passes audio through
+    float newL alignas(16)[BLOCK_SIZE], newR alignas(16)[BLOCK_SIZE];
+    memcpy(newL, dataL, BLOCK_SIZE * sizeof(float));
+    memcpy(newR, dataR, BLOCK_SIZE * sizeof(float));
+
+    if (audio)
+    {
+        audio->process_ringout(dataL, dataR, true);
+    }
+
+    if (audioIncoming)
+    {
+        audioIncoming->process_ringout(newL, newR, true);
+    }
+
+    const float dg = 1.f / (crossfadeBlocks * BLOCK_SIZE);
+    float g = crossfadeBlock * BLOCK_SIZE * dg;
+
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+    {
+        dataL[i] += g * (newL[i] - dataL[i]);
+        dataR[i] += g * (newR[i] - dataR[i]);
+        g += dg;
+    }
+
+    if (++crossfadeBlock >= crossfadeBlocks)
+    {
+        // current, or outgoing if it has been replaced since, still holds the old effect
+        audio = std::move(audioIncoming);
+        st.store(kRetired, std::memory_order_release);
+
+        return true;
+    }
+
+    return false;
+}
+} // namespace FX
+} // namespace Surge
@@ -0,0 +1,122 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_DSP_EFFECTHANDOFF_H
+#define SURGE_SRC_COMMON_DSP_EFFECTHANDOFF_H
+
+#include <atomic>
+#include <memory>
+
+class Effect;
+
+namespace Surge
+{
+namespace FX
+{
+/*
+ * Passes the effect running in one slot between the thread which builds effects (the message
+ * thread, say) and the audio thread, so that the audio thread never spawns, initializes or frees
+ * one. Each side only ever touches its own references; effects cross over through an atomic
+ * state, stored with release and loaded with acquire, and the building side always keeps a
+ * reference to anything the audio thread might let go of, so the last reference is dropped on the
+ * building side.
+ *
+ * An effect can be offered to crossfade in over a number of blocks (none for a straight switch),
+ * or can replace whatever is running at the start of the next block. After an offer has been taken
+ * and the crossfade is done the handoff is retired until commit() adopts the incoming effect.
+ * An empty effect is a slot which passes audio through. Some effects (Airwindows) set themselves
+ * up on their first block, so offer() and replace() run a silent one through the effect first.
+ */
+struct EffectHandoff
+{
+    enum State
+    {
+        kIdle,
+        kOffered,     // the incoming effect is built and waiting for the audio thread
+        kCrossfading, // the audio thread is running both effects
+        kRetired      // the audio thread is done with the old effect
+    };
+
+    // Building side. The effect the slot has committed to.
+    std::shared_ptr<Effect> current;
+
+    /*
+     * Whether an offer would be taken: idle, and the audio thread has caught up with any
+     * replacement, so it no longer runs anything which was dropped from an offer.
+     */
+    bool ready() const;
+
+    // Offers e, fading it in over crossfadeBlocks blocks. Only when ready, which it says.
+    bool offer(std::shared_ptr<Effect> e, int crossfadeBlocks);
+
+    // Makes the offered effect current once retired, which it says whether it did
+    bool commit();
+
+    /*
+     * Makes e current and has the audio thread run it from its next block, dropping any offer
+     * on the way.
+     */
+    void replace(std::shared_ptr<Effect> e);
+
+    // Frees whatever the audio thread has given back. Call it now and then.
+    void collect();
+
+    State state() const { return (State)st.load(std::memory_order_acquire); }
+
+    // Audio thread. Picks up replacements and offers; says if the building side should collect.
+    bool beginBlock();
+
+    // Audio thread. Runs a block in place; says if that retired the handoff.
+    bool process(float *dataL, float *dataR);
+
+    // Audio thread. What it is running, or fading out from.
+    Effect *audioEffect() const { return audio.get(); }
+
+  private:
+    enum SwapState
+    {
+        kSwapIdle,
+        kSwapOffered, // swap holds the replacement
+        kSwapTaking,  // the audio thread is exchanging it for what it was running
+        kSwapTaken    // swap holds what the audio thread was running
+    };
+
+    static void prime(Effect *e);
+
+    // building side; outgoing is what the audio thread runs until it takes a replacement
+    std::shared_ptr<Effect> incoming, outgoing;
+    bool incomingDropped{false};
+
+    // audio thread
+    std::shared_ptr<Effect> audio, audioIncoming;
+    int crossfadeBlock{0};
+
+    // crosses over
+    std::shared_ptr<Effect> swap;
+    int crossfadeBlocks{0};
+    std::atomic<int> st{kIdle}, swapSt{kSwapIdle};
+    std::atomic<bool> dropIncoming{false};
+};
+} // namespace FX
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_DSP_EFFECTHANDOFF_H
@@ -21,10 +21,12 @@
  */
 
 #include "SurgeVoice.h"
+#include "SineOscillator.h"
 #include "UserDefaults.h"
 #include "DSPUtils.h"
 #include "QuadFilterChain.h"
 #include "globals.h"
+#include <algorithm>
 #include <cmath>
 #ifndef SURGE_SKIP_ODDSOUND_MTS
 #include "libMTSClient.h"
@@ -507,9 +509,9 @@ void SurgeVoice::switch_toggled()
     /*
      * Since we have updated the keytrack output here we need to re-update the localcopy modulators
      */
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto &routing = storage->audioModulationRouting();
+    auto iter = routing.voice[state.scene_id].begin();
+    while (iter != routing.voice[state.scene_id].end())
     {
         int src_id = iter->source_id;
         int dst_id = iter->destination_id;
@@ -1022,18 +1024,132 @@ inline void all_ring_modes_block(float *__restrict src1_l, float *__restrict src
     }
 }
 
+bool SurgeVoice::canBatchOscillator(int i) const
+{
+    if (!osc[i] || osctype[i] != ot_sine)
+    {
+        return false;
+    }
+
+    // only oscillators which render and aren't frequency modulated, see renderBlock
+    bool renders = false;
+
+    switch (i)
+    {
+    case 0:
+        renders = (osc1 || ring12) && !FMmode;
+        break;
+    case 1:
+        renders = (osc2 || ring12 || ring23 || (FMmode && osc1)) && FMmode != fm_3to2to1;
+        break;
+    case 2:
+        renders = osc3 || ring23 || ((osc1 || osc2 || ring12) && (FMmode == fm_3to2to1)) ||
+                  ((osc1 || ring12) && (FMmode == fm_2and3to1));
+        break;
+    }
+
+    return renders && static_cast<SineOscillator *>(osc[i])->canRenderBatched();
+}
+
+bool SurgeVoice::planBatchedOscillators(SurgeVoice *const *voices, int n)
+{
+    bool anyBatched = false;
+
+    for (int i = 0; i < n_oscs; ++i)
+    {
+        int shapeCount[SineOscillator::n_shapes]{};
+
+        for (int v = 0; v < n; ++v)
+        {
+            voices[v]->oscBatched[i] = voices[v]->canBatchOscillator(i);
+
+            if (voices[v]->oscBatched[i])
+            {
+                shapeCount[static_cast<SineOscillator *>(voices[v]->osc[i])->shapeMode()]++;
+            }
+        }
+
+        // a batch of one is just the regular path with extra steps
+        for (int v = 0; v < n; ++v)
+        {
+            if (voices[v]->oscBatched[i] &&
+                shapeCount[static_cast<SineOscillator *>(voices[v]->osc[i])->shapeMode()] < 2)
+            {
+                voices[v]->oscBatched[i] = false;
+            }
+
+            anyBatched = anyBatched || voices[v]->oscBatched[i];
+        }
+    }
+
+    return anyBatched;
+}
+
+void SurgeVoice::renderBatchedOscillators(SurgeVoice *const *voices, int n)
+{
+    constexpr int maxBatch = SineOscillator::maxBatch;
+
+    SineOscillator *oscs[maxBatch];
+    float pitch[maxBatch], drift[maxBatch];
+
+    // all the voices belong to one scene
+    bool is_wide = voices[0]->scene->filterblock_configuration.val.i == fc_wide;
+
+    // same slot order as renderBlock
+    for (int i = n_oscs - 1; i >= 0; --i)
+    {
+        for (int shape = 0; shape < SineOscillator::n_shapes; ++shape)
+        {
+            int batched = 0;
+
+            for (int v = 0; v < n; ++v)
+            {
+                auto voice = voices[v];
+
+                if (!voice->oscBatched[i] ||
+                    static_cast<SineOscillator *>(voice->osc[i])->shapeMode() != shape)
+                {
+                    continue;
+                }
+
+                // this mysterious override is duplicated in renderBlock and the ->init calls
+                float ktrkroot = 60;
+                auto &sosc = voice->scene->osc[i];
+
+                oscs[batched] = static_cast<SineOscillator *>(voice->osc[i]);
+                pitch[batched] = voice->noteShiftFromPitchParam(
+                    (sosc.keytrack.val.b ? voice->state.pitch
+                                         : ktrkroot + voice->state.scenepbpitch) +
+                        voice->octaveSize * sosc.octave.val.i,
+                    i);
+                drift[batched] = voice->localcopy[voice->scene->drift.param_id_in_scene].f;
+                batched++;
+
+                if (batched == maxBatch)
+                {
+                    SineOscillator::process_block_batched(oscs, pitch, drift, batched, is_wide);
+                    batched = 0;
+                }
+            }
+
+            if (batched)
+            {
+                SineOscillator::process_block_batched(oscs, pitch, drift, batched, is_wide);
+            }
+        }
+    }
+}
+
 bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
 {
-    calc_ctrldata<0>(&Q, Qe);
+    prepareBlock(Q, Qe);
 
-    bool is_wide = scene->filterblock_configuration.val.i == fc_wide;
-    float tblock alignas(16)[BLOCK_SIZE_OS], tblock2 alignas(16)[BLOCK_SIZE_OS];
-    float *tblockR = is_wide ? tblock2 : tblock;
+    return renderBlock(Q, Qe);
+}
 
-    // float ktrkroot = (float)scene->keytrack_root.val.i;
-    // this mysterious override is duplicated in the ->init calls
-    float ktrkroot = 60;
-    float drift = localcopy[scene->drift.param_id_in_scene].f;
+void SurgeVoice::prepareBlock(QuadFilterChainState &Q, int Qe)
+{
+    calc_ctrldata<0>(&Q, Qe);
 
     // clear output
     mech::clear_block<BLOCK_SIZE_OS>(output[0]);
@@ -1046,16 +1162,31 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
             osc[i]->setGate(state.gate);
         }
     }
+}
+
+bool SurgeVoice::renderBlock(QuadFilterChainState &Q, int Qe)
+{
+    bool is_wide = scene->filterblock_configuration.val.i == fc_wide;
+    float tblock alignas(16)[BLOCK_SIZE_OS], tblock2 alignas(16)[BLOCK_SIZE_OS];
+    float *tblockR = is_wide ? tblock2 : tblock;
+
+    // float ktrkroot = (float)scene->keytrack_root.val.i;
+    // this mysterious override is duplicated in the ->init calls
+    float ktrkroot = 60;
+    float drift = localcopy[scene->drift.param_id_in_scene].f;
 
     if (osc3 || ring23 || ((osc1 || osc2 || ring12) && (FMmode == fm_3to2to1)) ||
         ((osc1 || ring12) && (FMmode == fm_2and3to1)))
     {
-        osc[2]->process_block(
-            noteShiftFromPitchParam(
-                (scene->osc[2].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                    octaveSize * scene->osc[2].octave.val.i,
-                2),
-            drift, is_wide);
+        if (!oscBatched[2])
+        {
+            osc[2]->process_block(
+                noteShiftFromPitchParam(
+                    (scene->osc[2].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
+                        octaveSize * scene->osc[2].octave.val.i,
+                    2),
+                drift, is_wide);
+        }
 
         if (osc3)
         {
@@ -1092,7 +1223,7 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
                 drift, is_wide, true,
                 storage->db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f));
         }
-        else
+        else if (!oscBatched[1])
         {
             osc[1]->process_block(
                 noteShiftFromPitchParam(
@@ -1148,7 +1279,7 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
                 drift, is_wide, true,
                 storage->db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f));
         }
-        else
+        else if (!oscBatched[0])
         {
             osc[0]->process_block(
                 noteShiftFromPitchParam(
@@ -1217,17 +1348,24 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     {
         float noisecol = limit_range(localcopy[scene->noise_colour.param_id_in_scene].f, -1.f, 1.f);
         auto is_stereo_noise = scene->noise_colour.deform_type == NoiseColorChannels::STEREO;
+#if STORAGE_USES_INDEPENDENT_RNG
+        // Resolve the scene's generator once per block rather than once per sample
+        auto &rng = storage->currentRngGen();
+        auto noiseValue = [&rng]() { return rng.pm1(rng.g); };
+#else
+        auto noiseValue = [this]() { return storage->rand_pm1(); };
+#endif
         for (int i = 0; i < BLOCK_SIZE_OS; i += 2)
         {
             ((float *)tblock)[i] = sdsp::correlated_noise_o2mk2_supplied_value(
-                noisegenL[0], noisegenL[1], noisecol, storage->rand_pm1());
+                noisegenL[0], noisegenL[1], noisecol, noiseValue());
             ((float *)tblock)[i + 1] = ((float *)tblock)[i];
             if (is_wide)
             {
                 if (is_stereo_noise)
                 {
                     ((float *)tblockR)[i] = sdsp::correlated_noise_o2mk2_supplied_value(
-                        noisegenR[0], noisegenR[1], noisecol, storage->rand_pm1());
+                        noisegenR[0], noisegenR[1], noisecol, noiseValue());
                     ((float *)tblockR)[i + 1] = ((float *)tblockR)[i];
                 }
                 else
@@ -1260,6 +1398,20 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     // pre-filter gain
     osclevels[le_pfg].multiply_2_blocks(output[0], output[1], BLOCK_SIZE_OS_QUAD);
 
+    if (startOffset > 0)
+    {
+        // Push this block back by startOffset, after the tail of the last one
+        auto n = std::min(startOffset * OSC_OVERSAMPLING, BLOCK_SIZE_OS);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            std::copy(output[c], output[c] + BLOCK_SIZE_OS, tblock);
+            std::copy(startCarry[c], startCarry[c] + n, output[c]);
+            std::copy(tblock, tblock + BLOCK_SIZE_OS - n, output[c] + n);
+            std::copy(tblock + BLOCK_SIZE_OS - n, tblock + BLOCK_SIZE_OS, startCarry[c]);
+        }
+    }
+
     for (int i = 0; i < BLOCK_SIZE_OS; i++)
     {
         SIMD_MM(store_ss)(((float *)&Q.DL[i] + Qe), SIMD_MM(load_ss)(&output[0][i]));
@@ -1267,6 +1419,11 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
     }
     SetQFB(&Q, Qe);
 
+    for (auto &b : oscBatched)
+    {
+        b = false;
+    }
+
     age++;
     if (!state.gate)
         age_release++;
@@ -1276,23 +1433,39 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
 
 template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
 {
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto &routing = storage->audioModulationRouting();
+    auto &cr = routing.voiceCompiled[state.scene_id];
+
+    /*
+     * Read each source once. A source we skip reads as zero, which leaves its destinations
+     * alone. Then form all the contributions in one pass, which the compiler can vectorize,
+     * and add them in routing order.
+     */
+    float srcOut[SurgeStorage::ModulationRoutingSnapshot::CompiledVoiceRouting::maxSources];
+    const int nSrc = (int)cr.sourceId.size();
+    for (int i = 0; i < nSrc; ++i)
     {
-        int src_id = iter->source_id;
-        int dst_id = iter->destination_id;
-        float depth = iter->depth;
+        auto ms = modsources[cr.sourceId[i]];
+        if ((noLFOSources && cr.sourceIsLFO[i]) || !ms)
+            srcOut[i] = 0.f;
+        else
+            srcOut[i] = ms->get_output(cr.sourceIndex[i]);
+    }
 
-        if (noLFOSources && isLFO((::modsources)src_id))
-        {
-        }
-        else if (modsources[src_id])
-        {
-            localcopy[dst_id].f +=
-                depth * modsources[src_id]->get_output(iter->source_index) * (1.0 - iter->muted);
-        }
-        iter++;
+    static constexpr int chunk = 64;
+    float contrib alignas(16)[chunk];
+    const int nRoutes = (int)cr.depth.size();
+    const int *slot = cr.sourceSlot.data();
+    const int *dst = cr.destination.data();
+    const float *depth = cr.depth.data();
+
+    for (int base = 0; base < nRoutes; base += chunk)
+    {
+        const int n = std::min(chunk, nRoutes - base);
+        for (int i = 0; i < n; ++i)
+            contrib[i] = depth[base + i] * srcOut[slot[base + i]];
+        for (int i = 0; i < n; ++i)
+            localcopy[dst[base + i]].f += contrib[i];
     }
 
     if (mpeEnabled)
@@ -1300,8 +1473,8 @@ template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
         // See github issue 1214. This basically compensates for
         // channel AT being per-voice in MPE mode (since it is per channel)
         // vs per-scene (since it is per keyboard in non MPE mode).
-        iter = scene->modulation_scene.begin();
-        while (iter != scene->modulation_scene.end())
+        auto iter = routing.scene[state.scene_id].begin();
+        while (iter != routing.scene[state.scene_id].end())
         {
             int src_id = iter->source_id;
             if (src_id == ms_aftertouch && modsources[src_id])
@@ -1414,8 +1587,15 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
                  modsources[ms_ampeg]->get_output(0);
     float FB = scene->feedback.get_extended(localcopy[id_feedback].f);
 
+    // The amp envelope is interpolated at the block edges of the delayed output
+    float GainDelayed = Gain;
+    if (startOffset > 0)
+        GainDelayed = FBP.Gain + (Gain - FBP.Gain) * (1.f - startOffset * BLOCK_SIZE_INV);
+
     if (!Q)
     {
+        FBP.GainDelayed = Gain;
+
         // We need to initialize the waveshaper registers
         for (int c = 0; c < 2; ++c)
             sst::waveshapers::initializeWaveshaperRegister(
@@ -1425,8 +1605,8 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
 
     if (Q)
     {
-        set1f(Q->Gain, e, FBP.Gain);
-        set1f(Q->dGain, e, (Gain - FBP.Gain) * BLOCK_SIZE_OS_INV);
+        set1f(Q->Gain, e, FBP.GainDelayed);
+        set1f(Q->dGain, e, (GainDelayed - FBP.GainDelayed) * BLOCK_SIZE_OS_INV);
         set1f(Q->Drive, e, FBP.Drive);
         set1f(Q->dDrive, e, (Drive - FBP.Drive) * BLOCK_SIZE_OS_INV);
         set1f(Q->FB, e, FBP.FB);
@@ -1447,6 +1627,7 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
     }
 
     FBP.Gain = Gain;
+    FBP.GainDelayed = GainDelayed;
     FBP.Drive = Drive;
     FBP.FB = FB;
     FBP.Mix1 = FMix1;
@@ -58,6 +58,20 @@ class alignas(16) SurgeVoice
 
     void sampleRateReset();
     bool process_block(QuadFilterChainState &, int);
+
+    /*
+     * A sine oscillator leaves SIMD lanes idle unless its unison count is a multiple of four,
+     * so when several voices in a scene play one in the same slot, we render that slot for up
+     * to four voices at once with their unison voices packed together. If planBatchedOscillators returns false there's nothing to batch and
+     * process_block is used as usual. Otherwise, call prepareBlock on every voice, then
+     * renderBatchedOscillators, then renderBlock on every voice, all with the same voice order.
+     */
+    static bool planBatchedOscillators(SurgeVoice *const *voices, int n);
+    static void renderBatchedOscillators(SurgeVoice *const *voices, int n);
+    void prepareBlock(QuadFilterChainState &, int);
+    bool renderBlock(QuadFilterChainState &, int);
+    bool canBatchOscillator(int i) const;
+    bool oscBatched[n_oscs]{};
     void GetQFB(); // Get the updated registers from the QuadFB
     void legato(int key, int velocity, char detune);
     void switch_toggled();
@@ -65,6 +79,13 @@ class alignas(16) SurgeVoice
     int osctype[n_oscs];
     SurgeVoiceState state;
     int age, age_release;
+    /*
+     * Samples into its first block where the voice starts. The voice still renders from the
+     * block start, and renderBlock delays everything it renders by this much for the rest of
+     * its life, carrying the tail of each block over to the next in startCarry.
+     */
+    int startOffset{0};
+    float startCarry alignas(16)[2][BLOCK_SIZE_OS]{};
 
     bool matchesChannelKeyId(int16_t channel, int16_t key, int32_t host_noteid);
 
@@ -245,6 +266,7 @@ class alignas(16) SurgeVoice
     struct
     {
         float Gain, FB, Mix1, Mix2, OutL, OutR, Out2L, Out2R, Drive, wsLPF, FBlineL, FBlineR;
+        float GainDelayed; // Gain as seen startOffset samples later
         float Delay[4][sst::filters::utilities::MAX_FB_COMB +
                        sst::filters::utilities::SincTable::FIRipol_N];
         struct
@@ -21,11 +21,17 @@
  */
 #include "Wavetable.h"
 #include <assert.h>
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include "DSPUtils.h"
 #include <vembertech/basic_dsp.h>
 #include "SurgeStorage.h"
+#include "RenderWorkerPool.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
+#include "sst/basic-blocks/mechanics/simd-ops.h"
 namespace mech = sst::basic_blocks::mechanics;
 
 #if WINDOWS
@@ -97,13 +103,89 @@ int GetWTIndex(int WaveIdx, int WaveSize, int NumWaves, int MipMap, int Padding
     return Index;
 }
 
-Wavetable::Wavetable()
+int MipMapLevels(int size)
+{
+    int levels = 1;
+    while (((1 << levels) < size) & (levels < max_mipmap_levels))
+        levels++;
+    return levels;
+}
+
+namespace
+{
+/*
+ * Built wavetable data keyed by a hash of the data it was built from. The entries are weak, so a
+ * table lives as long as some Wavetable is using it, and a hit is compared against the source
+ * before it is used, so a hash collision just means building another copy.
+ */
+struct WavetableCache
+{
+    std::mutex mutex;
+    std::unordered_map<size_t, std::weak_ptr<WavetableData>> tables;
+};
+
+WavetableCache &wavetableCache()
+{
+    static WavetableCache cache;
+    return cache;
+}
+
+bool SourceMatches(const WavetableData &d, void *wdata, int wdata_tables)
 {
-    dataSizes = 35000;
+    for (int j = 0; j < wdata_tables; j++)
+    {
+        if (d.flags & wtf_int16)
+        {
+            auto src = &((short *)wdata)[d.size * j];
+            auto dst = d.TableI16Data + GetWTIndex(j, d.size, d.n_tables, 0, FIRipolI16_N) +
+                       FIRoffsetI16;
+
+            for (int i = 0; i < d.size; i++)
+            {
+                if ((short)mech::endian_read_int16LE(src[i]) != dst[i])
+                    return false;
+            }
+        }
+        else
+        {
+            auto src = &((int32_t *)wdata)[d.size * j];
+            auto dst = d.TableF32Data + GetWTIndex(j, d.size, d.n_tables, 0);
+
+            for (int i = 0; i < d.size; i++)
+            {
+                int32_t built;
+                memcpy(&built, &dst[i], sizeof(built));
+                if ((int32_t)mech::endian_read_int32LE(src[i]) != built)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+WavetableData::WavetableData(size_t newSize)
+{
+    dataSizes = newSize;
     TableF32Data = (float *)malloc(dataSizes * sizeof(float));
     TableI16Data = (short *)malloc(dataSizes * sizeof(short));
     memset(TableF32Data, 0, dataSizes * sizeof(float));
     memset(TableI16Data, 0, dataSizes * sizeof(short));
+}
+
+WavetableData::~WavetableData()
+{
+    free(TableF32Data);
+    free(TableI16Data);
+}
+
+Wavetable::Wavetable()
+{
+    // Nothing reads the data of a wavetable which was never built, so they can all share this
+    static auto unbuilt = std::make_shared<WavetableData>(35000);
+
+    adoptData(unbuilt);
     memset(TableF32WeakPointers, 0, sizeof(TableF32WeakPointers));
     memset(TableI16WeakPointers, 0, sizeof(TableI16WeakPointers));
     current_id = -1;
@@ -112,21 +194,19 @@ Wavetable::Wavetable()
     refresh_display = true; // I have never been drawn so assume I need refresh if asked
 }
 
-Wavetable::~Wavetable()
+Wavetable::~Wavetable() {}
+
+void Wavetable::adoptData(std::shared_ptr<WavetableData> d)
 {
-    free(TableF32Data);
-    free(TableI16Data);
+    data = std::move(d);
+    dataSizes = data->dataSizes;
+    TableF32Data = data->TableF32Data;
+    TableI16Data = data->TableI16Data;
 }
 
 void Wavetable::allocPointers(size_t newSize)
 {
-    free(TableF32Data);
-    free(TableI16Data);
-    dataSizes = newSize;
-    TableF32Data = (float *)malloc(dataSizes * sizeof(float));
-    TableI16Data = (short *)malloc(dataSizes * sizeof(short));
-    memset(TableF32Data, 0, dataSizes * sizeof(float));
-    memset(TableI16Data, 0, dataSizes * sizeof(short));
+    adoptData(std::make_shared<WavetableData>(newSize));
 }
 
 void Wavetable::Copy(Wavetable *wt)
@@ -141,37 +221,70 @@ void Wavetable::Copy(Wavetable *wt)
     queue_id = -1;
     everBuilt = wt->everBuilt;
 
-    if (dataSizes < wt->dataSizes)
+    // built data is never written again, so a copy can simply share it
+    adoptData(wt->data);
+    memcpy(TableF32WeakPointers, wt->TableF32WeakPointers, sizeof(TableF32WeakPointers));
+    memcpy(TableI16WeakPointers, wt->TableI16WeakPointers, sizeof(TableI16WeakPointers));
+
+    current_id = wt->current_id;
+}
+
+void Wavetable::Swap(Wavetable &other)
+{
+    std::swap(size, other.size);
+    std::swap(size_po2, other.size_po2);
+    std::swap(flags, other.flags);
+    std::swap(dt, other.dt);
+    std::swap(n_tables, other.n_tables);
+    std::swap(everBuilt, other.everBuilt);
+
+    std::swap(data, other.data);
+    std::swap(dataSizes, other.dataSizes);
+    std::swap(TableF32Data, other.TableF32Data);
+    std::swap(TableI16Data, other.TableI16Data);
+    std::swap(TableF32WeakPointers, other.TableF32WeakPointers);
+    std::swap(TableI16WeakPointers, other.TableI16WeakPointers);
+
+    std::swap(current_id, other.current_id);
+    std::swap(current_filename, other.current_filename);
+}
+
+void Wavetable::setupPointers()
+{
+    memset(TableF32WeakPointers, 0, sizeof(TableF32WeakPointers));
+    memset(TableI16WeakPointers, 0, sizeof(TableI16WeakPointers));
+
+    for (int j = 0; j < this->n_tables; j++)
     {
-        allocPointers(wt->dataSizes);
+        TableF32WeakPointers[0][j] = TableF32Data + GetWTIndex(j, size, n_tables, 0);
+        // + padding for a non-wrapping interpolator
+        TableI16WeakPointers[0][j] = TableI16Data + GetWTIndex(j, size, n_tables, 0, FIRipolI16_N);
     }
 
-    memcpy(TableF32Data, wt->TableF32Data, dataSizes * sizeof(float));
-    memcpy(TableI16Data, wt->TableI16Data, dataSizes * sizeof(short));
-
-    for (int i = 0; i < max_mipmap_levels; i++)
+    for (int j = this->n_tables; j < min_F32_tables; j++)
     {
-        for (int j = 0; j < max_subtables; j++)
-        {
-            if (wt->TableF32WeakPointers[i][j])
-            {
-                size_t Offset = wt->TableF32WeakPointers[i][j] - wt->TableF32Data;
-                TableF32WeakPointers[i][j] = TableF32Data + Offset;
-            }
-            else
-                TableF32WeakPointers[i][j] = NULL;
+        unsigned int s = this->size;
+        int l = 0;
 
-            if (wt->TableI16WeakPointers[i][j])
-            {
-                size_t Offset = wt->TableI16WeakPointers[i][j] - wt->TableI16Data;
-                TableI16WeakPointers[i][j] = TableI16Data + Offset;
-            }
-            else
-                TableI16WeakPointers[i][j] = NULL;
+        while (s && (l < max_mipmap_levels))
+        {
+            TableF32WeakPointers[l][j] = TableF32Data + GetWTIndex(j, size, n_tables, l);
+            s = s >> 1;
+            l++;
         }
     }
 
-    current_id = wt->current_id;
+    int levels = MipMapLevels(size);
+
+    for (int l = 1; l < levels; l++)
+    {
+        for (int s = 0; s < this->n_tables; s++)
+        {
+            TableF32WeakPointers[l][s] = TableF32Data + GetWTIndex(s, size, n_tables, l);
+            TableI16WeakPointers[l][s] =
+                TableI16Data + GetWTIndex(s, size, n_tables, l, FIRipolI16_N);
+        }
+    }
 }
 
 bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
@@ -184,13 +297,13 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 
     size_t req_size = RequiredWTSize(size, n_tables);
 
-    if (req_size > dataSizes)
-    {
-        allocPointers(req_size);
-    }
-
     int wdata_tables = n_tables;
 
+    auto sourceBytes =
+        (size_t)size * wdata_tables * ((flags & wtf_int16) ? sizeof(short) : sizeof(float));
+    auto sourceHash =
+        std::hash<std::string_view>{}(std::string_view((const char *)wdata, sourceBytes));
+
     if (AppendSilence)
     {
         n_tables += 3; // this "3" should match the "3" in RequiredWTSize
@@ -208,23 +321,50 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 
     dt = 1.0f / size;
 
-    for (int i = 0; i < max_mipmap_levels; i++)
+    auto &cache = wavetableCache();
+
     {
-        for (int j = 0; j < max_subtables; j++)
+        std::lock_guard<std::mutex> g(cache.mutex);
+
+        auto hit = cache.tables.find(sourceHash);
+
+        if (hit != cache.tables.end())
         {
-            // TODO WARNING: Crashes here with patchbyte!
-            /*free(wt->TableF32WeakPointers[i][j]);
-            free(wt->TableI16WeakPointers[i][j]);
-            wt->TableF32WeakPointers[i][j] = 0;
-            wt->TableI16WeakPointers[i][j] = 0;*/
+            auto built = hit->second.lock();
+
+            if (built && built->size == size && built->n_tables == n_tables &&
+                built->flags == flags && built->appendSilence == AppendSilence &&
+                SourceMatches(*built, wdata, wdata_tables))
+            {
+                adoptData(built);
+                setupPointers();
+
+                everBuilt = true;
+                return true;
+            }
+        }
+
+        /*
+         * If nothing else holds our current data, build over it like we always have rather than
+         * freeing memory which a reader may still be looking at. Otherwise start afresh.
+         */
+        if (data.use_count() == 1 && dataSizes >= req_size)
+        {
+            auto mine = cache.tables.find(data->sourceHash);
+
+            if (mine != cache.tables.end() && mine->second.lock() == data)
+            {
+                cache.tables.erase(mine);
+            }
+        }
+        else
+        {
+            allocPointers(req_size);
         }
     }
-    for (int j = 0; j < this->n_tables; j++)
-    {
-        TableF32WeakPointers[0][j] = TableF32Data + GetWTIndex(j, size, n_tables, 0);
-        // + padding for a non-wrapping interpolator
-        TableI16WeakPointers[0][j] = TableI16Data + GetWTIndex(j, size, n_tables, 0, FIRipolI16_N);
-    }
+
+    setupPointers();
+
     for (int j = this->n_tables; j < min_F32_tables; j++)
     {
         unsigned int s = this->size;
@@ -232,7 +372,6 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 
         while (s && (l < max_mipmap_levels))
         {
-            TableF32WeakPointers[l][j] = TableF32Data + GetWTIndex(j, size, n_tables, l);
             memset(TableF32WeakPointers[l][j], 0, s * sizeof(float));
             s = s >> 1;
             l++;
@@ -285,15 +424,226 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 
     MipMapWT();
 
+    data->sourceHash = sourceHash;
+    data->size = size;
+    data->n_tables = n_tables;
+    data->flags = flags;
+    data->appendSilence = AppendSilence;
+
+    {
+        std::lock_guard<std::mutex> g(cache.mutex);
+
+        for (auto it = cache.tables.begin(); it != cache.tables.end();)
+        {
+            if (it->second.expired())
+                it = cache.tables.erase(it);
+            else
+                ++it;
+        }
+
+        cache.tables[sourceHash] = data;
+    }
+
     everBuilt = true;
     return true;
 }
 
+struct Wavetable::MipMapJob
+{
+    Wavetable *wt;
+    int level, chunks;
+};
+
 void Wavetable::MipMapWT()
 {
-    int levels = 1;
-    while (((1 << levels) < size) & (levels < max_mipmap_levels))
-        levels++;
+    int levels = MipMapLevels(size);
+    int ns = this->n_tables;
+
+    /*
+     * Every subtable of a level can be built independently, but a sample's subtables read their
+     * neighbours in the previous level, so the levels themselves go one after the other. Small
+     * wavetables aren't worth waking threads up for, and if another build has the shared pool
+     * this one runs serially rather than waiting for it.
+     */
+    Surge::Threading::RenderWorkerPool::Lease pool;
+
+    if ((size_t)ns * size >= 64 * 2048)
+    {
+        pool = Surge::Threading::RenderWorkerPool::leaseBackgroundPool();
+    }
+
+    int chunks = pool ? pool->size() + 1 : 1;
+
+    for (int l = 1; l < levels; l++)
+    {
+        MipMapJob job{this, l, chunks};
+
+        for (int w = 1; w < chunks; ++w)
+        {
+            pool->post(w - 1, mipMapChunk, &job, w);
+        }
+
+        mipMapChunk(&job, 0);
+
+        for (int w = 1; w < chunks; ++w)
+        {
+            pool->join(w - 1);
+        }
+    }
+}
+
+void Wavetable::mipMapChunk(void *ctx, int chunk)
+{
+    auto job = static_cast<MipMapJob *>(ctx);
+
+    for (int s = chunk; s < (int)job->wt->n_tables; s += job->chunks)
+    {
+        job->wt->MipMapSubtable(job->level, s);
+    }
+}
+
+void Wavetable::MipMapSubtable(int l, int s)
+{
+    const int filter_size = 63;
+    const int filter_id_of = (filter_size - 1) >> 1;
+
+    int ns = this->n_tables;
+    int psize = size >> (l - 1);
+    int lsize = size >> l;
+    bool isSample = this->flags & wtf_is_sample;
+
+    /*
+     * Output sample i is the sum over the taps a of hrfilter[a] * x[2i + a - 31], so split the
+     * previous level into its even and odd samples, with whatever wraps around (or for a sample,
+     * the neighbouring subtables) laid out on either side. Then every tap reads a contiguous run
+     * of the same phase, and four outputs (eight for int16) are summed per SIMD op, each lane in
+     * the same tap order as the scalar loop in MipMapWTReference.
+     */
+    const int pad = 16, padded = max_wtable_size / 2 + 2 * pad;
+    float evenF alignas(16)[padded], oddF alignas(16)[padded];
+    short evenI alignas(16)[padded], oddI alignas(16)[padded];
+
+    auto prevF = this->TableF32WeakPointers[l - 1];
+    auto prevI = this->TableI16WeakPointers[l - 1];
+
+    auto sourceF = [&](int srcindex) {
+        if (!isSample)
+        {
+            return prevF[s][srcindex & (psize - 1)];
+        }
+
+        int srctable = max(0, s + (srcindex / psize));
+        srcindex = srcindex & (psize - 1);
+        return srctable < ns ? prevF[srctable][srcindex] : 0.f;
+    };
+
+    for (int j = -pad; j < lsize + pad; j++)
+    {
+        evenF[j + pad] = sourceF(2 * j);
+        oddF[j + pad] = sourceF(2 * j + 1);
+
+        if (!isSample)
+        {
+            evenI[j + pad] = prevI[s][((2 * j) & (psize - 1)) + FIRoffsetI16];
+            oddI[j + pad] = prevI[s][((2 * j + 1) & (psize - 1)) + FIRoffsetI16];
+        }
+    }
+
+    auto tapF = [&](int a, int i) {
+        int k = a - filter_id_of;
+        return (k & 1) ? &oddF[pad + i + ((k - 1) >> 1)] : &evenF[pad + i + (k >> 1)];
+    };
+    auto tapI = [&](int a, int i) {
+        int k = a - filter_id_of;
+        return (k & 1) ? &oddI[pad + i + ((k - 1) >> 1)] : &evenI[pad + i + (k >> 1)];
+    };
+
+    float *dstF = this->TableF32WeakPointers[l][s];
+    short *dstI = this->TableI16WeakPointers[l][s];
+
+    int i = 0;
+
+    for (; i + 4 <= lsize; i += 4)
+    {
+        auto acc = SIMD_MM(setzero_ps)();
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            acc = SIMD_MM(add_ps)(acc, SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(hrfilter[a]),
+                                                       SIMD_MM(loadu_ps)(tapF(a, i))));
+        }
+
+        SIMD_MM(storeu_ps)(&dstF[i], acc);
+    }
+
+    for (; i < lsize; i++)
+    {
+        float acc = 0.f;
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            acc += hrfilter[a] * *tapF(a, i);
+        }
+
+        dstF[i] = acc;
+    }
+
+    if (isSample)
+    {
+        // not supported in int16 atm
+        memset(&dstI[FIRoffsetI16], 0, lsize * sizeof(short));
+    }
+    else
+    {
+        i = 0;
+
+        for (; i + 8 <= lsize; i += 8)
+        {
+            auto lo = SIMD_MM(setzero_si128)(), hi = SIMD_MM(setzero_si128)();
+
+            for (int a = 0; a < filter_size; a++)
+            {
+                auto h = SIMD_MM(set1_epi16)((short)HRFilterI16[a]);
+                auto x = SIMD_MM(loadu_si128)((SIMD_M128I *)tapI(a, i));
+
+                // full 32 bit products, from their low and high halves
+                auto pl = SIMD_MM(mullo_epi16)(x, h);
+                auto ph = SIMD_MM(mulhi_epi16)(x, h);
+                lo = SIMD_MM(add_epi32)(lo, SIMD_MM(unpacklo_epi16)(pl, ph));
+                hi = SIMD_MM(add_epi32)(hi, SIMD_MM(unpackhi_epi16)(pl, ph));
+            }
+
+            int ival alignas(16)[8];
+            SIMD_MM(store_si128)((SIMD_M128I *)&ival[0], lo);
+            SIMD_MM(store_si128)((SIMD_M128I *)&ival[4], hi);
+
+            for (int q = 0; q < 8; q++)
+            {
+                dstI[i + q + FIRoffsetI16] = ival[q] >> 16;
+            }
+        }
+
+        for (; i < lsize; i++)
+        {
+            int ival = 0;
+
+            for (int a = 0; a < filter_size; a++)
+            {
+                ival += HRFilterI16[a] * *tapI(a, i);
+            }
+
+            dstI[i + FIRoffsetI16] = ival >> 16;
+        }
+    }
+
+    auto toCopy = std::min(FIRoffsetI16, lsize);
+    memcpy(&dstI[lsize + FIRoffsetI16], &dstI[FIRoffsetI16], toCopy * sizeof(short));
+    memcpy(&dstI[0], &dstI[lsize], toCopy * sizeof(short));
+}
+
+void Wavetable::MipMapWTReference()
+{
+    int levels = MipMapLevels(size);
     int ns = this->n_tables;
 
     const int filter_size = 63;
@@ -306,10 +656,6 @@ void Wavetable::MipMapWT()
 
         for (int s = 0; s < ns; s++)
         {
-            this->TableF32WeakPointers[l][s] = TableF32Data + GetWTIndex(s, size, n_tables, l);
-            this->TableI16WeakPointers[l][s] =
-                TableI16Data + GetWTIndex(s, size, n_tables, l, FIRipolI16_N);
-
             if (this->flags & wtf_is_sample)
             {
                 for (int i = 0; i < lsize; i++)
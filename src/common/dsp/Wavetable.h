@@ -22,6 +22,7 @@
 #ifndef SURGE_SRC_COMMON_DSP_WAVETABLE_H
 #define SURGE_SRC_COMMON_DSP_WAVETABLE_H
 #include <string>
+#include <memory>
 #include <StringOps.h>
 const int max_wtable_size = 4096;
 const int max_subtables = 512;
@@ -39,17 +40,58 @@ struct wt_header
 };
 #pragma pack(pop)
 
+/*
+ * The sample memory behind a Wavetable. Once a wavetable is built its data isn't written again,
+ * so every Wavetable in the process built from identical source data shares one of these, found
+ * through a cache keyed by a hash of that source. Copies share it too.
+ */
+struct WavetableData
+{
+    explicit WavetableData(size_t newSize);
+    ~WavetableData();
+
+    size_t dataSizes;
+    float *TableF32Data;
+    short *TableI16Data;
+
+    // What the data was built from, so a cache hit can be checked and the pointers rebuilt
+    size_t sourceHash{0};
+    int size{0};
+    unsigned int n_tables{0};
+    int flags{0};
+    bool appendSilence{false};
+};
+
 class Wavetable
 {
   public:
     Wavetable();
     ~Wavetable();
     void Copy(Wavetable *wt);
+    // Exchanges the built tables, and which wavetable they are, with another Wavetable without
+    // copying or freeing any sample data. The queue and display state stays where it is.
+    void Swap(Wavetable &other);
     bool BuildWT(void *wdata, wt_header &wh, bool AppendSilence);
     void MipMapWT();
+    // The straightforward one subtable, one sample, one tap at a time version of MipMapWT, which
+    // it has to match. Kept for tests and the load benchmark.
+    void MipMapWTReference();
 
     void allocPointers(size_t newSize);
 
+    // A hash of the samples the tables were built from, or 0 if they never were
+    size_t contentHash() const { return data->sourceHash; }
+
+  private:
+    void adoptData(std::shared_ptr<WavetableData> d);
+    void setupPointers();
+
+    struct MipMapJob;
+    static void mipMapChunk(void *ctx, int chunk);
+    void MipMapSubtable(int level, int subtable);
+
+    std::shared_ptr<WavetableData> data;
+
   public:
     bool everBuilt = false;
     int size;
@@ -36,11 +36,74 @@ namespace Formula
 
 void setupStorage(SurgeStorage *s) { s->formulaGlobalData = std::make_unique<GlobalData>(); }
 
+/*
+ * The state fields valueAt writes and reads back on every call. Each lua state keeps these
+ * names interned in an array in its registry, so valueAt can push a key with an array read and
+ * rawset it with the hash the string already carries, rather than have lua_setfield intern and
+ * hash all the names again for every voice on every block.
+ */
+#define FORMULA_KEYS(X)                                                                            \
+    X(intphase) X(cycle) X(voice_count)                                                            \
+    X(delay) X(decay) X(attack) X(hold) X(sustain) X(release)                                      \
+    X(rate) X(startphase) X(amplitude) X(deform) X(phase) X(tempo) X(songpos)                      \
+    X(pb) X(pb_range_up) X(pb_range_dn) X(chan_at) X(cc_mw) X(cc_breath) X(cc_expr) X(cc_sus)      \
+    X(lowest_key) X(highest_key) X(latest_key)                                                     \
+    X(poly_limit) X(scene_mode) X(play_mode) X(split_point)                                        \
+    X(released) X(is_rendering_to_ui) X(retrigger_AEG) X(retrigger_FEG)                           \
+    X(key) X(velocity) X(rel_velocity) X(channel)                                                  \
+    X(poly_at) X(mpe_bend) X(mpe_bendrange) X(mpe_timbre) X(mpe_pressure)                          \
+    X(is_voice) X(voice_id) X(macros)                                                              \
+    X(output) X(use_envelope) X(clamp_output)
+
+#define FORMULA_KEY_ENUM(k) fk_##k,
+#define FORMULA_KEY_NAME(k) #k,
+
+enum FormulaKey
+{
+    FORMULA_KEYS(FORMULA_KEY_ENUM) n_formula_keys
+};
+
+static const char *formulaKeyNames[n_formula_keys] = {FORMULA_KEYS(FORMULA_KEY_NAME)};
+
+#undef FORMULA_KEY_NAME
+#undef FORMULA_KEY_ENUM
+#undef FORMULA_KEYS
+
+#if HAS_LUA
+static int createFormulaKeys(lua_State *L)
+{
+    lua_createtable(L, n_formula_keys, 0);
+
+    for (int i = 0; i < n_formula_keys; ++i)
+    {
+        lua_pushstring(L, formulaKeyNames[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+#endif
+
+static void releaseStateRef(EvaluatorState &s)
+{
+#if HAS_LUA
+    if (s.L && s.stateRef != LUA_NOREF)
+    {
+        luaL_unref(s.L, LUA_REGISTRYINDEX, s.stateRef);
+    }
+
+    s.stateRef = LUA_NOREF;
+#endif
+}
+
 bool prepareForEvaluation(SurgeStorage *storage, FormulaModulatorStorage *fs, EvaluatorState &s,
                           bool is_display)
 {
     auto &stateData = *storage->formulaGlobalData;
     bool firstTimeThrough = false;
+
+    releaseStateRef(s);
+
     if (!is_display)
     {
         static int aid = 1;
@@ -79,6 +142,7 @@ bool prepareForEvaluation(SurgeStorage *storage, FormulaModulatorStorage *fs, Ev
 #if HAS_LUA
 
     auto lg = Surge::LuaSupport::SGLD("prepareForEvaluation", s.L);
+    auto &keysRef = is_display ? stateData.displayKeysRef : stateData.audioKeysRef;
 
     if (firstTimeThrough)
     {
@@ -86,6 +150,8 @@ bool prepareForEvaluation(SurgeStorage *storage, FormulaModulatorStorage *fs, Ev
         lua_newtable(s.L);
         lua_setglobal(s.L, sharedTableName);
 
+        keysRef = createFormulaKeys(s.L);
+
         // Load the Formula prelude
         Surge::LuaSupport::loadSurgePrelude(s.L, Surge::LuaSources::formula_prelude);
 
@@ -103,6 +169,8 @@ end
         }
     }
 
+    s.keysRef = keysRef;
+
     // OK so now evaluate the formula. This is a mistake - the loading and
     // compiling can be expensive so lets look it up by hash first
     auto h = fs->formulaHash;
@@ -267,6 +335,8 @@ end
         }
 
         // FIXME - we have to clean this up when evaluation is done
+        lua_pushvalue(s.L, -1);
+        s.stateRef = luaL_ref(s.L, LUA_REGISTRYINDEX);
         lua_setglobal(s.L, s.stateName);
 
         // the modulator state which is now bound to the state name
@@ -416,6 +486,8 @@ void removeFunctionsAssociatedWith(SurgeStorage *storage, FormulaModulatorStorag
 
 bool cleanEvaluatorState(EvaluatorState &s)
 {
+    releaseStateRef(s);
+
 #if HAS_LUA
     if (s.L && s.stateName[0] != 0)
     {
@@ -478,104 +550,115 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
         lua_pop(s->L, 1);
         return;
     }
-    lua_getglobal(s->L, s->stateName);
+    lua_rawgeti(s->L, LUA_REGISTRYINDEX, s->stateRef);
+    lua_rawgeti(s->L, LUA_REGISTRYINDEX, s->keysRef);
+
+    // Stack is now func > table > keys so we can update the table
+    auto stateIdx = lua_gettop(s->L) - 1;
+    auto keysIdx = stateIdx + 1;
+
+    auto pushk = [s, keysIdx](FormulaKey k) { lua_rawgeti(s->L, keysIdx, k + 1); };
 
-    auto addn = [s](const char *q, float f) {
+    auto addn = [s, stateIdx, &pushk](FormulaKey k, float f) {
+        pushk(k);
         lua_pushnumber(s->L, f);
-        lua_setfield(s->L, -2, q);
+        lua_rawset(s->L, stateIdx);
     };
 
-    auto addi = [s](const char *q, int i) {
+    auto addi = [s, stateIdx, &pushk](FormulaKey k, int i) {
+        pushk(k);
         lua_pushnumber(s->L, i);
-        lua_setfield(s->L, -2, q);
+        lua_rawset(s->L, stateIdx);
     };
 
-    auto addb = [s](const char *q, bool b) {
+    auto addb = [s, stateIdx, &pushk](FormulaKey k, bool b) {
+        pushk(k);
         lua_pushboolean(s->L, b);
-        lua_setfield(s->L, -2, q);
+        lua_rawset(s->L, stateIdx);
     };
 
-    auto addnil = [s](const char *q) {
+    auto addnil = [s, stateIdx, &pushk](FormulaKey k) {
+        pushk(k);
         lua_pushnil(s->L);
-        lua_setfield(s->L, -2, q);
+        lua_rawset(s->L, stateIdx);
     };
 
-    // Stack is now func > table so we can update the table
-    addi("intphase", phaseIntPart);
-    addi("cycle", phaseIntPart); // Alias cycle for intphase
+    addi(fk_intphase, phaseIntPart);
+    addi(fk_cycle, phaseIntPart); // Alias cycle for intphase
 
     // Fake a voice count of one for display calls
     int voiceCount = storage->activeVoiceCount;
     if (voiceCount == 0 && s->is_display)
         voiceCount = 1;
-    addi("voice_count", voiceCount);
-
-    addn("delay", s->del);
-    addn("decay", s->dec);
-    addn("attack", s->a);
-    addn("hold", s->h);
-    addn("sustain", s->s);
-    addn("release", s->r);
-
-    addn("rate", s->rate);
-    addn("startphase", s->phase);
-    addn("amplitude", s->amp);
-    addn("deform", s->deform);
-
-    addn("phase", phaseFracPart);
-    addn("tempo", s->tempo);
-    addn("songpos", s->songpos);
-
-    addn("pb", s->pitchbend);
-    addn("pb_range_up", s->pbrange_up);
-    addn("pb_range_dn", s->pbrange_dn);
-    addn("chan_at", s->aftertouch);
-    addn("cc_mw", s->modwheel);
-    addn("cc_breath", s->breath);
-    addn("cc_expr", s->expression);
-    addn("cc_sus", s->sustain);
-    addn("lowest_key", s->lowest_key);
-    addn("highest_key", s->highest_key);
-    addn("latest_key", s->latest_key);
-
-    addi("poly_limit", s->polylimit);
-    addi("scene_mode", s->scenemode);
-    addi("play_mode", s->polymode);
-    addi("split_point", s->splitpoint);
-
-    addb("released", s->released);
-    addb("is_rendering_to_ui", s->is_display);
-
-    addnil("retrigger_AEG");
-    addnil("retrigger_FEG");
+    addi(fk_voice_count, voiceCount);
+
+    addn(fk_delay, s->del);
+    addn(fk_decay, s->dec);
+    addn(fk_attack, s->a);
+    addn(fk_hold, s->h);
+    addn(fk_sustain, s->s);
+    addn(fk_release, s->r);
+
+    addn(fk_rate, s->rate);
+    addn(fk_startphase, s->phase);
+    addn(fk_amplitude, s->amp);
+    addn(fk_deform, s->deform);
+
+    addn(fk_phase, phaseFracPart);
+    addn(fk_tempo, s->tempo);
+    addn(fk_songpos, s->songpos);
+
+    addn(fk_pb, s->pitchbend);
+    addn(fk_pb_range_up, s->pbrange_up);
+    addn(fk_pb_range_dn, s->pbrange_dn);
+    addn(fk_chan_at, s->aftertouch);
+    addn(fk_cc_mw, s->modwheel);
+    addn(fk_cc_breath, s->breath);
+    addn(fk_cc_expr, s->expression);
+    addn(fk_cc_sus, s->sustain);
+    addn(fk_lowest_key, s->lowest_key);
+    addn(fk_highest_key, s->highest_key);
+    addn(fk_latest_key, s->latest_key);
+
+    addi(fk_poly_limit, s->polylimit);
+    addi(fk_scene_mode, s->scenemode);
+    addi(fk_play_mode, s->polymode);
+    addi(fk_split_point, s->splitpoint);
+
+    addb(fk_released, s->released);
+    addb(fk_is_rendering_to_ui, s->is_display);
+
+    addnil(fk_retrigger_AEG);
+    addnil(fk_retrigger_FEG);
 
     if (s->isVoice)
     {
-        addi("key", s->key);
-        addi("velocity", s->velocity);
-        addi("rel_velocity", s->releasevelocity);
-        addi("channel", s->channel);
+        addi(fk_key, s->key);
+        addi(fk_velocity, s->velocity);
+        addi(fk_rel_velocity, s->releasevelocity);
+        addi(fk_channel, s->channel);
 
-        addn("poly_at", s->polyat);
-        addn("mpe_bend", s->mpebend);
-        addn("mpe_bendrange", s->mpebendrange);
-        addn("mpe_timbre", s->mpetimbre);
-        addn("mpe_pressure", s->mpepressure);
+        addn(fk_poly_at, s->polyat);
+        addn(fk_mpe_bend, s->mpebend);
+        addn(fk_mpe_bendrange, s->mpebendrange);
+        addn(fk_mpe_timbre, s->mpetimbre);
+        addn(fk_mpe_pressure, s->mpepressure);
 
-        addb("is_voice", s->isVoice);
-        addb("released", s->released);
+        addb(fk_is_voice, s->isVoice);
+        addb(fk_released, s->released);
 
         // LuaJIT has no exposed API for 64-bit int so push this as number
-        addn("voice_id", s->voiceOrderAtCreate);
+        addn(fk_voice_id, s->voiceOrderAtCreate);
     }
     else
     {
-        addb("is_voice", false);
+        addb(fk_is_voice, false);
     }
 
     if (s->subAnyMacro)
     {
         // load the macros
+        pushk(fk_macros);
         lua_createtable(s->L, n_customcontrollers, 0);
         for (int i = 0; i < n_customcontrollers; ++i)
         {
@@ -586,9 +669,12 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
                 lua_settable(s->L, -3);
             }
         }
-        lua_setfield(s->L, -2, "macros");
+        lua_rawset(s->L, stateIdx);
     }
 
+    // leave func > table for the call
+    lua_pop(s->L, 1);
+
     if (justSetup)
     {
         // Don't call but still clear me from the stack
@@ -627,11 +713,29 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
             lua_pop(s->L, 1);
             return;
         }
-        // Store the value and keep it on top of the stack
-        lua_setglobal(s->L, s->stateName);
-        lua_getglobal(s->L, s->stateName);
+        // Store the value if it is a new table, and keep it on top of the stack
+        lua_rawgeti(s->L, LUA_REGISTRYINDEX, s->stateRef);
+        auto sameState = lua_rawequal(s->L, -1, -2);
+        lua_pop(s->L, 1);
+
+        if (!sameState)
+        {
+            lua_pushvalue(s->L, -1);
+            lua_rawseti(s->L, LUA_REGISTRYINDEX, s->stateRef);
+            lua_pushvalue(s->L, -1);
+            lua_setglobal(s->L, s->stateName);
+        }
 
-        lua_getfield(s->L, -1, "output");
+        lua_rawgeti(s->L, LUA_REGISTRYINDEX, s->keysRef);
+        lua_insert(s->L, -2);
+
+        // Stack is now keys > table
+        auto getk = [s](FormulaKey k) {
+            lua_rawgeti(s->L, -2, k + 1);
+            lua_rawget(s->L, -2);
+        };
+
+        getk(fk_output);
         // top of stack is now the result
         float res = 0.0;
         if (lua_isnumber(s->L, -1))
@@ -691,9 +795,9 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
         // pop the result and the function
         lua_pop(s->L, 1);
 
-        auto getBoolDefault = [s](const char *n, bool def) -> bool {
+        auto getBoolDefault = [s, &getk](FormulaKey k, bool def) -> bool {
             auto res = def;
-            lua_getfield(s->L, -1, n);
+            getk(k);
             if (lua_isboolean(s->L, -1))
             {
                 res = lua_toboolean(s->L, -1);
@@ -702,11 +806,11 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
             return res;
         };
 
-        s->useEnvelope = getBoolDefault("use_envelope", true);
-        s->retrigger_AEG = getBoolDefault("retrigger_AEG", false);
-        s->retrigger_FEG = getBoolDefault("retrigger_FEG", false);
+        s->useEnvelope = getBoolDefault(fk_use_envelope, true);
+        s->retrigger_AEG = getBoolDefault(fk_retrigger_AEG, false);
+        s->retrigger_FEG = getBoolDefault(fk_retrigger_FEG, false);
 
-        auto doClamp = getBoolDefault("clamp_output", true);
+        auto doClamp = getBoolDefault(fk_clamp_output, true);
         if (doClamp)
         {
             for (int i = 0; i < 8; ++i)
@@ -715,8 +819,8 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
             }
         }
 
-        // Finally pop the table result
-        lua_pop(s->L, 1);
+        // Finally pop the table result and the keys
+        lua_pop(s->L, 2);
         onerr.replace = false;
         return;
     }
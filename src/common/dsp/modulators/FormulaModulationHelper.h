@@ -36,11 +36,19 @@ namespace Surge
 namespace Formula
 {
 
+// An unset registry ref; LUA_NOREF, which isn't there to use in builds without Lua
+constexpr int noLuaRef = -2;
+#if HAS_LUA
+static_assert(noLuaRef == LUA_NOREF);
+#endif
+
 struct GlobalData
 {
     std::unordered_set<std::string> knownBadFunctions; // these are functions which cause an error
     std::unordered_map<FormulaModulatorStorage *, std::unordered_set<std::string>> functionsPerFMS;
     void *audioState{nullptr}, *displayState{nullptr};
+    // registry refs to each state's interned field names, so valueAt never hashes a C string
+    int audioKeysRef{noLuaRef}, displayKeysRef{noLuaRef};
 };
 
 static constexpr int max_formula_outputs{max_lfo_indices};
@@ -93,6 +101,9 @@ struct EvaluatorState
     int activeoutputs;
 
     lua_State *L{nullptr}; // This is assigned by prepareForEvaluation to be one per thread
+
+    // registry refs to the modulator state table (also the global stateName) and the field names
+    int stateRef{noLuaRef}, keysRef{noLuaRef};
 };
 
 void setupStorage(SurgeStorage *s);
@@ -605,11 +605,9 @@ template <int mode> inline float singleValueFromSinAndCos(float sinx, float cosx
     return v;
 }
 
-template <int mode, bool stereo, bool FM>
-void SineOscillator::process_block_internal(float pitch, float drift, float fmdepth)
+void SineOscillator::unisonOmegas(float pitch, float drift, double *omega)
 {
     double detune;
-    double omega[MAX_UNISON];
 
     for (int l = 0; l < n_unison; l++)
     {
@@ -633,6 +631,13 @@ void SineOscillator::process_block_internal(float pitch, float drift, float fmde
 
         omega[l] = std::min(M_PI, pitch_to_omega(pitch + detune));
     }
+}
+
+template <int mode, bool stereo, bool FM>
+void SineOscillator::process_block_internal(float pitch, float drift, float fmdepth)
+{
+    double omega[MAX_UNISON];
+    unisonOmegas(pitch, drift, omega);
 
     float fv = 32.0 * M_PI * fmdepth * fmdepth * fmdepth;
 
@@ -765,6 +770,164 @@ void SineOscillator::process_block_internal(float pitch, float drift, float fmde
     applyFilter();
 }
 
+template <int mode, bool stereo>
+void SineOscillator::process_block_batched_internal(SineOscillator *const *oscs, const float *pitch,
+                                                    const float *drift, int n)
+{
+    assert(n > 0 && n <= maxBatch);
+
+    /*
+     * Every unison voice of every oscillator gets a lane, packed in order, so four voices with
+     * three unison voices each take three SSE passes a sample rather than four half empty ones.
+     * Each lane does exactly what its lane in process_block_internal does.
+     */
+    constexpr int maxLanes = maxBatch * MAX_UNISON;
+
+    double omega[maxBatch][MAX_UNISON];
+    int first[maxBatch + 1];
+    float fb0w alignas(16)[maxLanes]{}, fb1w alignas(16)[maxLanes]{};
+    float pl alignas(16)[maxLanes]{}, pr alignas(16)[maxLanes]{}, att alignas(16)[maxLanes]{};
+    float lv0a alignas(16)[maxLanes]{}, lv1a alignas(16)[maxLanes]{};
+    float ramp alignas(16)[maxLanes]{}, dramp alignas(16)[maxLanes]{};
+
+    first[0] = 0;
+
+    for (int v = 0; v < n; ++v)
+    {
+        auto o = oscs[v];
+
+        o->unisonOmegas(pitch[v], drift[v], omega[v]);
+        o->FMdepth.newValue(0.f);
+        o->FB.newValue(o->fb_val);
+
+        auto fb_mode = o->oscdata->p[sine_feedback].deform_type;
+        first[v + 1] = first[v] + o->n_unison;
+
+        for (int u = 0; u < o->n_unison; ++u)
+        {
+            auto l = first[v] + u;
+
+            fb0w[l] = (fb_mode == 1) ? 0.5f : 0.f;
+            fb1w[l] = (fb_mode == 1) ? 0.5f : 1.f;
+
+            pl[l] = o->panL[u];
+            pr[l] = o->panR[u];
+            att[l] = o->out_attenuation;
+
+            lv0a[l] = o->lastvalue[0][u];
+            lv1a[l] = o->lastvalue[1][u];
+
+            // on a retriggered first block every unison voice but the first fades in
+            bool fadeIn = o->firstblock && u > 0;
+            ramp[l] = fadeIn ? 0.f : 1.f;
+            dramp[l] = fadeIn ? BLOCK_SIZE_OS_INV : 0.f;
+        }
+
+        o->firstblock = false;
+    }
+
+    const int lanes = first[n];
+    const auto mz = SIMD_MM(setzero_ps)();
+
+    float fph alignas(16)[maxLanes]{}, fbvs alignas(16)[maxLanes]{};
+    float fbsign alignas(16)[maxLanes]{};
+    float olv alignas(16)[maxLanes], orv alignas(16)[maxLanes];
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        for (int v = 0; v < n; ++v)
+        {
+            auto o = oscs[v];
+
+            for (int u = 0; u < o->n_unison; ++u)
+            {
+                auto l = first[v] + u;
+
+                fph[l] = (float)o->phase[u];
+                fbvs[l] = std::fabs(o->FB.v);
+                fbsign[l] = o->FB.v;
+            }
+        }
+
+        for (int l = 0; l < lanes; l += 4)
+        {
+            auto ph = SIMD_MM(load_ps)(&fph[l]);
+            auto fbv = SIMD_MM(load_ps)(&fbvs[l]);
+            auto fbnegmask = SIMD_MM(cmplt_ps)(SIMD_MM(load_ps)(&fbsign[l]), mz);
+            auto lv0 = SIMD_MM(load_ps)(&lv0a[l]);
+            auto lv1 = SIMD_MM(load_ps)(&lv1a[l]);
+
+            auto lv = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(lv0, SIMD_MM(load_ps)(&fb0w[l])),
+                                      SIMD_MM(mul_ps)(lv1, SIMD_MM(load_ps)(&fb1w[l])));
+            auto fba =
+                SIMD_MM(mul_ps)(SIMD_MM(add_ps)(SIMD_MM(and_ps)(fbnegmask, SIMD_MM(mul_ps)(lv, lv)),
+                                                SIMD_MM(andnot_ps)(fbnegmask, lv)),
+                                fbv);
+            // the per voice path adds a zero FM term here, which matters for the sign of zero
+            auto x = SIMD_MM(add_ps)(SIMD_MM(add_ps)(ph, fba), mz);
+
+            x = sst::basic_blocks::dsp::clampToPiRangeSSE(x);
+
+            auto sxl = sst::basic_blocks::dsp::fastsinSSE(x);
+            auto cxl = sst::basic_blocks::dsp::fastcosSSE(x);
+
+            auto out_local = valueFromSinAndCosForMode<mode>(sxl, cxl, std::min(lanes - l, 4));
+
+            auto rs = SIMD_MM(load_ps)(&ramp[l]);
+            auto olpr = SIMD_MM(mul_ps)(out_local, rs);
+            SIMD_MM(store_ps)(&ramp[l], SIMD_MM(add_ps)(rs, SIMD_MM(load_ps)(&dramp[l])));
+
+            auto att4 = SIMD_MM(load_ps)(&att[l]);
+            auto lo = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(SIMD_MM(load_ps)(&pl[l]), olpr), att4);
+            auto ro = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(SIMD_MM(load_ps)(&pr[l]), olpr), att4);
+            SIMD_MM(store_ps)(&olv[l], lo);
+            SIMD_MM(store_ps)(&orv[l], ro);
+
+            SIMD_MM(store_ps)(&lv0a[l], lv1);
+            SIMD_MM(store_ps)(&lv1a[l], out_local);
+        }
+
+        for (int v = 0; v < n; ++v)
+        {
+            auto o = oscs[v];
+            float outL = 0.f, outR = 0.f;
+
+            for (int u = 0; u < o->n_unison; ++u)
+            {
+                outL += olv[first[v] + u];
+                outR += orv[first[v] + u];
+
+                o->phase[u] += omega[v][u];
+                o->phase[u] -= (o->phase[u] > M_PI) * 2.0 * M_PI;
+            }
+
+            o->FMdepth.process();
+            o->FB.process();
+
+            if (stereo)
+            {
+                o->output[k] = outL;
+                o->outputR[k] = outR;
+            }
+            else
+                o->output[k] = (outL + outR) / 2;
+        }
+    }
+
+    for (int v = 0; v < n; ++v)
+    {
+        auto o = oscs[v];
+
+        for (int u = 0; u < o->n_unison; ++u)
+        {
+            o->lastvalue[0][u] = lv0a[first[v] + u];
+            o->lastvalue[1][u] = lv1a[first[v] + u];
+        }
+
+        o->applyFilter();
+    }
+}
+
 void SineOscillator::applyFilter()
 {
     if (!oscdata->p[sine_lowcut].deactivated)
@@ -1027,6 +1190,75 @@ void SineOscillator::process_block(float pitch, float drift, bool stereo, bool F
     }
 }
 
+void SineOscillator::process_block_batched(SineOscillator *const *oscs, const float *pitch,
+                                           const float *drift, int n, bool stereo)
+{
+    for (int v = 0; v < n; ++v)
+    {
+        assert(oscs[v]->canRenderBatched() && oscs[v]->shapeMode() == oscs[0]->shapeMode());
+        oscs[v]->fb_val = oscs[v]->oscdata->p[sine_feedback].get_extended(
+            oscs[v]->localcopy[oscs[v]->id_fb].f);
+    }
+
+#define DOCASE(x)                                                                                  \
+    case x:                                                                                        \
+        if (stereo)                                                                                \
+            process_block_batched_internal<x, true>(oscs, pitch, drift, n);                        \
+        else                                                                                       \
+            process_block_batched_internal<x, false>(oscs, pitch, drift, n);                       \
+        break;
+
+    switch (oscs[0]->shapeMode())
+    {
+        DOCASE(0)
+        DOCASE(1)
+        DOCASE(2)
+        DOCASE(3)
+        DOCASE(4)
+        DOCASE(5)
+        DOCASE(6)
+        DOCASE(7)
+        DOCASE(8)
+        DOCASE(9)
+        DOCASE(10)
+
+        DOCASE(11)
+        DOCASE(12)
+        DOCASE(13)
+        DOCASE(14)
+        DOCASE(15)
+        DOCASE(16)
+        DOCASE(17)
+        DOCASE(18)
+        DOCASE(19)
+        DOCASE(20)
+        DOCASE(21)
+        DOCASE(22)
+        DOCASE(23)
+        DOCASE(24)
+        DOCASE(25)
+        DOCASE(26)
+        DOCASE(27)
+    }
+#undef DOCASE
+
+    for (int v = 0; v < n; ++v)
+    {
+        auto o = oscs[v];
+        if (o->charFilt.doFilter)
+        {
+            if (stereo)
+            {
+                o->charFilt.process_block_stereo(o->output, o->outputR, BLOCK_SIZE_OS);
+            }
+            else
+            {
+                o->charFilt.process_block(o->output, BLOCK_SIZE_OS);
+            }
+        }
+    }
+}
+
 void SineOscillator::init_ctrltypes()
 {
     oscdata->p[sine_shape].set_name("Shape");
@@ -55,6 +55,26 @@ class SineOscillator : public Oscillator
     template <int mode>
     void process_block_legacy(float pitch, float drift = 0.f, bool stereo = false, bool FM = false,
                               float FMdepth = 0.f);
+
+    /*
+     * process_block_internal gives each unison voice an SSE lane, so unless the unison count
+     * is a multiple of four some lanes idle, and with one unison voice three of the four do.
+     * process_block_batched renders the same oscillator for up to four voices at once instead,
+     * with the unison voices of all of them packed into lanes back to back, and gives each
+     * voice exactly what its own process_block would have without FM. All the oscillators in
+     * a batch have to share a shape and stereo-ness.
+     */
+    static constexpr int maxBatch = 4, n_shapes = 28;
+    int shapeMode() const { return localcopy[id_mode].i; }
+    bool canRenderBatched() const
+    {
+        return localcopy[id_fmlegacy].i != 0 && shapeMode() >= 0 && shapeMode() < n_shapes;
+    }
+    static void process_block_batched(SineOscillator *const *oscs, const float *pitch,
+                                      const float *drift, int n, bool stereo);
+    template <int mode, bool stereo>
+    static void process_block_batched_internal(SineOscillator *const *oscs, const float *pitch,
+                                               const float *drift, int n);
     virtual ~SineOscillator();
     virtual void init_ctrltypes() override;
     virtual void init_default_values() override;
@@ -69,6 +89,7 @@ class SineOscillator : public Oscillator
     lag<double> FMdepth;
     lag<double> FB;
     void prepare_unison(int voices);
+    void unisonOmegas(float pitch, float drift, double *omega);
     int n_unison;
     float out_attenuation, out_attenuation_inv, detune_bias, detune_offset;
     float panL alignas(16)[MAX_UNISON], panR alignas(16)[MAX_UNISON];
@@ -47,8 +47,8 @@ struct Picker : public juce::Component
         g.drawRoundedRectangle(bounds, 5, 1);
         g.setColour(findColour(SurgeLookAndFeel::SurgeColourIds::paramDisplay));
         g.setFont(juce::FontOptions(28));
-        g.drawText(fx_type_names[editor->processor.getEffectType()], bounds.reduced(8, 3),
-                   juce::Justification::centred);
+        g.drawText(fx_type_names[editor->processor.getEffectType(editor->page)],
+                   bounds.reduced(8, 3), juce::Justification::centred);
 
         auto p = juce::Path();
         int sz = 15;
@@ -89,7 +89,7 @@ struct Picker : public juce::Component
             AccessibleValueRange getRange() const override { return {{0, 1}, 1}; }
             juce::String getCurrentValueAsString() const override
             {
-                return fx_type_names[comp->editor->processor.getEffectType()];
+                return fx_type_names[comp->editor->processor.getEffectType(comp->editor->page)];
             }
 
             JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AHV);
@@ -135,41 +135,41 @@ SurgefxAudioProcessorEditor::SurgefxAudioProcessorEditor(SurgefxAudioProcessor &
     for (int i = 0; i < n_fx_params; ++i)
     {
         fxParamSliders[i].setRange(0.0, 1.0, 0.0001);
-        fxParamSliders[i].setValue(processor.getFXStorageValue01(i),
+        fxParamSliders[i].setValue(processor.getFXStorageValue01(pi(i)),
                                    juce::NotificationType::dontSendNotification);
         fxParamSliders[i].setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
         fxParamSliders[i].setTextBoxStyle(juce::Slider::TextEntryBoxPosition::NoTextBox, true, 0,
                                           0);
         fxParamSliders[i].setChangeNotificationOnlyOnRelease(false);
-        fxParamSliders[i].setEnabled(processor.getParamEnabled(i));
+        fxParamSliders[i].setEnabled(processor.getParamEnabled(pi(i)));
         fxParamSliders[i].onValueChange = [i, this]() {
             this->processor.prepareParametersAbsentAudio();
-            this->processor.setFXParamValue01(i, this->fxParamSliders[i].getValue());
+            this->processor.setFXParamValue01(pi(i), this->fxParamSliders[i].getValue());
             fxParamDisplay[i].setDisplay(
-                processor.getParamValueFromFloat(i, this->fxParamSliders[i].getValue()));
-            fxParamSliders[i].setTextValue(processor.getParamValue(i).c_str());
+                processor.getParamValueFromFloat(pi(i), this->fxParamSliders[i].getValue()));
+            fxParamSliders[i].setTextValue(processor.getParamValue(pi(i)).c_str());
         };
         fxParamSliders[i].onDragStart = [i, this]() {
-            this->processor.setUserEditingFXParam(i, true);
+            this->processor.setUserEditingFXParam(pi(i), true);
         };
         fxParamSliders[i].onDragEnd = [i, this]() {
-            this->processor.setUserEditingFXParam(i, false);
+            this->processor.setUserEditingFXParam(pi(i), false);
         };
         fxParamSliders[i].setTitle("Parameter " + std::to_string(i) + " Knob");
         addAndMakeVisibleRecordOrder(&(fxParamSliders[i]));
 
         fxTempoSync[i].setOnOffImage(BinaryData::TS_Act_svg, BinaryData::TS_Act_svgSize,
                                      BinaryData::TS_Deact_svg, BinaryData::TS_Deact_svgSize);
-        fxTempoSync[i].setEnabled(processor.canTempoSync(i));
-        fxTempoSync[i].setToggleState(processor.getFXStorageTempoSync(i),
+        fxTempoSync[i].setEnabled(processor.canTempoSync(pi(i)));
+        fxTempoSync[i].setToggleState(processor.getFXStorageTempoSync(pi(i)),
                                       juce::NotificationType::dontSendNotification);
         fxTempoSync[i].onClick = [i, this]() {
-            this->processor.setUserEditingParamFeature(i, true);
-            this->processor.setFXParamTempoSync(i, this->fxTempoSync[i].getToggleState());
-            this->processor.setFXStorageTempoSync(i, this->fxTempoSync[i].getToggleState());
+            this->processor.setUserEditingParamFeature(pi(i), true);
+            this->processor.setFXParamTempoSync(pi(i), this->fxTempoSync[i].getToggleState());
+            this->processor.setFXStorageTempoSync(pi(i), this->fxTempoSync[i].getToggleState());
             fxParamDisplay[i].setDisplay(
-                processor.getParamValueFromFloat(i, this->fxParamSliders[i].getValue()));
-            this->processor.setUserEditingParamFeature(i, false);
+                processor.getParamValueFromFloat(pi(i), this->fxParamSliders[i].getValue()));
+            this->processor.setUserEditingParamFeature(pi(i), false);
         };
 
         fxTempoSync[i].setTitle("Parameter " + std::to_string(i) + " TempoSync");
@@ -177,60 +177,61 @@ SurgefxAudioProcessorEditor::SurgefxAudioProcessorEditor(SurgefxAudioProcessor &
 
         fxDeactivated[i].setOnOffImage(BinaryData::DE_Act_svg, BinaryData::DE_Act_svgSize,
                                        BinaryData::DE_Deact_svg, BinaryData::DE_Deact_svgSize);
-        fxDeactivated[i].setEnabled(processor.canDeactitvate(i));
-        fxDeactivated[i].setToggleState(processor.getFXStorageDeactivated(i),
+        fxDeactivated[i].setEnabled(processor.canDeactitvate(pi(i)));
+        fxDeactivated[i].setToggleState(processor.getFXStorageDeactivated(pi(i)),
                                         juce::NotificationType::dontSendNotification);
         fxDeactivated[i].onClick = [i, this]() {
-            this->processor.setUserEditingParamFeature(i, true);
-            this->processor.setFXParamDeactivated(i, this->fxDeactivated[i].getToggleState());
-            this->processor.setFXStorageDeactivated(i, this->fxDeactivated[i].getToggleState());
+            this->processor.setUserEditingParamFeature(pi(i), true);
+            this->processor.setFXParamDeactivated(pi(i), this->fxDeactivated[i].getToggleState());
+            this->processor.setFXStorageDeactivated(pi(i),
+                                                    this->fxDeactivated[i].getToggleState());
             // Special case - coupled dectivation
             this->resetLabels();
-            this->processor.setUserEditingParamFeature(i, false);
+            this->processor.setUserEditingParamFeature(pi(i), false);
         };
         fxDeactivated[i].setTitle("Parameter " + std::to_string(i) + " Deactivate");
         addAndMakeVisibleRecordOrder(&(fxDeactivated[i]));
 
         fxExtended[i].setOnOffImage(BinaryData::EX_Act_svg, BinaryData::EX_Act_svgSize,
                                     BinaryData::EX_Deact_svg, BinaryData::EX_Deact_svgSize);
-        fxExtended[i].setEnabled(processor.canExtend(i));
-        fxExtended[i].setToggleState(processor.getFXStorageExtended(i),
+        fxExtended[i].setEnabled(processor.canExtend(pi(i)));
+        fxExtended[i].setToggleState(processor.getFXStorageExtended(pi(i)),
                                      juce::NotificationType::dontSendNotification);
         fxExtended[i].onClick = [i, this]() {
-            this->processor.setUserEditingParamFeature(i, true);
-            this->processor.setFXParamExtended(i, this->fxExtended[i].getToggleState());
-            this->processor.setFXStorageExtended(i, this->fxExtended[i].getToggleState());
+            this->processor.setUserEditingParamFeature(pi(i), true);
+            this->processor.setFXParamExtended(pi(i), this->fxExtended[i].getToggleState());
+            this->processor.setFXStorageExtended(pi(i), this->fxExtended[i].getToggleState());
             fxParamDisplay[i].setDisplay(
-                processor.getParamValueFromFloat(i, this->fxParamSliders[i].getValue()));
-            this->processor.setUserEditingParamFeature(i, false);
+                processor.getParamValueFromFloat(pi(i), this->fxParamSliders[i].getValue()));
+            this->processor.setUserEditingParamFeature(pi(i), false);
         };
         fxExtended[i].setTitle("Parameter " + std::to_string(i) + " Extended");
         addAndMakeVisibleRecordOrder(&(fxExtended[i]));
 
         fxAbsoluted[i].setOnOffImage(BinaryData::AB_Act_svg, BinaryData::AB_Act_svgSize,
                                      BinaryData::AB_Deact_svg, BinaryData::AB_Deact_svgSize);
-        fxAbsoluted[i].setEnabled(processor.canAbsolute(i));
-        fxAbsoluted[i].setToggleState(processor.getFXParamAbsolute(i),
+        fxAbsoluted[i].setEnabled(processor.canAbsolute(pi(i)));
+        fxAbsoluted[i].setToggleState(processor.getFXParamAbsolute(pi(i)),
                                       juce::NotificationType::dontSendNotification);
         fxAbsoluted[i].onClick = [i, this]() {
-            this->processor.setUserEditingParamFeature(i, true);
-            this->processor.setFXParamAbsolute(i, this->fxAbsoluted[i].getToggleState());
-            this->processor.setFXStorageAbsolute(i, this->fxAbsoluted[i].getToggleState());
+            this->processor.setUserEditingParamFeature(pi(i), true);
+            this->processor.setFXParamAbsolute(pi(i), this->fxAbsoluted[i].getToggleState());
+            this->processor.setFXStorageAbsolute(pi(i), this->fxAbsoluted[i].getToggleState());
             fxParamDisplay[i].setDisplay(
-                processor.getParamValueFromFloat(i, this->fxParamSliders[i].getValue()));
-            this->processor.setUserEditingParamFeature(i, false);
+                processor.getParamValueFromFloat(pi(i), this->fxParamSliders[i].getValue()));
+            this->processor.setUserEditingParamFeature(pi(i), false);
         };
 
         fxAbsoluted[i].setTitle("Parameter " + std::to_string(i) + " Absoluted");
         addAndMakeVisibleRecordOrder(&(fxAbsoluted[i]));
 
         processor.prepareParametersAbsentAudio();
-        fxParamDisplay[i].setGroup(processor.getParamGroup(i).c_str());
-        fxParamDisplay[i].setName(processor.getParamName(i).c_str());
-        fxParamDisplay[i].setDisplay(processor.getParamValue(i));
-        fxParamDisplay[i].setEnabled(processor.getParamEnabled(i));
+        fxParamDisplay[i].setGroup(processor.getParamGroup(pi(i)).c_str());
+        fxParamDisplay[i].setName(processor.getParamName(pi(i)).c_str());
+        fxParamDisplay[i].setDisplay(processor.getParamValue(pi(i)));
+        fxParamDisplay[i].setEnabled(processor.getParamEnabled(pi(i)));
         fxParamDisplay[i].onOverlayEntered = [i, this](const std::string &s) {
-            processor.setParameterByString(i, s);
+            processor.setParameterByString(pi(i), s);
         };
 
         addAndMakeVisibleRecordOrder(&(fxParamDisplay[i]));
@@ -242,6 +243,21 @@ SurgefxAudioProcessorEditor::SurgefxAudioProcessorEditor(SurgefxAudioProcessor &
     fxNameLabel->setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisibleRecordOrder(fxNameLabel.get());
 
+    for (int s = 0; s < SurgefxAudioProcessor::n_chain_slots; ++s)
+    {
+        auto &b = pageButtons[s];
+        b = std::make_unique<juce::TextButton>(std::to_string(s + 1));
+        b->setTitle("FX Slot " + std::to_string(s + 1));
+        b->setClickingTogglesState(true);
+        b->setRadioGroupId(FxPageGroup);
+        b->setToggleState(s == page, juce::NotificationType::dontSendNotification);
+        b->onClick = [this, s]() {
+            if (pageButtons[s]->getToggleState())
+                setPage(s);
+        };
+        addAndMakeVisibleRecordOrder(b.get());
+    }
+
     this->processor.setParameterChangeListener([this]() { this->triggerAsyncUpdate(); });
 
     setTitle("Surge XT Effects");
@@ -284,42 +300,43 @@ void SurgefxAudioProcessorEditor::resetLabels()
     };
     for (int i = 0; i < n_fx_params; ++i)
     {
-        auto nm = processor.getParamName(i) + " " + processor.getParamGroup(i);
-        fxParamSliders[i].setValue(processor.getFXStorageValue01(i),
+        auto nm = processor.getParamName(pi(i)) + " " + processor.getParamGroup(pi(i));
+        fxParamSliders[i].setValue(processor.getFXStorageValue01(pi(i)),
                                    juce::NotificationType::dontSendNotification);
-        fxParamDisplay[i].setDisplay(processor.getParamValue(i).c_str());
-        fxParamDisplay[i].setGroup(processor.getParamGroup(i).c_str());
-        fxParamDisplay[i].setName(processor.getParamName(i).c_str());
-        fxParamDisplay[i].allowsTypein = processor.canSetParameterByString(i);
-
-        fxParamDisplay[i].setEnabled(processor.getParamEnabled(i));
-        fxParamDisplay[i].setAppearsDeactivated(processor.getFXStorageAppearsDeactivated(i));
-        fxParamSliders[i].setEnabled(processor.getParamEnabled(i) &&
-                                     !processor.getFXStorageAppearsDeactivated(i));
+        fxParamDisplay[i].setDisplay(processor.getParamValue(pi(i)).c_str());
+        fxParamDisplay[i].setGroup(processor.getParamGroup(pi(i)).c_str());
+        fxParamDisplay[i].setName(processor.getParamName(pi(i)).c_str());
+        fxParamDisplay[i].allowsTypein = processor.canSetParameterByString(pi(i));
+
+        fxParamDisplay[i].setEnabled(processor.getParamEnabled(pi(i)));
+        fxParamDisplay[i].setAppearsDeactivated(
+            processor.getFXStorageAppearsDeactivated(pi(i)));
+        fxParamSliders[i].setEnabled(processor.getParamEnabled(pi(i)) &&
+                                     !processor.getFXStorageAppearsDeactivated(pi(i)));
         st(fxParamSliders[i], nm + " Knob");
-        fxParamSliders[i].setTextValue(processor.getParamValue(i).c_str());
+        fxParamSliders[i].setTextValue(processor.getParamValue(pi(i)).c_str());
 
-        fxTempoSync[i].setEnabled(processor.canTempoSync(i));
-        fxTempoSync[i].setAccessible(processor.canTempoSync(i));
-        fxTempoSync[i].setToggleState(processor.getFXStorageTempoSync(i),
+        fxTempoSync[i].setEnabled(processor.canTempoSync(pi(i)));
+        fxTempoSync[i].setAccessible(processor.canTempoSync(pi(i)));
+        fxTempoSync[i].setToggleState(processor.getFXStorageTempoSync(pi(i)),
                                       juce::NotificationType::dontSendNotification);
         st(fxTempoSync[i], nm + " Tempo Synced");
         fxDeactivated[i].setEnabled(false);
 
-        fxExtended[i].setEnabled(processor.canExtend(i));
-        fxExtended[i].setToggleState(processor.getFXStorageExtended(i),
+        fxExtended[i].setEnabled(processor.canExtend(pi(i)));
+        fxExtended[i].setToggleState(processor.getFXStorageExtended(pi(i)),
                                      juce::NotificationType::dontSendNotification);
-        fxExtended[i].setAccessible(processor.canExtend(i));
+        fxExtended[i].setAccessible(processor.canExtend(pi(i)));
         st(fxExtended[i], nm + " Extended");
-        fxAbsoluted[i].setEnabled(processor.canAbsolute(i));
-        fxAbsoluted[i].setToggleState(processor.getFXStorageAbsolute(i),
+        fxAbsoluted[i].setEnabled(processor.canAbsolute(pi(i)));
+        fxAbsoluted[i].setToggleState(processor.getFXStorageAbsolute(pi(i)),
                                       juce::NotificationType::dontSendNotification);
-        fxAbsoluted[i].setAccessible(processor.canAbsolute(i));
+        fxAbsoluted[i].setAccessible(processor.canAbsolute(pi(i)));
         st(fxAbsoluted[i], nm + " Absolute");
-        fxDeactivated[i].setEnabled(processor.canDeactitvate(i));
-        fxDeactivated[i].setToggleState(processor.getFXStorageDeactivated(i),
+        fxDeactivated[i].setEnabled(processor.canDeactitvate(pi(i)));
+        fxDeactivated[i].setToggleState(processor.getFXStorageDeactivated(pi(i)),
                                         juce::NotificationType::dontSendNotification);
-        fxDeactivated[i].setAccessible(processor.canDeactitvate(i));
+        fxDeactivated[i].setAccessible(processor.canDeactitvate(pi(i)));
         st(fxDeactivated[i], nm + " Deactivated");
     }
 
@@ -335,31 +352,40 @@ void SurgefxAudioProcessorEditor::resetLabels()
 
 void SurgefxAudioProcessorEditor::setEffectType(int i)
 {
-    processor.resetFxType(i);
+    processor.requestFxType(page, i);
     blastToggleState(i - 1);
     resetLabels();
     picker->repaint();
 }
 
+void SurgefxAudioProcessorEditor::setPage(int p)
+{
+    if (p == page)
+        return;
+
+    page = p;
+    resetLabels();
+}
+
 void SurgefxAudioProcessorEditor::handleAsyncUpdate() { paramsChangedCallback(); }
 
 void SurgefxAudioProcessorEditor::paramsChangedCallback()
 {
     bool cv[n_fx_params + 1];
     float fv[n_fx_params + 1];
-    processor.copyChangeValues(cv, fv);
+    processor.copyChangeValues(page, cv, fv);
     for (int i = 0; i < n_fx_params + 1; ++i)
         if (cv[i])
         {
             if (i < n_fx_params)
             {
                 fxParamSliders[i].setValue(fv[i], juce::NotificationType::dontSendNotification);
-                fxParamDisplay[i].setDisplay(processor.getParamValueFor(i, fv[i]));
+                fxParamDisplay[i].setDisplay(processor.getParamValueFor(pi(i), fv[i]));
             }
             else
             {
                 // My type has changed - blow out the toggle states by hand
-                blastToggleState(processor.getEffectType() - 1);
+                blastToggleState(processor.getEffectType(page) - 1);
                 resetLabels();
             }
         }
@@ -377,6 +403,12 @@ void SurgefxAudioProcessorEditor::resized()
 {
     picker->setBounds(100, 10, getWidth() - 200, topSection - 30);
 
+    int pbw = 40, pbh = (topSection - 30) / 2;
+    for (int s = 0; s < SurgefxAudioProcessor::n_chain_slots; ++s)
+    {
+        pageButtons[s]->setBounds(10 + (s % 2) * pbw, 10 + (s / 2) * pbh, pbw, pbh);
+    }
+
     int ypos0 = topSection - 5;
     int rowHeight = (getHeight() - topSection - 40 - 10) / 6.0;
     int byoff = 7;
@@ -500,6 +532,14 @@ void SurgefxAudioProcessorEditor::showMenu()
 {
     auto p = juce::PopupMenu();
 
+    // Only the chain slots can be empty; the first slot always runs an effect
+    if (page > 0)
+    {
+        p.addItem("Off", true, processor.getEffectType(page) == fxt_off,
+                  [this]() { setEffectType(fxt_off); });
+        p.addSeparator();
+    }
+
     for (const auto &m : menu)
     {
         if (m.isBreak)
@@ -528,6 +568,8 @@ void SurgefxAudioProcessorEditor::showMenu()
     auto sm = juce::PopupMenu();
     sm.addItem(Surge::GUI::toOSCase("Zero Latency Mode"), true, processor.nonLatentBlockMode,
                [this]() { toggleLatencyMode(); });
+    sm.addItem(Surge::GUI::toOSCase("Crossfade FX Type Changes"), true,
+               processor.backgroundTypeChange, [this]() { toggleBackgroundTypeChange(); });
     auto oscm = makeOSCMenu();
     sm.addSubMenu("OSC", oscm);
     p.addSubMenu("Options", sm);
@@ -767,12 +809,21 @@ void SurgefxAudioProcessorEditor::changeOSCInputPort()
     // TODO: fill this out
 }
 
+void SurgefxAudioProcessorEditor::toggleBackgroundTypeChange()
+{
+    auto btc = !processor.backgroundTypeChange;
+    Surge::Storage::updateUserDefaultValue(processor.storage.get(),
+                                           Surge::Storage::FXUnitBackgroundTypeChange, btc);
+    processor.backgroundTypeChange = btc;
+}
+
 void SurgefxAudioProcessorEditor::toggleLatencyMode()
 {
     auto clm = processor.nonLatentBlockMode;
     Surge::Storage::updateUserDefaultValue(processor.storage.get(),
                                            Surge::Storage::FXUnitAssumeFixedBlock, !clm);
     processor.nonLatentBlockMode = !clm;
+    processor.preferNonLatentBlockMode = !clm;
 
     std::ostringstream oss;
     oss << "Please restart the DAW transport or reload your DAW project for this setting "
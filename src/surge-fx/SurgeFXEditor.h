@@ -58,6 +58,7 @@ class SurgefxAudioProcessorEditor : public juce::AudioProcessorEditor,
     void makeMenu();
     void showMenu();
     void toggleLatencyMode();
+    void toggleBackgroundTypeChange();
     void changeOSCInputPort();
 
     //==============================================================================
@@ -84,11 +85,21 @@ class SurgefxAudioProcessorEditor : public juce::AudioProcessorEditor,
     void paramsChangedCallback();
     void setEffectType(int i);
 
+    /*
+     * The editor shows one slot of the processor's FX chain at a time. The knobs and
+     * buttons are indexed by param within the page; pi() maps them to the processor's
+     * paged param index.
+     */
+    int page{0};
+    int pi(int i) const { return page * n_fx_params + i; }
+    void setPage(int p);
+
     virtual void handleAsyncUpdate() override;
 
     enum RadioGroupIds
     {
-        FxTypeGroup = 1776
+        FxTypeGroup = 1776,
+        FxPageGroup
     };
 
     // This reference is provided as a quick way for your editor to
@@ -173,6 +184,7 @@ class SurgefxAudioProcessorEditor : public juce::AudioProcessorEditor,
 
     std::unique_ptr<SurgeLookAndFeel> surgeLookFeel;
     std::unique_ptr<juce::Label> fxNameLabel;
+    std::unique_ptr<juce::TextButton> pageButtons[SurgefxAudioProcessor::n_chain_slots];
 
     void addAndMakeVisibleRecordOrder(juce::Component *c)
     {
@@ -50,67 +50,105 @@ SurgefxAudioProcessor::SurgefxAudioProcessor()
     nonLatentBlockMode = !juce::PluginHostType().isFruityLoops();
     nonLatentBlockMode = Surge::Storage::getUserDefaultValue(
         storage.get(), Surge::Storage::FXUnitAssumeFixedBlock, nonLatentBlockMode);
+    preferNonLatentBlockMode = nonLatentBlockMode;
 
-    setLatencySamples(nonLatentBlockMode ? 0 : BLOCK_SIZE);
+    memset(output_buffer, 0, sizeof(output_buffer));
+    memset(input_buffer, 0, sizeof(input_buffer));
+    memset(sidechain_buffer, 0, sizeof(sidechain_buffer));
 
-    effectNum = fxt_off;
+    setLatencySamples(nonLatentBlockMode ? 0 : BLOCK_SIZE);
 
-    fxstorage = &(storage->getPatch().fx[0]);
-    audio_thread_surge_effect.reset();
-    resetFxType(effectNum, false);
-    fxstorage->return_level.id = -1;
-    setupStorageRanges(&(fxstorage->type), &(fxstorage->p[n_fx_params - 1]));
+    backgroundTypeChange = Surge::Storage::getUserDefaultValue(
+        storage.get(), Surge::Storage::FXUnitBackgroundTypeChange, backgroundTypeChange);
 
-    for (int i = 0; i < n_fx_params; ++i)
+    for (int s = 0; s < n_chain_slots; ++s)
     {
-        std::string lb, nm;
-        lb = fmt::format("fx_parm_{:d}", i);
-        nm = fmt::format("FX Parameter {:d}", i);
-
-        addParameter(fxParams[i] = new float_param_t(
-                         juce::ParameterID(lb, 1), nm, juce::NormalisableRange<float>(0.0, 1.0),
-                         fxstorage->p[fx_param_remap[i]].get_value_f01()));
-        fxParams[i]->getTextHandler = [this, i](float f, int len) -> juce::String {
-            return juce::String(getParamValueFor(i, f)).substring(0, len);
-        };
-        fxParams[i]->getTextToValue = [this, i](const juce::String &s) -> float {
-            return getParameterValueForString(i, s.toStdString());
-        };
-        fxBaseParams[i] = fxParams[i];
-    }
-
-    addParameter(fxType = new int_param_t(juce::ParameterID("fxtype", 1), "FX Type", fxt_delay,
-                                          n_fx_types - 1, effectNum));
-    fxType->getTextHandler = [this](float f, int len) -> juce::String {
-        auto i = 1 + (int)round(f * (n_fx_types - 2));
-        if (i >= 1 && i < n_fx_types)
-            return fx_type_names[i];
-        return "";
-    };
-
-    fxType->getTextToValue = [](const juce::String &s) -> float { return 0; };
-    fxBaseParams[n_fx_params] = fxType;
+        auto &slot = fxSlots[s];
+        slot.index = s;
+        slot.effectNum = fxt_off;
+        slot.fxstorage = fxStorageFor(s, slot.fxSlot);
+        resetFxType(s, fxt_off, false);
+
+        // Both entries a slot alternates between in background type change mode skip their
+        // return level
+        fxStorageFor(s, 0)->return_level.id = -1;
+        fxStorageFor(s, 1)->return_level.id = -1;
+        setupStorageRanges(slot);
+    }
 
-    for (int i = 0; i < n_fx_params; ++i)
+    for (int s = 0; s < n_chain_slots; ++s)
     {
-        // FIXME - is this even used here?!
-        std::string lb, nm;
-        lb = fmt::format("fx_temposync_{:d}", i);
-        nm = fmt::format("Feature Param {:d}", i);
+        auto &slot = fxSlots[s];
+
+        for (int p = 0; p < n_fx_params; ++p)
+        {
+            auto i = s * n_fx_params + p;
 
-        paramFeatures[i] = paramFeatureFromParam(&(fxstorage->p[fx_param_remap[i]]));
+            // Slot 0 keeps the ids and names from before there was a chain
+            std::string lb, nm;
+            if (s == 0)
+            {
+                lb = fmt::format("fx_parm_{:d}", p);
+                nm = fmt::format("FX Parameter {:d}", p);
+            }
+            else
+            {
+                lb = fmt::format("fx{:d}_parm_{:d}", s + 1, p);
+                nm = fmt::format("FX {:d} Parameter {:d}", s + 1, p);
+            }
+
+            addParameter(fxParams[i] = new float_param_t(juce::ParameterID(lb, s == 0 ? 1 : 2), nm,
+                                                         juce::NormalisableRange<float>(0.0, 1.0),
+                                                         storageParam(i).get_value_f01()));
+            fxParams[i]->getTextHandler = [this, i](float f, int len) -> juce::String {
+                return juce::String(getParamValueFor(i, f)).substring(0, len);
+            };
+            fxParams[i]->getTextToValue = [this, i](const juce::String &s) -> float {
+                return getParameterValueForString(i, s.toStdString());
+            };
+            fxBaseParams[juceIndexForParam(i)] = fxParams[i];
+        }
+
+        if (s == 0)
+        {
+            addParameter(slot.fxType = new int_param_t(juce::ParameterID("fxtype", 1), "FX Type",
+                                                       fxt_delay, n_fx_types - 1, slot.effectNum));
+            slot.fxType->getTextHandler = [](float f, int len) -> juce::String {
+                auto i = 1 + (int)round(f * (n_fx_types - 2));
+                if (i >= 1 && i < n_fx_types)
+                    return fx_type_names[i];
+                return "";
+            };
+        }
+        else
+        {
+            // Chain slots can be switched off, so their range starts at fxt_off
+            addParameter(slot.fxType = new int_param_t(
+                             juce::ParameterID(fmt::format("fx{:d}_type", s + 1), 2),
+                             fmt::format("FX {:d} Type", s + 1), fxt_off, n_fx_types - 1, fxt_off));
+            slot.fxType->getTextHandler = [](float f, int len) -> juce::String {
+                auto i = (int)round(f * (n_fx_types - 1));
+                if (i >= 0 && i < n_fx_types)
+                    return fx_type_names[i];
+                return "";
+            };
+        }
+
+        slot.fxType->getTextToValue = [](const juce::String &s) -> float { return 0; };
+        fxBaseParams[juceIndexForType(s)] = slot.fxType;
     }
 
-    for (int i = 0; i < n_fx_params + 1; ++i)
+    for (int i = 0; i < n_chain_params; ++i)
     {
-        fxBaseParams[i]->addListener(this);
-        changedParams[i] = false;
-        isUserEditing[i] = false;
+        paramFeatures[i] = paramFeatureFromParam(&storageParam(i));
+        wasParamFeatureChanged[i] = false;
     }
 
-    for (int i = 0; i < n_fx_params; ++i)
+    for (int i = 0; i < n_juce_params; ++i)
     {
-        wasParamFeatureChanged[i] = false;
+        fxBaseParams[i]->addListener(this);
+        changedParams[i] = false;
+        isUserEditing[i] = false;
     }
 
     paramChangeListener = []() {};
@@ -202,11 +240,26 @@ void SurgefxAudioProcessor::prepareToPlay(double sr, int samplesPerBlock)
     storage->setSamplerate(sr);
     storage->songpos = 0.;
 
+    /*
+     * A host which sent an odd block after a loop point or a transport jump pushed us into the
+     * latent mode; if the user asked for zero latency, try it again from here, and allow the
+     * audio thread its one way back again.
+     */
+    if (!nonLatentBlockMode && preferNonLatentBlockMode)
+    {
+        nonLatentBlockMode = true;
+        input_position = 0;
+        output_position = -1;
+    }
+
+    alignedHostBlocks = 0;
+    nonLatentReentryUsed = false;
+
     setLatencySamples(nonLatentBlockMode ? 0 : BLOCK_SIZE);
 
-    if (effectNum == fxt_off)
+    if (fxSlots[0].effectNum == fxt_off)
     {
-        resetFxType(fxt_delay, true);
+        resetFxType(0, fxt_delay, true);
     }
 }
 
@@ -214,6 +267,7 @@ void SurgefxAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    audioRunning = false;
 }
 
 bool SurgefxAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts) const
@@ -236,7 +290,15 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                          juce::MidiBuffer &midiMessages)
 {
     audioRunning = true;
-    if (resettingFx || !surge_effect)
+
+    // Pick up whatever the message thread has built before anything looks at the effects
+    for (auto &slot : fxSlots)
+    {
+        if (slot.effect.beginBlock())
+            triggerAsyncUpdate();
+    }
+
+    if (resettingFx || !fxSlots[0].effect.audioEffect())
         return;
 
     if (oscCheckStartup)
@@ -264,15 +326,26 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         storage->temposyncratio_inv = 1.f / storage->temposyncratio;
     }
 
-    if (surge_effect->checkHasInvalidatedUI())
+    for (auto &slot : fxSlots)
     {
-        resetFxParams(true);
+        // Mid change the JUCE params still describe the old effect, so leave it to the commit
+        auto *fx = slot.effect.audioEffect();
+
+        if (fx && slot.effect.state() == Surge::FX::EffectHandoff::kIdle &&
+            fx->checkHasInvalidatedUI())
+        {
+            slot.uiInvalidated = true;
+            triggerAsyncUpdate();
+        }
     }
 
     auto sampl = buffer.getNumSamples();
-    if (nonLatentBlockMode && ((sampl & ~(BLOCK_SIZE - 1)) != sampl))
+    bool hostBlockAligned = ((sampl & ~(BLOCK_SIZE - 1)) == sampl);
+
+    if (nonLatentBlockMode && !hostBlockAligned)
     {
         nonLatentBlockMode = false;
+        alignedHostBlocks = 0;
         input_position = 0;
         output_position = 0;
         memset(output_buffer, 0, sizeof(output_buffer));
@@ -282,6 +355,29 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         setLatencySamples(BLOCK_SIZE);
         updateHostDisplay(ChangeDetails().withLatencyChanged(true));
     }
+    else if (!nonLatentBlockMode && preferNonLatentBlockMode && !nonLatentReentryUsed)
+    {
+        /*
+         * Some hosts only send an odd block after a loop point or a transport jump. Once
+         * they have been back on BLOCK_SIZE multiples for a while, drop the latency again.
+         * This happens once; should the host misalign again we stay latent until the next
+         * prepareToPlay. The carried partial block is discarded, which is no worse than the
+         * jump in latency the host is about to compensate for anyway.
+         */
+        alignedHostBlocks = hostBlockAligned ? alignedHostBlocks + 1 : 0;
+
+        if (alignedHostBlocks >= alignedHostBlocksBeforeNonLatent)
+        {
+            nonLatentBlockMode = true;
+            nonLatentReentryUsed = true;
+            alignedHostBlocks = 0;
+            input_position = 0;
+            output_position = -1;
+
+            setLatencySamples(0);
+            updateHostDisplay(ChangeDetails().withLatencyChanged(true));
+        }
+    }
 
     auto mib = getBus(true, 0);
     if (mib->isEnabled() && !(mib->getNumberOfChannels() == 1 || mib->getNumberOfChannels() == 2))
@@ -322,31 +418,31 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     auto mainOutput = getBusBuffer(buffer, false, 0);
     auto sideChainInput = getBusBuffer(buffer, true, 1);
 
-    // FIXME: Check: has type changed?
-    int pt = *fxType;
-
-    if (effectNum != pt)
+    for (auto &slot : fxSlots)
     {
-        effectNum = pt;
-        resetFxType(effectNum);
-    }
+        // The message thread builds the new effect and hands it over at a later block
+        int pt = *(slot.fxType);
 
-    if (audio_thread_surge_effect.get() != surge_effect.get())
-    {
-        audio_thread_surge_effect = surge_effect;
+        if (pt != slot.effectNum && pt != slot.requestedFxType)
+        {
+            slot.requestedFxType = pt;
+            triggerAsyncUpdate();
+        }
     }
 
     if (nonLatentBlockMode)
     {
         auto sideChainBus = getBus(true, 1);
+        bool runsRingmod = anySlotRuns(fxt_ringmod);
+        bool useSidechain = (anySlotRuns(fxt_vocoder) || runsRingmod) && sideChainBus &&
+                            sideChainBus->isEnabled();
 
         for (int outPos = 0; outPos < buffer.getNumSamples() && !resettingFx; outPos += BLOCK_SIZE)
         {
             auto outL = mainOutput.getWritePointer(0, outPos);
             auto outR = mainOutput.getWritePointer(1, outPos);
 
-            if ((effectNum == fxt_vocoder || effectNum == fxt_ringmod) && sideChainBus &&
-                sideChainBus->isEnabled())
+            if (useSidechain)
             {
                 auto sideL = sideChainInput.getReadPointer(0, outPos);
                 auto sideR = sideChainInput.getReadPointer(1, outPos);
@@ -354,7 +450,7 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                 memcpy(storage->audio_in_nonOS[0], sideL, BLOCK_SIZE * sizeof(float));
                 memcpy(storage->audio_in_nonOS[1], sideR, BLOCK_SIZE * sizeof(float));
 
-                if (effectNum == fxt_ringmod)
+                if (runsRingmod)
                 {
                     halfbandIN.process_block_U2(storage->audio_in_nonOS[0],
                                                 storage->audio_in_nonOS[1], storage->audio_in[0],
@@ -362,19 +458,12 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                 }
             }
 
-            for (int i = 0; i < n_fx_params; ++i)
-            {
-                fxstorage->p[fx_param_remap[i]].set_value_f01(*fxParams[i]);
-                paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), paramFeatures[i]);
-            }
-            copyGlobaldataSubset(storage_id_start, storage_id_end);
-
             auto inL = mainInput.getReadPointer(inChanL, outPos);
             auto inR = mainInput.getReadPointer(inChanR, outPos);
 
             if (is_aligned(outL, 16) && is_aligned(outR, 16) && inL == outL && inR == outR)
             {
-                audio_thread_surge_effect->process_ringout(outL, outR, true);
+                processChainBlock(outL, outR);
             }
             else
             {
@@ -383,7 +472,7 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                 memcpy(bufferL, inL, BLOCK_SIZE * sizeof(float));
                 memcpy(bufferR, inR, BLOCK_SIZE * sizeof(float));
 
-                audio_thread_surge_effect->process_ringout(bufferL, bufferR, true);
+                processChainBlock(bufferL, bufferR);
 
                 memcpy(outL, bufferL, BLOCK_SIZE * sizeof(float));
                 memcpy(outR, bufferR, BLOCK_SIZE * sizeof(float));
@@ -402,56 +491,71 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
         auto sideChainBus = getBus(true, 1);
 
-        if (effectNum == fxt_vocoder && sideChainBus && sideChainBus->isEnabled())
+        if (anySlotRuns(fxt_vocoder) && sideChainBus && sideChainBus->isEnabled())
         {
             sideL = sideChainInput.getReadPointer(0, 0);
             sideR = sideChainInput.getReadPointer(1, 0);
         }
 
-        for (int smp = 0; smp < buffer.getNumSamples(); smp++)
+        bool useSidechain = sideL && sideR;
+        int nsmp = buffer.getNumSamples();
+        int smp = 0;
+
+        /*
+         * Move audio in runs that end at most at the next block boundary rather than sample
+         * by sample. Input sample k of a block emits output sample k + 1 of the previous
+         * block, and the sample completing a block emits sample 0 of the freshly processed
+         * one. The input is copied before the output is written since the host buffers may
+         * alias.
+         */
+        while (smp < nsmp)
         {
-            input_buffer[0][input_position] = inL[smp];
-            input_buffer[1][input_position] = inR[smp];
-            if (effectNum == fxt_vocoder && sideL && sideR)
+            int n = std::min(nsmp - smp, BLOCK_SIZE - input_position);
+            bool completesBlock = (input_position + n == BLOCK_SIZE);
+            int fromPrevious = completesBlock ? n - 1 : n;
+
+            memcpy(&input_buffer[0][input_position], inL + smp, n * sizeof(float));
+            memcpy(&input_buffer[1][input_position], inR + smp, n * sizeof(float));
+
+            if (useSidechain)
             {
-                sidechain_buffer[0][input_position] = sideL[smp];
-                sidechain_buffer[1][input_position] = sideR[smp];
+                memcpy(&sidechain_buffer[0][input_position], sideL + smp, n * sizeof(float));
+                memcpy(&sidechain_buffer[1][input_position], sideR + smp, n * sizeof(float));
             }
             else
             {
-                sidechain_buffer[0][input_position] = 0.f;
-                sidechain_buffer[1][input_position] = 0.f;
+                memset(&sidechain_buffer[0][input_position], 0, n * sizeof(float));
+                memset(&sidechain_buffer[1][input_position], 0, n * sizeof(float));
             }
-            input_position++;
 
-            if (input_position == BLOCK_SIZE)
+            if (output_position >= 0)
+            {
+                memcpy(outL + smp, &output_buffer[0][input_position + 1],
+                       fromPrevious * sizeof(float));
+                memcpy(outR + smp, &output_buffer[1][input_position + 1],
+                       fromPrevious * sizeof(float));
+            }
+            else
+            {
+                memset(outL + smp, 0, fromPrevious * sizeof(float));
+                memset(outR + smp, 0, fromPrevious * sizeof(float));
+            }
+
+            input_position += n;
+            smp += n;
+
+            if (completesBlock)
             {
                 memcpy(storage->audio_in_nonOS[0], sidechain_buffer[0], BLOCK_SIZE * sizeof(float));
                 memcpy(storage->audio_in_nonOS[1], sidechain_buffer[1], BLOCK_SIZE * sizeof(float));
 
-                for (int i = 0; i < n_fx_params; ++i)
-                {
-                    fxstorage->p[fx_param_remap[i]].set_value_f01(*fxParams[i]);
-                    paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), paramFeatures[i]);
-                }
-                copyGlobaldataSubset(storage_id_start, storage_id_end);
-
-                audio_thread_surge_effect->process_ringout(input_buffer[0], input_buffer[1], true);
+                processChainBlock(input_buffer[0], input_buffer[1]);
                 memcpy(output_buffer, input_buffer, 2 * BLOCK_SIZE * sizeof(float));
                 input_position = 0;
                 output_position = 0;
-            }
 
-            if (output_position >= 0 && output_position < BLOCK_SIZE) // that < should never happen
-            {
-                outL[smp] = output_buffer[0][output_position];
-                outR[smp] = output_buffer[1][output_position];
-                output_position++;
-            }
-            else
-            {
-                outL[smp] = 0;
-                outR[smp] = 0;
+                outL[smp - 1] = output_buffer[0][0];
+                outR[smp - 1] = output_buffer[1][0];
             }
         }
     }
@@ -474,6 +578,58 @@ void SurgefxAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         processBlockOSC();
 }
 
+void SurgefxAudioProcessor::processChainBlock(float *dataL, float *dataR)
+{
+    for (auto &slot : fxSlots)
+    {
+        pushParamsToStorage(slot);
+        processEffectBlock(slot, dataL, dataR);
+    }
+}
+
+void SurgefxAudioProcessor::pushParamsToStorage(FXSlot &slot)
+{
+    // Until the message thread commits a background type change, the JUCE params and
+    // the remap still describe the old effect, so leave the new one on its defaults
+    if (slot.effect.state() == Surge::FX::EffectHandoff::kRetired)
+        return;
+
+    auto dirty = slot.dirtyParams.exchange(0);
+
+    if (dirty == 0)
+        return;
+
+    auto &globaldata = storage->getPatch().globaldata;
+
+    for (int p = 0; p < n_fx_params; ++p)
+    {
+        if (!(dirty & (1U << p)))
+            continue;
+
+        auto i = slot.index * n_fx_params + p;
+        auto &par = slot.fxstorage->p[slot.fx_param_remap[p]];
+        par.set_value_f01(*fxParams[i]);
+        paramFeatureOntoParam(&par, paramFeatures[i]);
+
+        if (dirty != allParamsDirty && par.id >= 0)
+        {
+            globaldata[par.id].i = par.val.i;
+        }
+    }
+
+    // A full refresh also picks up the type, which isn't one of the JUCE params
+    if (dirty == allParamsDirty)
+    {
+        copyGlobaldataSubset(slot.storage_id_start, slot.storage_id_end);
+    }
+}
+
+void SurgefxAudioProcessor::processEffectBlock(FXSlot &slot, float *dataL, float *dataR)
+{
+    if (slot.effect.process(dataL, dataR))
+        triggerAsyncUpdate();
+}
+
 // Pull incoming OSC events from ring buffer
 void SurgefxAudioProcessor::processBlockOSC()
 {
@@ -489,8 +645,9 @@ void SurgefxAudioProcessor::processBlockOSC()
             prepareParametersAbsentAudio();
             setFXParamValue01(om->p_index, om->fval);
             // this order does matter
-            changedParamsValue[om->p_index] = om->fval;
-            changedParams[om->p_index] = true;
+            auto ji = juceIndexForParam(om->p_index);
+            changedParamsValue[ji] = om->fval;
+            changedParams[ji] = true;
             triggerAsyncUpdate();
         }
         break;
@@ -515,48 +672,57 @@ void SurgefxAudioProcessor::getStateInformation(juce::MemoryBlock &destData)
     std::unique_ptr<juce::XmlElement> xml(new juce::XmlElement("surgefx"));
     xml->setAttribute("streamingVersion", (int)2);
 
-    for (int i = 0; i < n_fx_params; ++i)
+    for (auto &slot : fxSlots)
     {
-        juce::String nm = fmt::format("fxp_{:d}", i);
-        float val = *(fxParams[i]);
+        // Slot 0 streams with the same names as before there was a chain
+        auto pfx = slot.index == 0 ? std::string() : fmt::format("fx{:d}_", slot.index + 1);
 
-        xml->setAttribute(nm, val);
+        for (int p = 0; p < n_fx_params; ++p)
+        {
+            auto i = slot.index * n_fx_params + p;
 
-        auto &spar = fxstorage->p[fx_param_remap[i]];
-        nm = fmt::format("surgevaltype_{:d}", i);
+            juce::String nm = pfx + fmt::format("fxp_{:d}", p);
+            float val = *(fxParams[i]);
 
-        xml->setAttribute(nm, spar.valtype);
+            xml->setAttribute(nm, val);
 
-        nm = fmt::format("surgeval_{:d}", i);
+            auto &spar = storageParam(i);
+            nm = pfx + fmt::format("surgevaltype_{:d}", p);
 
-        switch (spar.valtype)
-        {
-        case vt_bool:
-            xml->setAttribute(nm, spar.val.b);
-            break;
-        case vt_int:
-            if (spar.ctrltype == ct_none)
-            {
-                xml->setAttribute(nm, 0);
-            }
-            else
+            xml->setAttribute(nm, spar.valtype);
+
+            nm = pfx + fmt::format("surgeval_{:d}", p);
+
+            switch (spar.valtype)
             {
-                xml->setAttribute(nm, spar.val.i);
+            case vt_bool:
+                xml->setAttribute(nm, spar.val.b);
+                break;
+            case vt_int:
+                if (spar.ctrltype == ct_none)
+                {
+                    xml->setAttribute(nm, 0);
+                }
+                else
+                {
+                    xml->setAttribute(nm, spar.val.i);
+                }
+                break;
+            default:
+            case vt_float:
+                xml->setAttribute(nm, spar.val.f);
+                break;
             }
-            break;
-        default:
-        case vt_float:
-            xml->setAttribute(nm, spar.val.f);
-            break;
-        }
 
-        nm = fmt::format("fxp_param_features_{:d}", i);
+            nm = pfx + fmt::format("fxp_param_features_{:d}", p);
+
+            int pf = paramFeatureFromParam(&spar);
+            xml->setAttribute(nm, pf);
+        }
 
-        int pf = paramFeatureFromParam(&(fxstorage->p[fx_param_remap[i]]));
-        xml->setAttribute(nm, pf);
+        xml->setAttribute(juce::String(pfx + "fxt"), slot.effectNum.load());
     }
 
-    xml->setAttribute("fxt", effectNum);
     xml->setAttribute("oscpin", oscPortIn);
     xml->setAttribute("oscin", oscStartIn);
 
@@ -569,91 +735,103 @@ void SurgefxAudioProcessor::setStateInformation(const void *data, int sizeInByte
 
     if (xmlState.get() != nullptr)
     {
-        int paramFeaturesCache[n_fx_params];
         if (xmlState->hasTagName("surgefx"))
         {
             auto streamingVersion = xmlState->getIntAttribute("streamingVersion", (int)2);
             if (streamingVersion > 2 || streamingVersion < 0)
                 streamingVersion = 1; // assume some corrupted ancient session
 
-            effectNum = xmlState->getIntAttribute("fxt", fxt_delay);
-            resetFxType(effectNum, false);
-
             oscPortIn = xmlState->getIntAttribute("oscpin", 0);
             oscStartIn = xmlState->getBoolAttribute("oscin", false);
             // start OSC, if variables merit it
             oscCheckStartup = true;
 
-            for (int i = 0; i < n_fx_params; ++i)
+            for (auto &slot : fxSlots)
             {
-                std::string nm;
+                int paramFeaturesCache[n_fx_params]{};
+                auto pfx =
+                    slot.index == 0 ? std::string() : fmt::format("fx{:d}_", slot.index + 1);
 
-                if (streamingVersion == 1)
-                {
-                    nm = fmt::format("fxp_{:d}", i);
-                    float v = xmlState->getDoubleAttribute(nm, 0.0);
-                    fxstorage->p[fx_param_remap[i]].set_value_f01(v);
-                }
-                else if (streamingVersion == 2)
-                {
-                    auto &spar = fxstorage->p[fx_param_remap[i]];
-                    nm = fmt::format("fxp_{:d}", i);
-                    float v = xmlState->getDoubleAttribute(nm, 0.0);
+                // Sessions from before the chain only have slot 0, so the others stay off
+                auto fxt = xmlState->getIntAttribute(juce::String(pfx + "fxt"),
+                                                     slot.index == 0 ? fxt_delay : fxt_off);
+                resetFxType(slot.index, fxt, false);
 
-                    nm = fmt::format("surgevaltype_{:d}", i);
-                    int type = xmlState->getIntAttribute(nm, vt_float);
-
-                    nm = fmt::format("surgeval_{:d}", i);
+                for (int p = 0; p < n_fx_params; ++p)
+                {
+                    auto &spar = storageParam(slot.index * n_fx_params + p);
+                    std::string nm;
 
-                    if (type == vt_int && xmlState->hasAttribute(nm))
+                    if (streamingVersion == 1)
                     {
-                        // Unstream the int as an int. Bools and FLoats are
-                        // fine since they will 01 consistently and properly but
-                        // this means things like add an airwindow and we survive
-                        // going forward
-                        int ival = xmlState->getIntAttribute(nm, 0);
-                        spar.val.i = ival;
+                        nm = pfx + fmt::format("fxp_{:d}", p);
+                        float v = xmlState->getDoubleAttribute(nm, 0.0);
+                        spar.set_value_f01(v);
                     }
-                    else
+                    else if (streamingVersion == 2)
                     {
-                        spar.set_value_f01(v);
+                        nm = pfx + fmt::format("fxp_{:d}", p);
+                        float v = xmlState->getDoubleAttribute(nm, 0.0);
+
+                        nm = pfx + fmt::format("surgevaltype_{:d}", p);
+                        int type = xmlState->getIntAttribute(nm, vt_float);
+
+                        nm = pfx + fmt::format("surgeval_{:d}", p);
+
+                        if (type == vt_int && xmlState->hasAttribute(nm))
+                        {
+                            // Unstream the int as an int. Bools and FLoats are
+                            // fine since they will 01 consistently and properly but
+                            // this means things like add an airwindow and we survive
+                            // going forward
+                            int ival = xmlState->getIntAttribute(nm, 0);
+                            spar.val.i = ival;
+                        }
+                        else
+                        {
+                            spar.set_value_f01(v);
+                        }
                     }
-                }
 
-                // Legacy unstream temposync
-                nm = fmt::format("fxp_temposync_{:d}", i);
+                    // Legacy unstream temposync
+                    nm = pfx + fmt::format("fxp_temposync_{:d}", p);
 
-                if (xmlState->hasAttribute(nm))
-                {
-                    bool b = xmlState->getBoolAttribute(nm, false);
-                    fxstorage->p[fx_param_remap[i]].temposync = b;
+                    if (xmlState->hasAttribute(nm))
+                    {
+                        bool b = xmlState->getBoolAttribute(nm, false);
+                        spar.temposync = b;
+                    }
+
+                    // Modern unstream parameters
+                    nm = pfx + fmt::format("fxp_param_features_{:d}", p);
+
+                    if (xmlState->hasAttribute(nm))
+                    {
+                        int pf = xmlState->getIntAttribute(nm, 0);
+                        paramFeaturesCache[p] = pf;
+                    }
                 }
 
-                // Modern unstream parameters
-                nm = fmt::format("fxp_param_features_{:d}", i);
+                resetFxParams(slot.index, true);
 
-                if (xmlState->hasAttribute(nm))
+                for (int p = 0; p < n_fx_params; ++p)
                 {
-                    int pf = xmlState->getIntAttribute(nm, 0);
-                    paramFeaturesCache[i] = pf;
+                    paramFeatureOntoParam(&storageParam(slot.index * n_fx_params + p),
+                                          paramFeaturesCache[p]);
                 }
-            }
 
-            resetFxParams(true);
-
-            for (int i = 0; i < n_fx_params; ++i)
-            {
-                paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), paramFeaturesCache[i]);
+                updateJuceParamsFromStorage(slot.index);
             }
-
-            updateJuceParamsFromStorage();
         }
     }
 }
 
-void SurgefxAudioProcessor::reorderSurgeParams()
+void SurgefxAudioProcessor::reorderSurgeParams(FXSlot &slot)
 {
-    if (surge_effect.get())
+    auto *fxstorage = slot.fxstorage;
+    auto &fx_param_remap = slot.fx_param_remap;
+
+    if (slot.effect.current)
     {
         for (auto i = 0; i < n_fx_params; ++i)
             fx_param_remap[i] = i;
@@ -694,10 +872,11 @@ void SurgefxAudioProcessor::reorderSurgeParams()
     {
         if (fxstorage->p[fx_param_remap[i]].ctrltype == ct_none)
         {
-            group_names[i] = "-";
+            slot.group_names[i] = "-";
         }
         else
         {
+            auto &surge_effect = slot.effect.current;
             int fpos = fxstorage->p[fx_param_remap[i]].posy / 10 +
                        fxstorage->p[fx_param_remap[i]].posy_offset;
             for (auto j = 0; j < n_fx_params && surge_effect->group_label(j); ++j)
@@ -706,74 +885,207 @@ void SurgefxAudioProcessor::reorderSurgeParams()
                     surge_effect->group_label_ypos(j) <= fpos // constants for SurgeGUIEditor. Sigh.
                 )
                 {
-                    group_names[i] = surge_effect->group_label(j);
+                    slot.group_names[i] = surge_effect->group_label(j);
                 }
             }
         }
     }
 }
 
-void SurgefxAudioProcessor::resetFxType(int type, bool updateJuceParams)
+void SurgefxAudioProcessor::resetFxType(int s, int type, bool updateJuceParams)
 {
+    auto &slot = fxSlots[s];
+
     resettingFx = true;
-    input_position = 0;
-    output_position = -1;
-    effectNum = type;
-    fxstorage->type.val.i = effectNum;
+    slot.requestedFxType = -1;
+    if (s == 0)
+    {
+        input_position = 0;
+        output_position = -1;
+    }
+    slot.effectNum = type;
+    slot.fxstorage->type.val.i = slot.effectNum;
+
+    for (int i = 0; i < n_fx_params; ++i)
+        slot.fxstorage->p[i].set_type(ct_none);
+
+    std::shared_ptr<Effect> fx(spawn_effect(slot.effectNum, storage.get(), slot.fxstorage,
+                                            storage->getPatch().globaldata));
+    if (fx)
+    {
+        copyGlobaldataSubset(slot.storage_id_start, slot.storage_id_end);
+
+        fx->init();
+        fx->init_ctrltypes();
+        fx->init_default_values();
+    }
+
+    // This drops any background change on the way
+    slot.effect.replace(std::move(fx));
+    resetFxParams(s, updateJuceParams);
+}
+
+void SurgefxAudioProcessor::requestFxType(int s, int type)
+{
+    if (!backgroundTypeChange || !audioRunning)
+    {
+        resetFxType(s, type);
+        return;
+    }
+
+    auto &slot = fxSlots[s];
+    slot.requestedFxType = type;
+    *(slot.fxType) = type;
+    servicePrebuild();
+}
+
+void SurgefxAudioProcessor::servicePrebuild()
+{
+    for (auto &slot : fxSlots)
+    {
+        slot.effect.collect();
+
+        if (slot.effect.commit())
+        {
+            commitPrebuiltFx(slot);
+        }
+
+        if (slot.effect.state() == Surge::FX::EffectHandoff::kOffered && !audioRunning)
+        {
+            // Nobody is going to pick it up, so just switch over synchronously
+            resetFxType(slot.index, slot.incomingFxType);
+            continue;
+        }
+
+        if (slot.uiInvalidated.exchange(false))
+        {
+            resetFxParams(slot.index, true);
+        }
+
+        if (!slot.effect.ready())
+            continue;
+
+        int rt = slot.requestedFxType;
+        if (rt >= fxt_off && rt < n_fx_types && rt != slot.effectNum)
+        {
+            prebuildFxType(slot, rt);
+        }
+    }
+}
+
+void SurgefxAudioProcessor::prebuildFxType(FXSlot &slot, int type)
+{
+    slot.incomingFxType = type;
+    slot.incomingFxSlot = 1 - slot.fxSlot;
+
+    auto *fxs = fxStorageFor(slot.index, slot.incomingFxSlot);
+    fxs->type.val.i = type;
 
     for (int i = 0; i < n_fx_params; ++i)
-        fxstorage->p[i].set_type(ct_none);
+    {
+        fxs->p[i].set_type(ct_none);
+    }
 
-    surge_effect.reset(spawn_effect(effectNum, storage.get(), &(storage->getPatch().fx[0]),
-                                    storage->getPatch().globaldata));
-    if (surge_effect)
+    // An empty chain slot is offered as a null effect
+    std::shared_ptr<Effect> fx(
+        spawn_effect(type, storage.get(), fxs, storage->getPatch().globaldata));
+
+    auto range = storageRangeFor(&(fxs->type), &(fxs->p[n_fx_params - 1]));
+
+    if (fx)
     {
-        copyGlobaldataSubset(storage_id_start, storage_id_end);
+        copyGlobaldataSubset(range.first, range.second);
 
-        surge_effect->init();
-        surge_effect->init_ctrltypes();
-        surge_effect->init_default_values();
+        fx->init();
+        fx->init_ctrltypes();
+        fx->init_default_values();
     }
-    resetFxParams(updateJuceParams);
+    else if (type != fxt_off)
+    {
+        slot.requestedFxType = -1;
+        return;
+    }
+
+    for (int i = 0; i < n_fx_params; ++i)
+    {
+        paramFeatureOntoParam(&(fxs->p[i]), 0);
+    }
+
+    // The audio thread won't push params into the incoming slot until we commit, so
+    // the defaults have to reach globaldata now
+    copyGlobaldataSubset(range.first, range.second);
+
+    // Without background type change it's a straight switch, but still not on the audio thread
+    slot.effect.offer(std::move(fx), backgroundTypeChange ? fxCrossfadeBlocks : 0);
+}
+
+void SurgefxAudioProcessor::commitPrebuiltFx(FXSlot &slot)
+{
+    slot.fxSlot = slot.incomingFxSlot;
+    slot.fxstorage = fxStorageFor(slot.index, slot.fxSlot);
+    setupStorageRanges(slot);
+    slot.effectNum = slot.incomingFxType;
+
+    // Don't write the type back to the host; the automation may have already moved on
+    reorderSurgeParams(slot);
+    updateJuceParamsFromStorage(slot.index, false);
+    updateHostDisplay();
 }
 
-void SurgefxAudioProcessor::resetFxParams(bool updateJuceParams)
+void SurgefxAudioProcessor::resetFxParams(int s, bool updateJuceParams)
 {
-    reorderSurgeParams();
+    auto &slot = fxSlots[s];
+
+    reorderSurgeParams(slot);
+    markAllParamsDirty(s);
 
     /*
     ** TempoSync etc settings may linger so whack them all to false again
     */
     for (int i = 0; i < n_fx_params; ++i)
-        paramFeatureOntoParam(&(fxstorage->p[i]), 0);
+        paramFeatureOntoParam(&(slot.fxstorage->p[i]), 0);
 
     if (updateJuceParams)
     {
-        updateJuceParamsFromStorage();
+        updateJuceParamsFromStorage(s);
     }
 
     updateHostDisplay();
     resettingFx = false;
 }
 
-void SurgefxAudioProcessor::updateJuceParamsFromStorage()
+void SurgefxAudioProcessor::updateJuceParamsFromStorage(int s, bool includeFxType)
 {
+    auto &slot = fxSlots[s];
+
     SupressGuard sg(&supressParameterUpdates);
-    for (int i = 0; i < n_fx_params; ++i)
+    for (int p = 0; p < n_fx_params; ++p)
     {
-        *(fxParams[i]) = fxstorage->p[fx_param_remap[i]].get_value_f01();
-        fxParams[i]->mutableName = getParamGroup(i) + " " + getParamName(i);
-        paramFeatures[i] = paramFeatureFromParam(&(fxstorage->p[fx_param_remap[i]]));
+        auto i = s * n_fx_params + p;
+        *(fxParams[i]) = storageParam(i).get_value_f01();
+
+        auto nm = getParamGroup(i) + " " + getParamName(i);
+        if (s > 0)
+            nm = fmt::format("FX {:d} ", s + 1) + nm;
+        fxParams[i]->mutableName = nm;
+
+        paramFeatures[i] = paramFeatureFromParam(&storageParam(i));
     }
-    *(fxType) = effectNum;
+    markAllParamsDirty(s);
 
-    for (int i = 0; i < n_fx_params; ++i)
+    if (includeFxType)
     {
-        changedParamsValue[i] = fxstorage->p[fx_param_remap[i]].get_value_f01();
-        changedParams[i] = true;
+        *(slot.fxType) = slot.effectNum;
     }
-    changedParamsValue[n_fx_params] = effectNum;
-    changedParams[n_fx_params] = true;
+
+    for (int p = 0; p < n_fx_params; ++p)
+    {
+        auto i = s * n_fx_params + p;
+        changedParamsValue[juceIndexForParam(i)] = storageParam(i).get_value_f01();
+        changedParams[juceIndexForParam(i)] = true;
+    }
+    changedParamsValue[juceIndexForType(s)] = slot.effectNum;
+    changedParams[juceIndexForType(s)] = true;
 
     triggerAsyncUpdate();
 }
@@ -783,7 +1095,7 @@ float SurgefxAudioProcessor::getParameterValueForString(int i, const std::string
     if (!canSetParameterByString(i))
         return 0;
 
-    auto *p = &(fxstorage->p[fx_param_remap[i]]);
+    auto *p = &storageParam(i);
 
     pdata v;
     // TODO: range error reporting
@@ -800,18 +1112,18 @@ float SurgefxAudioProcessor::getParameterValueForString(int i, const std::string
 }
 void SurgefxAudioProcessor::setParameterByString(int i, const std::string &s)
 {
-    auto *p = &(fxstorage->p[fx_param_remap[i]]);
+    auto *p = &storageParam(i);
     // TODO: range error reporting
     std::string errMsg;
     p->set_value_from_string(s, errMsg);
-    *(fxParams[i]) = fxstorage->p[fx_param_remap[i]].get_value_f01();
-    changedParamsValue[i] = fxstorage->p[fx_param_remap[i]].get_value_f01();
+    *(fxParams[i]) = storageParam(i).get_value_f01();
+    changedParamsValue[juceIndexForParam(i)] = storageParam(i).get_value_f01();
     triggerAsyncUpdate();
 }
 
 bool SurgefxAudioProcessor::canSetParameterByString(int i)
 {
-    auto *p = &(fxstorage->p[fx_param_remap[i]]);
+    auto *p = &storageParam(i);
     return p->can_setvalue_from_string();
 }
 
@@ -823,7 +1135,15 @@ void SurgefxAudioProcessor::copyGlobaldataSubset(int start, int end)
     }
 }
 
-void SurgefxAudioProcessor::setupStorageRanges(Parameter *start, Parameter *endIncluding)
+void SurgefxAudioProcessor::setupStorageRanges(FXSlot &slot)
+{
+    auto range = storageRangeFor(&(slot.fxstorage->type), &(slot.fxstorage->p[n_fx_params - 1]));
+    slot.storage_id_start = range.first;
+    slot.storage_id_end = range.second;
+}
+
+std::pair<int, int> SurgefxAudioProcessor::storageRangeFor(Parameter *start,
+                                                           Parameter *endIncluding)
 {
     int min_id = 100000, max_id = -1;
     Parameter *oap = start;
@@ -839,24 +1159,26 @@ void SurgefxAudioProcessor::setupStorageRanges(Parameter *start, Parameter *endI
         oap++;
     }
 
-    storage_id_start = min_id;
-    storage_id_end = max_id + 1;
+    return {min_id, max_id + 1};
 }
 
 void SurgefxAudioProcessor::prepareParametersAbsentAudio()
 {
     if (!audioRunning)
     {
-        if (getEffectType() == fxt_airwindows)
+        for (auto &slot : fxSlots)
         {
-            /*
-             * Airwindows needs to set up its internal state with a process
-             * See #6897
-             */
-            float dL alignas(16)[BLOCK_SIZE], dR alignas(16)[BLOCK_SIZE];
-            memset(dL, 0, sizeof(dL));
-            memset(dR, 0, sizeof(dR));
-            surge_effect->process_ringout(dL, dR);
+            if (slot.effectNum == fxt_airwindows && slot.effect.current)
+            {
+                /*
+                 * Airwindows needs to set up its internal state with a process
+                 * See #6897
+                 */
+                float dL alignas(16)[BLOCK_SIZE], dR alignas(16)[BLOCK_SIZE];
+                memset(dL, 0, sizeof(dL));
+                memset(dR, 0, sizeof(dR));
+                slot.effect.current->process_ringout(dL, dR);
+            }
         }
     }
 }
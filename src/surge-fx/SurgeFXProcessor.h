@@ -25,7 +25,9 @@
 
 #include "SurgeStorage.h"
 #include "Effect.h"
+#include "EffectHandoff.h"
 #include "FXOpenSoundControl.h"
+#include <array>
 #include <atomic>
 #include "sst/filters/HalfRateFilter.h"
 
@@ -47,6 +49,23 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
     SurgefxAudioProcessor();
     ~SurgefxAudioProcessor();
 
+    /*
+     * The processor runs a chain of up to n_chain_slots effects back to back on the same
+     * block buffers, all sharing one SurgeStorage. Slot 0 is the classic single effect and
+     * always runs; the others default to off. FX params are addressed by a paged index,
+     * slot * n_fx_params + param. Each slot's JUCE params (its values followed by its type)
+     * are added in slot order, so slot 0 keeps the historic parameter layout and ids.
+     */
+    static constexpr int n_chain_slots = 4;
+    static constexpr int n_chain_params = n_chain_slots * n_fx_params;
+    static constexpr int n_juce_params = n_chain_slots * (n_fx_params + 1);
+    static int slotForParam(int i) { return i / n_fx_params; }
+    static int juceIndexForParam(int i)
+    {
+        return slotForParam(i) * (n_fx_params + 1) + i % n_fx_params;
+    }
+    static int juceIndexForType(int slot) { return slot * (n_fx_params + 1) + n_fx_params; }
+
     float input_buffer alignas(16)[2][BLOCK_SIZE];
     float sidechain_buffer alignas(16)[2][BLOCK_SIZE];
     float output_buffer alignas(16)[2][BLOCK_SIZE];
@@ -54,6 +73,13 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
     int output_position{-1};
 
     bool nonLatentBlockMode{true};
+    // What the user asked for; nonLatentBlockMode drops to false when the host misaligns
+    bool preferNonLatentBlockMode{true};
+    // The audio thread returns to zero latency after this many aligned blocks, but only once
+    // between prepareToPlay calls, so a host misaligning on every loop can't make it flip
+    int alignedHostBlocks{0};
+    bool nonLatentReentryUsed{false};
+    static constexpr int alignedHostBlocksBeforeNonLatent = 64;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
@@ -118,11 +144,24 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
     void getStateInformation(juce::MemoryBlock &destData) override;
     void setStateInformation(const void *data, int sizeInBytes) override;
 
-    int getEffectType() { return effectNum; }
-    float getFXStorageValue01(int i) { return fxstorage->p[fx_param_remap[i]].get_value_f01(); }
+    int getEffectType(int slot = 0) { return fxSlots[slot].effectNum; }
+    float getFXStorageValue01(int i) { return storageParam(i).get_value_f01(); }
     float getFXParamValue01(int i) { return *(fxParams[i]); }
     void setFXParamValue01(int i, float f) { *(fxParams[i]) = f; }
 
+    /*
+     * Parameters whose JUCE value or features changed since the audio thread last pushed
+     * them into fxstorage. Set from parameterValueChanged (which also covers the OSC path,
+     * since that goes through setFXParamValue01) and the feature setters.
+     */
+    static_assert(n_fx_params <= 32, "dirtyParams is a 32 bit mask");
+    static constexpr uint32_t allParamsDirty = (1ULL << n_fx_params) - 1;
+    void markParamDirty(int i)
+    {
+        fxSlots[slotForParam(i)].dirtyParams.fetch_or(1U << (i % n_fx_params));
+    }
+    void markAllParamsDirty(int slot) { fxSlots[slot].dirtyParams = allParamsDirty; }
+
     void setFXParamTempoSync(int i, bool b)
     {
         int v = paramFeatures[i];
@@ -131,12 +170,13 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         else
             v = v & ~kTempoSync;
         paramFeatures[i] = v;
+        markParamDirty(i);
     }
 
     bool getFXParamTempoSync(int i) { return (paramFeatures[i]) & kTempoSync; }
-    void setFXStorageTempoSync(int i, bool b) { fxstorage->p[fx_param_remap[i]].temposync = b; }
-    bool getFXStorageTempoSync(int i) { return fxstorage->p[fx_param_remap[i]].temposync; }
-    bool canTempoSync(int i) { return fxstorage->p[fx_param_remap[i]].can_temposync(); }
+    void setFXStorageTempoSync(int i, bool b) { storageParam(i).temposync = b; }
+    bool getFXStorageTempoSync(int i) { return storageParam(i).temposync; }
+    bool canTempoSync(int i) { return storageParam(i).can_temposync(); }
 
     void setFXParamExtended(int i, bool b)
     {
@@ -146,14 +186,15 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         else
             v = v & ~kExtended;
         paramFeatures[i] = v;
+        markParamDirty(i);
     }
     bool getFXParamExtended(int i) { return paramFeatures[i] & kExtended; }
     void setFXStorageExtended(int i, bool b)
     {
-        fxstorage->p[fx_param_remap[i]].set_extend_range(b);
+        storageParam(i).set_extend_range(b);
     }
-    bool getFXStorageExtended(int i) { return fxstorage->p[fx_param_remap[i]].extend_range; }
-    bool canExtend(int i) { return fxstorage->p[fx_param_remap[i]].can_extend_range(); }
+    bool getFXStorageExtended(int i) { return storageParam(i).extend_range; }
+    bool canExtend(int i) { return storageParam(i).can_extend_range(); }
 
     void setFXParamAbsolute(int i, bool b)
     {
@@ -163,11 +204,12 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         else
             v = v & ~kAbsolute;
         paramFeatures[i] = v;
+        markParamDirty(i);
     }
     bool getFXParamAbsolute(int i) { return paramFeatures[i] & kAbsolute; }
-    void setFXStorageAbsolute(int i, bool b) { fxstorage->p[fx_param_remap[i]].absolute = b; }
-    bool getFXStorageAbsolute(int i) { return fxstorage->p[fx_param_remap[i]].absolute; }
-    bool canAbsolute(int i) { return fxstorage->p[fx_param_remap[i]].can_be_absolute(); }
+    void setFXStorageAbsolute(int i, bool b) { storageParam(i).absolute = b; }
+    bool getFXStorageAbsolute(int i) { return storageParam(i).absolute; }
+    bool canAbsolute(int i) { return storageParam(i).can_be_absolute(); }
 
     void setFXParamDeactivated(int i, bool b)
     {
@@ -177,18 +219,24 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         else
             v = v & ~kDeactivated;
         paramFeatures[i] = v;
+        markParamDirty(i);
     }
     bool getFXParamDeactivated(int i) { return paramFeatures[i] & kDeactivated; }
-    void setFXStorageDeactivated(int i, bool b) { fxstorage->p[fx_param_remap[i]].deactivated = b; }
-    bool getFXStorageDeactivated(int i) { return fxstorage->p[fx_param_remap[i]].deactivated; }
+    void setFXStorageDeactivated(int i, bool b) { storageParam(i).deactivated = b; }
+    bool getFXStorageDeactivated(int i) { return storageParam(i).deactivated; }
     bool getFXStorageAppearsDeactivated(int i)
     {
-        return fxstorage->p[fx_param_remap[i]].appears_deactivated();
+        return storageParam(i).appears_deactivated();
     }
-    bool canDeactitvate(int i) { return fxstorage->p[fx_param_remap[i]].can_deactivate(); }
+    bool canDeactitvate(int i) { return storageParam(i).can_deactivate(); }
 
     virtual void parameterValueChanged(int parameterIndex, float newValue) override
     {
+        auto slot = parameterIndex / (n_fx_params + 1);
+        auto param = parameterIndex % (n_fx_params + 1);
+        if (param < n_fx_params)
+            markParamDirty(slot * n_fx_params + param);
+
         if (supressParameterUpdates)
             return;
 
@@ -205,8 +253,9 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
 
     virtual void handleAsyncUpdate() override
     {
+        servicePrebuild();
         paramChangeListener();
-        for (int i = 0; i < n_fx_params; ++i)
+        for (int i = 0; i < n_chain_params; ++i)
             if (wasParamFeatureChanged[i])
             {
                 wasParamFeatureChanged[i] = false;
@@ -215,27 +264,29 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
 
     void setParameterChangeListener(std::function<void()> l) { paramChangeListener = l; }
 
-    // Call this from the UI thread
-    void copyChangeValues(bool *c, float *f)
+    // Call this from the UI thread. Fills n_fx_params values followed by the type for a slot.
+    void copyChangeValues(int slot, bool *c, float *f)
     {
+        auto base = slot * (n_fx_params + 1);
         for (int i = 0; i < n_fx_params + 1; ++i)
         {
-            c[i] = changedParams[i];
-            changedParams[i] = false;
-            f[i] = changedParamsValue[i];
+            c[i] = changedParams[base + i];
+            changedParams[base + i] = false;
+            f[i] = changedParamsValue[base + i];
         }
     }
 
     virtual void setUserEditingFXParam(int i, bool isEd)
     {
-        isUserEditing[i] = isEd;
+        auto ji = juceIndexForParam(i);
+        isUserEditing[ji] = isEd;
         if (isEd)
         {
-            fxBaseParams[i]->beginChangeGesture();
+            fxBaseParams[ji]->beginChangeGesture();
         }
         else
         {
-            fxBaseParams[i]->endChangeGesture();
+            fxBaseParams[ji]->endChangeGesture();
         }
     }
 
@@ -267,53 +318,69 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
     }
 
     // Information about parameter strings
-    bool getParamEnabled(int i) { return fxstorage->p[fx_param_remap[i]].ctrltype != ct_none; }
-    std::string getParamGroup(int i) { return group_names[i]; }
+    bool getParamEnabled(int i) { return storageParam(i).ctrltype != ct_none; }
+    std::string getParamGroup(int i)
+    {
+        return fxSlots[slotForParam(i)].group_names[i % n_fx_params];
+    }
 
     std::string getParamName(int i)
     {
-        if (fxstorage->p[fx_param_remap[i]].ctrltype == ct_none)
+        if (storageParam(i).ctrltype == ct_none)
             return "-";
 
-        return fxstorage->p[fx_param_remap[i]].get_name();
+        return storageParam(i).get_name();
     }
 
     std::string getParamValue(int i)
     {
-        if (fxstorage->p[fx_param_remap[i]].ctrltype == ct_none)
+        if (storageParam(i).ctrltype == ct_none)
         {
             return "-";
         }
 
-        return fxstorage->p[fx_param_remap[i]].get_display(false, 0);
+        return storageParam(i).get_display(false, 0);
     }
 
     std::string getParamValueFor(int idx, float f)
     {
-        if (fxstorage->p[fx_param_remap[idx]].ctrltype == ct_none)
+        if (storageParam(idx).ctrltype == ct_none)
         {
             return "-";
         }
 
-        return fxstorage->p[fx_param_remap[idx]].get_display(true, f);
+        return storageParam(idx).get_display(true, f);
     }
 
     std::string getParamValueFromFloat(int i, float f)
     {
-        if (fxstorage->p[fx_param_remap[i]].ctrltype == ct_none)
+        if (storageParam(i).ctrltype == ct_none)
         {
             return "-";
         }
 
-        fxstorage->p[fx_param_remap[i]].set_value_f01(f);
+        storageParam(i).set_value_f01(f);
 
-        return fxstorage->p[fx_param_remap[i]].get_display(false, 0);
+        return storageParam(i).get_display(false, 0);
     }
 
-    void updateJuceParamsFromStorage();
+    void updateJuceParamsFromStorage(int slot, bool includeFxType = true);
+
+    void resetFxType(int slot, int t, bool updateJuceParams = true);
+    void resetFxParams(int slot, bool updateJuceParams = true);
 
-    void resetFxType(int t, bool updateJuceParams = true);
-    void resetFxParams(bool updateJuceParams = true);
+    /*
+     * Change the FX type from the UI. In background type change mode the new effect is
+     * built and initialized on the message thread, handed over to the audio thread,
+     * crossfaded in over fxCrossfadeBlocks blocks, and the outgoing effect is freed back
+     * on the message thread. Otherwise (or if audio isn't running) this is just
+     * resetFxType, which hands the audio thread the new effect at its next block. Type
+     * changes from the host go the same way, without the crossfade if background type
+     * change is off, so the audio thread never spawns or frees an effect.
+     */
+    void requestFxType(int slot, int t);
+    bool backgroundTypeChange{true};
+    static constexpr int fxCrossfadeBlocks = 8;
 
     // Members for the FX. If this looks a lot like surge-rack/SurgeFX.hpp that's not a coincidence
     std::unique_ptr<SurgeStorage> storage;
@@ -352,14 +419,13 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
     };
 
     //==============================================================================
-    juce::AudioProcessorParameter *fxBaseParams[2 * n_fx_params + 1];
+    juce::AudioProcessorParameter *fxBaseParams[n_juce_params];
 
     // These are just copyes of the pointer from above with the cast done to make the code look
     // nicer
     typedef FXAudioParameter<juce::AudioParameterFloat, float> float_param_t;
     typedef FXAudioParameter<juce::AudioParameterInt, int> int_param_t;
-    float_param_t *fxParams[n_fx_params];
-    int_param_t *fxType;
+    float_param_t *fxParams[n_chain_params];
 
     enum ParamFeatureFlags
     {
@@ -368,11 +434,12 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         kAbsolute = 1U << 2U,
         kDeactivated = 1U << 3U
     };
-    std::atomic<int> paramFeatures[n_fx_params];
-    std::atomic<bool> changedParams[n_fx_params + 1];
-    std::atomic<float> changedParamsValue[n_fx_params + 1];
-    std::atomic<bool> isUserEditing[n_fx_params + 1];
-    std::atomic<bool> wasParamFeatureChanged[n_fx_params];
+    std::atomic<int> paramFeatures[n_chain_params];
+    // These three are indexed by JUCE parameter index
+    std::atomic<bool> changedParams[n_juce_params];
+    std::atomic<float> changedParamsValue[n_juce_params];
+    std::atomic<bool> isUserEditing[n_juce_params];
+    std::atomic<bool> wasParamFeatureChanged[n_chain_params];
     std::function<void()> paramChangeListener;
 
     float lastBPM = -1;
@@ -388,20 +455,69 @@ class SurgefxAudioProcessor : public juce::AudioProcessor,
         ~SupressGuard() { *s = false; }
     };
 
-    std::shared_ptr<Effect> surge_effect;
-    std::shared_ptr<Effect> audio_thread_surge_effect;
     std::atomic<bool> resettingFx;
-    FxStorage *fxstorage;
-    int storage_id_start, storage_id_end;
 
-    int effectNum;
+    struct FXSlot
+    {
+        int index{0};
+        // read by the audio thread to spot type changes, which the message thread makes
+        std::atomic<int> effectNum{fxt_off};
+
+        /*
+         * Each slot alternates between two entries of the patch fx[] array so that an
+         * incoming effect can be initialized without touching the running one's params.
+         * Slot n uses fx[2n] and fx[2n + 1].
+         */
+        int fxSlot{0};
+        FxStorage *fxstorage{nullptr};
+        int storage_id_start{0}, storage_id_end{0};
+
+        int fx_param_remap[n_fx_params];
+        std::string group_names[n_fx_params];
+
+        /*
+         * effect.current is the message thread's; the audio thread only runs what the handoff
+         * has passed it, so effects are only ever built and freed on the message thread.
+         */
+        Surge::FX::EffectHandoff effect;
+        int_param_t *fxType{nullptr};
+
+        std::atomic<uint32_t> dirtyParams{allParamsDirty};
+
+        std::atomic<int> requestedFxType{-1};
+        std::atomic<bool> uiInvalidated{false};
+        int incomingFxType{fxt_off}, incomingFxSlot{1};
+    };
+    std::array<FXSlot, n_chain_slots> fxSlots;
+
+    Parameter &storageParam(int i)
+    {
+        auto &slot = fxSlots[slotForParam(i)];
+        return slot.fxstorage->p[slot.fx_param_remap[i % n_fx_params]];
+    }
+    FxStorage *fxStorageFor(int slot, int fxSlot)
+    {
+        return &(storage->getPatch().fx[2 * slot + fxSlot]);
+    }
+    bool anySlotRuns(int type) const
+    {
+        for (const auto &s : fxSlots)
+            if (s.effectNum == type)
+                return true;
+        return false;
+    }
 
-    int fx_param_remap[n_fx_params];
-    std::string group_names[n_fx_params];
+    void servicePrebuild();
+    void prebuildFxType(FXSlot &slot, int type);
+    void commitPrebuiltFx(FXSlot &slot);
+    void processChainBlock(float *dataL, float *dataR);
+    void processEffectBlock(FXSlot &slot, float *dataL, float *dataR);
+    void pushParamsToStorage(FXSlot &slot);
 
-    void reorderSurgeParams();
+    void reorderSurgeParams(FXSlot &slot);
     void copyGlobaldataSubset(int start, int end);
-    void setupStorageRanges(Parameter *start, Parameter *endIncluding);
+    void setupStorageRanges(FXSlot &slot);
+    static std::pair<int, int> storageRangeFor(Parameter *start, Parameter *endIncluding);
 
     std::atomic<bool> audioRunning{false};
 
@@ -23,6 +23,9 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <thread>
 #include <utility>
 
@@ -135,6 +138,128 @@ struct SurgePyModRouting
     float normalizedDepth;
 };
 
+/*
+ * One event for renderBatch, at a sample position counted from the start of the output array.
+ * Note ons and controllers land on that exact sample; parameter and modulation depth changes
+ * land at the start of the block which contains it.
+ */
+struct SurgePyRenderEvent
+{
+    enum Type
+    {
+        NOTE_ON,
+        NOTE_OFF,
+        PITCH_BEND,
+        CONTROLLER,
+        PARAM_VAL,
+        MOD_DEPTH
+    } type = NOTE_ON;
+
+    int64_t sample = 0;
+    int channel = 0;
+    int key = 0;   // the note, or the CC number
+    int value = 0; // the velocity, bend or CC value
+    int detune = 0;
+
+    SurgePyNamedParam param;
+    SurgePyModSource modSource;
+    float fvalue = 0.f; // the parameter value, or the modulation depth
+    int modScene = 0;
+    int modIndex = 0;
+
+    static SurgePyRenderEvent make(Type t, int64_t sample)
+    {
+        auto r = SurgePyRenderEvent();
+        r.type = t;
+        r.sample = sample;
+        return r;
+    }
+
+    static SurgePyRenderEvent noteOn(int64_t sample, int ch, int note, int vel, int detune)
+    {
+        auto r = make(NOTE_ON, sample);
+        r.channel = ch;
+        r.key = note;
+        r.value = vel;
+        r.detune = detune;
+        return r;
+    }
+
+    static SurgePyRenderEvent noteOff(int64_t sample, int ch, int note, int vel)
+    {
+        auto r = make(NOTE_OFF, sample);
+        r.channel = ch;
+        r.key = note;
+        r.value = vel;
+        return r;
+    }
+
+    static SurgePyRenderEvent pitchBend(int64_t sample, int ch, int bend)
+    {
+        auto r = make(PITCH_BEND, sample);
+        r.channel = ch;
+        r.value = bend;
+        return r;
+    }
+
+    static SurgePyRenderEvent controller(int64_t sample, int ch, int cc, int val)
+    {
+        auto r = make(CONTROLLER, sample);
+        r.channel = ch;
+        r.key = cc;
+        r.value = val;
+        return r;
+    }
+
+    static SurgePyRenderEvent paramVal(int64_t sample, const SurgePyNamedParam &p, float f)
+    {
+        auto r = make(PARAM_VAL, sample);
+        r.param = p;
+        r.fvalue = f;
+        return r;
+    }
+
+    static SurgePyRenderEvent modDepth(int64_t sample, const SurgePyNamedParam &to,
+                                       const SurgePyModSource &from, float depth, int scene,
+                                       int index)
+    {
+        auto r = make(MOD_DEPTH, sample);
+        r.param = to;
+        r.modSource = from;
+        r.fvalue = depth;
+        r.modScene = scene;
+        r.modIndex = index;
+        return r;
+    }
+
+    int64_t getSample() const { return sample; }
+
+    std::string toString() const
+    {
+        static const char *names[] = {"noteOn",      "noteOff",          "pitchBend",
+                                      "channelController", "setParamVal", "setModDepth01"};
+        std::ostringstream oss;
+        oss << "<SurgeRenderEvent " << names[type] << " sample=" << sample;
+
+        switch (type)
+        {
+        case PARAM_VAL:
+            oss << " param='" << param.name << "' value=" << fvalue;
+            break;
+        case MOD_DEPTH:
+            oss << " param='" << param.name << "' source='" << modSource.name
+                << "' depth=" << fvalue;
+            break;
+        default:
+            oss << " channel=" << channel << " key=" << key << " value=" << value;
+            break;
+        }
+
+        oss << ">";
+        return oss.str();
+    }
+};
+
 class SurgePyPatchConverter
 {
   public:
@@ -887,6 +1012,129 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         }
     }
 
+    /*
+     * Checks a renderBatch output array and event list, and sorts the events by sample (keeping
+     * the given order for events on the same sample). Returns the start of the array, whose
+     * blocks are set in nBlocks. Needs the GIL.
+     */
+    /*
+     * Takes a plain py::array rather than py::array_t<float>, which would quietly render into
+     * a converted copy of a float64 or strided array and leave the caller's one untouched.
+     */
+    float *prepareRenderBatch(std::vector<SurgePyRenderEvent> &events, const py::array &arr,
+                              int &nBlocks)
+    {
+        if (!arr.dtype().is(py::dtype::of<float>()))
+        {
+            throw py::type_error("Output numpy array must be float32, like createMultiBlock "
+                                 "makes; other dtypes would be rendered into a copy");
+        }
+
+        if (!(arr.flags() & py::array::c_style) || !arr.writeable())
+        {
+            throw py::type_error("Output numpy array must be C-contiguous and writeable, like "
+                                 "createMultiBlock makes");
+        }
+
+        auto buf = arr.request(true);
+
+        if (buf.ndim != 2 || buf.shape[0] != 2 || buf.shape[1] % BLOCK_SIZE != 0 ||
+            buf.strides[0] != buf.shape[1] * sizeof(float) || buf.strides[1] != sizeof(float))
+        {
+            std::ostringstream oss;
+            oss << "Output numpy array must be a C-contiguous float32 array with dimensions "
+                   "(2, m*BLOCK_SIZE), like createMultiBlock makes";
+            throw std::invalid_argument(oss.str().c_str());
+        }
+
+        for (const auto &e : events)
+        {
+            if (e.sample < 0 || e.sample >= buf.shape[1])
+            {
+                std::ostringstream oss;
+                oss << "Event at sample " << e.sample << " is outside the output array with "
+                    << buf.shape[1] << " samples";
+                throw std::invalid_argument(oss.str().c_str());
+            }
+        }
+
+        std::stable_sort(events.begin(), events.end(),
+                         [](const auto &a, const auto &b) { return a.sample < b.sample; });
+
+        nBlocks = buf.shape[1] / BLOCK_SIZE;
+
+        return static_cast<float *>(buf.ptr);
+    }
+
+    void applyRenderEvent(const SurgePyRenderEvent &e)
+    {
+        switch (e.type)
+        {
+        case SurgePyRenderEvent::NOTE_ON:
+            playNote(e.channel, e.key, e.value, e.detune);
+            break;
+        case SurgePyRenderEvent::NOTE_OFF:
+            releaseNote(e.channel, e.key, e.value);
+            break;
+        case SurgePyRenderEvent::PITCH_BEND:
+            pitchBend(e.channel, e.value);
+            break;
+        case SurgePyRenderEvent::CONTROLLER:
+            channelController(e.channel, e.key, e.value);
+            break;
+        case SurgePyRenderEvent::PARAM_VAL:
+            setParamVal(e.param, e.fvalue);
+            break;
+        case SurgePyRenderEvent::MOD_DEPTH:
+            setModulationPy(e.param, e.modSource, e.fvalue, e.modScene, e.modIndex);
+            break;
+        }
+    }
+
+    /*
+     * Renders nBlocks into the (2, nBlocks*BLOCK_SIZE) array at ptr, applying the sorted events
+     * as it goes. Touches nothing Python owns, so it is run without the GIL.
+     */
+    void renderEvents(const std::vector<SurgePyRenderEvent> &events, float *ptr, int nBlocks)
+    {
+        float *dL = ptr;
+        float *dR = ptr + nBlocks * BLOCK_SIZE;
+        auto ev = events.begin();
+
+        process_input = false;
+
+        for (auto i = 0; i < nBlocks; ++i)
+        {
+            int64_t blockStart = (int64_t)i * BLOCK_SIZE;
+
+            while (ev != events.end() && ev->sample < blockStart + BLOCK_SIZE)
+            {
+                eventSampleOffset = (int)(ev->sample - blockStart);
+                applyRenderEvent(*ev);
+                ++ev;
+            }
+
+            eventSampleOffset = 0;
+
+            process();
+            time_data.ppqPos += (double)BLOCK_SIZE * time_data.tempo / (60. * storage.samplerate);
+            memcpy((void *)dL, (void *)(output[0]), BLOCK_SIZE * sizeof(float));
+            memcpy((void *)dR, (void *)(output[1]), BLOCK_SIZE * sizeof(float));
+
+            dL += BLOCK_SIZE;
+            dR += BLOCK_SIZE;
+        }
+    }
+
+    void renderBatch(std::vector<SurgePyRenderEvent> events, const py::array &arr)
+    {
+        int nBlocks = 0;
+        auto ptr = prepareRenderBatch(events, arr, nBlocks);
+
+        py::gil_scoped_release release;
+        renderEvents(events, ptr, nBlocks);
+    }
+
     py::dict getPatchAsPy()
     {
         auto pc = SurgePyPatchConverter(this);
@@ -1048,6 +1296,86 @@ SurgeSynthesizer *createSurge(float sr)
     return surge;
 }
 
+/*
+ * renderBatch for many instances at once, each on its own events and output array, spread over
+ * a pool of threads with the GIL released. An instance is only ever rendered by one thread, so
+ * this is no less safe than rendering them one after the other.
+ */
+void renderBatchParallel(const std::vector<SurgeSynthesizerWithPythonExtensions *> &synths,
+                         std::vector<std::vector<SurgePyRenderEvent>> events,
+                         const std::vector<py::array> &outputs, int threads)
+{
+    if (events.size() != synths.size() || outputs.size() != synths.size())
+    {
+        throw std::invalid_argument("renderBatchParallel needs one event list and one output "
+                                    "array for each synth");
+    }
+
+    for (auto i = 0U; i < synths.size(); ++i)
+    {
+        if (!synths[i] || std::count(synths.begin(), synths.end(), synths[i]) > 1)
+        {
+            throw std::invalid_argument("renderBatchParallel needs a distinct synth for each job");
+        }
+    }
+
+    std::vector<float *> ptrs(synths.size());
+    std::vector<int> nBlocks(synths.size());
+
+    for (auto i = 0U; i < synths.size(); ++i)
+    {
+        ptrs[i] = synths[i]->prepareRenderBatch(events[i], outputs[i], nBlocks[i]);
+    }
+
+    if (threads <= 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    threads = std::min(threads, (int)synths.size());
+
+    py::gil_scoped_release release;
+
+    std::atomic<size_t> next{0};
+    std::vector<std::exception_ptr> errors(synths.size());
+
+    auto work = [&]() {
+        for (auto i = next++; i < synths.size(); i = next++)
+        {
+            try
+            {
+                synths[i]->renderEvents(events[i], ptrs[i], nBlocks[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (auto t = 1; t < threads; ++t)
+    {
+        pool.emplace_back(work);
+    }
+
+    work();
+
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+
+    for (auto &e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
 // Prefix _ if using shared object within a Python package built with scikit-build
 #ifdef SKBUILD
 PYBIND11_MODULE(_surgepy, m)
@@ -1059,6 +1387,10 @@ PYBIND11_MODULE(surgepy, m)
     m.def("createSurge", &createSurge, "Create a Surge XT instance", py::arg("sampleRate"));
     m.def(
         "getVersion", []() { return Surge::Build::FullVersionStr; }, "Get the version of Surge XT");
+    m.def("renderBatchParallel", &renderBatchParallel,
+          "Run renderBatch on many Surge XT instances at once, across a pool of threads with the "
+          "GIL released. Each instance gets the event list and output array at the same index.",
+          py::arg("synths"), py::arg("events"), py::arg("outputs"), py::arg("threads") = 0);
     py::class_<SurgeSynthesizer::ID>(m, "SurgeSynthesizer_ID")
         .def(py::init<>())
         .def("getSynthSideId", &SurgeSynthesizer::ID::getSynthSideId)
@@ -1180,6 +1512,10 @@ PYBIND11_MODULE(surgepy, m)
              "entire array, or starting at startBlock position in the output, populate nBlocks.",
              py::arg("inVal"), py::arg("outVal"), py::arg("startBlock") = 0,
              py::arg("nBlocks") = -1)
+        .def("renderBatch", &SurgeSynthesizerWithPythonExtensions::renderBatch,
+             "Render the whole of a createMultiBlock array with the GIL released, applying a list "
+             "of SurgeRenderEvents at their sample positions as it goes.",
+             py::arg("events"), py::arg("outVal").noconvert())
 
         .def("getPatch", &SurgeSynthesizerWithPythonExtensions::getPatchAsPy,
              "Get a Python dictionary with the Surge XT parameters laid out in the logical patch "
@@ -1225,6 +1561,29 @@ PYBIND11_MODULE(surgepy, m)
         .def("getName", &SurgePyModSource::getName)
         .def("__repr__", &SurgePyModSource::toString);
 
+    py::class_<SurgePyRenderEvent>(m, "SurgeRenderEvent")
+        .def_static("noteOn", &SurgePyRenderEvent::noteOn, "Play a note at this sample",
+                    py::arg("sample"), py::arg("channel"), py::arg("midiNote"),
+                    py::arg("velocity"), py::arg("detune") = 0)
+        .def_static("noteOff", &SurgePyRenderEvent::noteOff, "Release a note at this sample",
+                    py::arg("sample"), py::arg("channel"), py::arg("midiNote"),
+                    py::arg("releaseVelocity") = 0)
+        .def_static("pitchBend", &SurgePyRenderEvent::pitchBend,
+                    "Set the pitch bend on a channel at this sample", py::arg("sample"),
+                    py::arg("channel"), py::arg("bend"))
+        .def_static("channelController", &SurgePyRenderEvent::controller,
+                    "Set a MIDI controller on a channel at this sample", py::arg("sample"),
+                    py::arg("channel"), py::arg("cc"), py::arg("value"))
+        .def_static("setParamVal", &SurgePyRenderEvent::paramVal,
+                    "Set a parameter value at the start of the block holding this sample",
+                    py::arg("sample"), py::arg("param"), py::arg("toThis"))
+        .def_static("setModDepth01", &SurgePyRenderEvent::modDepth,
+                    "Set a modulation depth at the start of the block holding this sample",
+                    py::arg("sample"), py::arg("targetParameter"), py::arg("modulationSource"),
+                    py::arg("depth"), py::arg("scene") = 0, py::arg("index") = 0)
+        .def("getSample", &SurgePyRenderEvent::getSample)
+        .def("__repr__", &SurgePyRenderEvent::toString);
+
     py::class_<SurgePyModRouting>(m, "SurgeModRouting")
         .def("getSource", [](const SurgePyModRouting &r) { return r.source; })
         .def("getDest", [](const SurgePyModRouting &r) { return r.dest; })
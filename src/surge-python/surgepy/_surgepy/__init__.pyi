@@ -5,7 +5,7 @@ from __future__ import annotations
 import numpy
 import typing
 from . import constants
-__all__ = ['SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getVersion']
+__all__ = ['SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeRenderEvent', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getVersion', 'renderBatchParallel']
 class SurgeControlGroup:
     def __repr__(self) -> str:
         ...
@@ -53,6 +53,41 @@ class SurgeNamedParamId:
         ...
     def getName(self) -> str:
         ...
+class SurgeRenderEvent:
+    @staticmethod
+    def channelController(sample: int, channel: int, cc: int, value: int) -> SurgeRenderEvent:
+        """
+        Set a MIDI controller on a channel at this sample
+        """
+    @staticmethod
+    def noteOff(sample: int, channel: int, midiNote: int, releaseVelocity: int = 0) -> SurgeRenderEvent:
+        """
+        Release a note at this sample
+        """
+    @staticmethod
+    def noteOn(sample: int, channel: int, midiNote: int, velocity: int, detune: int = 0) -> SurgeRenderEvent:
+        """
+        Play a note at this sample
+        """
+    @staticmethod
+    def pitchBend(sample: int, channel: int, bend: int) -> SurgeRenderEvent:
+        """
+        Set the pitch bend on a channel at this sample
+        """
+    @staticmethod
+    def setModDepth01(sample: int, targetParameter: SurgeNamedParamId, modulationSource: SurgeModSource, depth: float, scene: int = 0, index: int = 0) -> SurgeRenderEvent:
+        """
+        Set a modulation depth at the start of the block holding this sample
+        """
+    @staticmethod
+    def setParamVal(sample: int, param: SurgeNamedParamId, toThis: float) -> SurgeRenderEvent:
+        """
+        Set a parameter value at the start of the block holding this sample
+        """
+    def __repr__(self) -> str:
+        ...
+    def getSample(self) -> int:
+        ...
 class SurgeSynthesizer:
     mpeEnabled: bool
     tuningApplicationMode: ...
@@ -205,6 +240,10 @@ class SurgeSynthesizer:
         """
         Return to standard C-centered keyboard mapping
         """
+    def renderBatch(self, events: list[SurgeRenderEvent], outVal: numpy.ndarray[numpy.float32]) -> None:
+        """
+        Render the whole of a createMultiBlock array with the GIL released, applying a list of SurgeRenderEvents at their sample positions as it goes.
+        """
     def retuneToStandardScale(self) -> None:
         """
         Return this instance to 12-TET Scale
@@ -277,3 +316,7 @@ def getVersion() -> str:
     """
     Get the version of Surge XT
     """
+def renderBatchParallel(synths: list[SurgeSynthesizer], events: list[list[SurgeRenderEvent]], outputs: list[numpy.ndarray[numpy.float32]], threads: int = 0) -> None:
+    """
+    Run renderBatch on many Surge XT instances at once, across a pool of threads with the GIL released. Each instance gets the event list and output array at the same index.
+    """
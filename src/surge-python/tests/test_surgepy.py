@@ -3,6 +3,7 @@ Tests for Surge XT Python bindings.
 """
 
 import numpy as np
+import pytest
 import surgepy
 
 
@@ -67,3 +68,86 @@ def test_set_tuningApplicationMode():
     s = surgepy.createSurge(44100)
     s.tuningApplicationMode = surgepy.TuningApplicationMode.RETUNE_ALL
     assert s.tuningApplicationMode == surgepy.TuningApplicationMode.RETUNE_ALL
+
+
+def test_render_batch():
+    """
+    Test that renderBatch starts a note at the sample it was scheduled on.
+    """
+    s = surgepy.createSurge(44100)
+    n_blocks = int(s.getSampleRate() / s.getBlockSize())
+    start = 10 * s.getBlockSize() + 7
+    buf = s.createMultiBlock(n_blocks)
+    events = [
+        surgepy.SurgeRenderEvent.noteOff(start + 20000, 0, 60),
+        surgepy.SurgeRenderEvent.noteOn(start, 0, 60, 127),
+    ]
+    s.renderBatch(events, buf)
+    assert np.all(buf[:, :start] == 0.0)
+    assert not np.all(buf[:, start:] == 0.0)
+
+
+def test_render_batch_keeps_the_attack():
+    """
+    Test that a note started part way into a block sounds like one started on a block
+    boundary, only later.
+    """
+
+    def render(start):
+        s = surgepy.createSurge(44100)
+        patch = s.getPatch()
+        s.setParamVal(patch["scene"][0]["osc"][0]["retrigger"], 1)
+        s.setParamVal(patch["scene"][0]["drift"], 0)
+        buf = s.createMultiBlock(16)
+        s.renderBatch([surgepy.SurgeRenderEvent.noteOn(start, 0, 60, 127)], buf)
+        return buf[0]
+
+    bs = surgepy.createSurge(44100).getBlockSize()
+    aligned = render(4 * bs)[4 * bs :]
+    peak = np.max(np.abs(aligned))
+    assert peak > 0.01
+
+    for offset in (1, 9, bs - 1):
+        late = render(4 * bs + offset)[4 * bs :]
+        n = len(aligned) - offset - 1
+        error = min(
+            np.max(np.abs(late[shift : shift + n] - aligned[:n]))
+            for shift in (offset - 1, offset, offset + 1)
+        )
+        assert error < 0.02 * peak
+
+
+def test_render_batch_parallel():
+    """
+    Test rendering several instances on a thread pool, each with its own events.
+    """
+    synths = [surgepy.createSurge(44100) for _ in range(4)]
+    n_blocks = int(synths[0].getSampleRate() / synths[0].getBlockSize())
+    outputs = [s.createMultiBlock(n_blocks) for s in synths]
+    events = [
+        [surgepy.SurgeRenderEvent.noteOn(i * 1000, 0, 48 + i, 127)] for i in range(len(synths))
+    ]
+    surgepy.renderBatchParallel(synths, events, outputs, 2)
+    for i, out in enumerate(outputs):
+        assert np.all(out[:, : i * 1000] == 0.0)
+        assert not np.all(out[:, i * 1000 :] == 0.0)
+
+
+def test_render_batch_rejects_arrays_it_would_copy():
+    """
+    Test that output arrays which would have to be converted are refused rather than rendered
+    into a temporary copy.
+    """
+    synths = [surgepy.createSurge(44100) for _ in range(2)]
+    n_blocks = int(synths[0].getSampleRate() / synths[0].getBlockSize())
+    events = [[surgepy.SurgeRenderEvent.noteOn(0, 0, 60, 127)] for _ in synths]
+
+    doubles = [np.zeros((2, n_blocks * synths[0].getBlockSize()), dtype=np.float64) for _ in synths]
+    with pytest.raises(TypeError):
+        surgepy.renderBatchParallel(synths, events, doubles, 2)
+    with pytest.raises(TypeError):
+        synths[0].renderBatch(events[0], doubles[0])
+
+    strided = [np.asfortranarray(s.createMultiBlock(n_blocks)) for s in synths]
+    with pytest.raises(TypeError):
+        surgepy.renderBatchParallel(synths, events, strided, 2)
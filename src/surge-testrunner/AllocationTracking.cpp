@@ -0,0 +1,100 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "AllocationTracking.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local int *allocationCounter{nullptr};
+
+void countAllocation(void *p)
+{
+    if (p && allocationCounter)
+        (*allocationCounter)++;
+}
+} // namespace
+
+namespace Surge
+{
+namespace Test
+{
+ScopedAllocationCount::ScopedAllocationCount() : outer(allocationCounter)
+{
+    allocationCounter = &allocations;
+}
+
+ScopedAllocationCount::~ScopedAllocationCount() { allocationCounter = outer; }
+} // namespace Test
+} // namespace Surge
+
+void *operator new(std::size_t n)
+{
+    auto *p = std::malloc(n ? n : 1);
+    if (!p)
+        throw std::bad_alloc();
+
+    countAllocation(p);
+    return p;
+}
+
+void *operator new(std::size_t n, std::align_val_t al)
+{
+#if WINDOWS
+    auto *p = _aligned_malloc(n ? n : 1, (std::size_t)al);
+#else
+    void *p{nullptr};
+    if (posix_memalign(&p, std::max((std::size_t)al, sizeof(void *)), n ? n : 1) != 0)
+        p = nullptr;
+#endif
+    if (!p)
+        throw std::bad_alloc();
+
+    countAllocation(p);
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    countAllocation(p);
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    countAllocation(p);
+#if WINDOWS
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t al) noexcept
+{
+    operator delete(p, al);
+}
@@ -0,0 +1,52 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_SURGE_TESTRUNNER_ALLOCATIONTRACKING_H
+#define SURGE_SRC_SURGE_TESTRUNNER_ALLOCATIONTRACKING_H
+
+namespace Surge
+{
+namespace Test
+{
+/*
+ * The test runner replaces the global operator new and delete in AllocationTracking.cpp. They
+ * only malloc and free, except that while a ScopedAllocationCount is alive on a thread, it
+ * counts the allocations and frees made on that thread. Counts nest, with the innermost one
+ * doing the counting.
+ */
+struct ScopedAllocationCount
+{
+    ScopedAllocationCount();
+    ~ScopedAllocationCount();
+
+    ScopedAllocationCount(const ScopedAllocationCount &) = delete;
+    ScopedAllocationCount &operator=(const ScopedAllocationCount &) = delete;
+
+    int count() const { return allocations; }
+
+  private:
+    int allocations{0};
+    int *outer{nullptr};
+};
+} // namespace Test
+} // namespace Surge
+
+#endif // SURGE_SRC_SURGE_TESTRUNNER_ALLOCATIONTRACKING_H
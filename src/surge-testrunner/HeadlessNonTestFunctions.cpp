@@ -25,8 +25,17 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <cstring>
 #include <deque>
 
+#include "Effect.h"
+
+#if MAC
+#include <mach/mach.h>
+#elif LINUX
+#include <unistd.h>
+#endif
+
 namespace Surge
 {
 namespace Headless
@@ -38,12 +47,18 @@ void initializePatchDB()
 {
     using namespace std::chrono_literals;
     auto surge = createSurge(44100);
+    auto start = std::chrono::high_resolution_clock::now();
     surge->storage.initializePatchDb();
     while (surge->storage.patchDB->numberOfJobsOutstanding() > 0)
     {
         std::cout << surge->storage.patchDB->numberOfJobsOutstanding() << std::endl;
         std::this_thread::sleep_for(100ms);
     }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << "patches=" << surge->storage.patch_list.size() << " time=" << ms << "ms"
+              << std::endl;
 }
 
 void restreamTemplatesWithModifications()
@@ -743,6 +758,332 @@ void generateNLFeedbackNorms()
               << "      if (useNormalization) normNumerator = lpNormTable[subtype];\n";
 }
 
+static double residentMemoryMB()
+{
+#if MAC
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) !=
+        KERN_SUCCESS)
+        return -1;
+    return info.resident_size / 1024.0 / 1024.0;
+#elif LINUX
+    long pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> resident))
+        return -1;
+    return resident * sysconf(_SC_PAGESIZE) / 1024.0 / 1024.0;
+#else
+    return -1;
+#endif
+}
+
+void fxStorageStartupBenchmark(int instances, bool shareTables)
+{
+    /*
+     * Builds storages the way Surge XT Effects does, each running a delay. Since freed memory
+     * usually stays with the process, run this once per configuration rather than comparing
+     * configurations within one run.
+     */
+    auto cfg = SurgeStorage::SurgeStorageConfig::fromDataPath("");
+    cfg.createUserDirectory = false;
+    cfg.scanWavetableAndPatches = false;
+    cfg.shareReadOnlyTables = shareTables;
+
+    std::vector<std::unique_ptr<SurgeStorage>> storages;
+    std::vector<std::unique_ptr<Effect>> effects;
+    storages.reserve(instances);
+    effects.reserve(instances);
+
+    auto rss0 = residentMemoryMB();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < instances; ++i)
+    {
+        auto storage = std::make_unique<SurgeStorage>(cfg);
+        auto fxs = &(storage->getPatch().fx[0]);
+        fxs->type.val.i = fxt_delay;
+        effects.emplace_back(
+            spawn_effect(fxt_delay, storage.get(), fxs, storage->getPatch().globaldata));
+        effects.back()->init();
+        effects.back()->init_ctrltypes();
+        effects.back()->init_default_values();
+        storages.push_back(std::move(storage));
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto rss1 = residentMemoryMB();
+    auto ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    std::cout << "instances=" << instances << " sharedTables=" << (shareTables ? 1 : 0)
+              << " startup=" << ms << "ms (" << ms / instances << "ms/instance)";
+    if (rss0 >= 0 && rss1 >= 0)
+    {
+        std::cout << " rss=" << rss1 << "MB (+" << (rss1 - rss0) << "MB, "
+                  << (rss1 - rss0) / instances << "MB/instance)";
+    }
+    std::cout << std::endl;
+}
+
+void sceneRenderBenchmark(int blocks)
+{
+    /*
+     * Times a full dual scene chord with the scenes rendered one after the other and then on
+     * separate threads.
+     */
+    for (auto parallel : {false, true})
+    {
+        auto surge = Surge::Headless::createSurge(48000);
+        surge->storage.getPatch().scenemode.val.i = sm_dual;
+        for (int sc = 0; sc < n_scenes; ++sc)
+        {
+            for (int o = 0; o < n_oscs; ++o)
+            {
+                surge->storage.getPatch().scene[sc].osc[o].type.val.i = ot_wavetable;
+            }
+        }
+        surge->setParallelSceneRendering(parallel);
+
+        for (int n = 0; n < 8; ++n)
+        {
+            surge->playNote(0, 48 + n * 3, 100, 0);
+        }
+
+        // get past the note starts and let the worker threads settle
+        for (int i = 0; i < 100; ++i)
+        {
+            surge->process();
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < blocks; ++i)
+        {
+            surge->process();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        std::cout << "parallelScenes=" << (parallel ? 1 : 0) << " blocks=" << blocks
+                  << " voices=" << surge->storage.activeVoiceCount << " time=" << us / 1000.0
+                  << "ms (" << (double)us / blocks << "us/block)" << std::endl;
+    }
+}
+
+void voiceStressBenchmark(int blocks)
+{
+    /*
+     * Keeps 64 voices going across both scenes, retriggering a few notes every block so the
+     * voice bookkeeping (start, release, polyphony limit, free) is exercised along with the
+     * per block voice walks.
+     */
+    auto surge = Surge::Headless::createSurge(48000);
+    surge->storage.getPatch().scenemode.val.i = sm_dual;
+    surge->storage.getPatch().polylimit.val.i = MAX_VOICES / n_scenes;
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        surge->storage.getPatch().scene[sc].adsr[0].r.val.f = -8.f;
+    }
+
+    int oldest = 0, next = 0;
+    for (; next < MAX_VOICES / n_scenes; ++next)
+    {
+        surge->playNote(0, 30 + next, 100, 0);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < blocks; ++i)
+    {
+        for (int n = 0; n < 4; ++n)
+        {
+            surge->releaseNote(0, 30 + (oldest++ % 64), 0);
+            surge->playNote(0, 30 + (next++ % 64), 100, 0);
+        }
+        surge->process();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << "blocks=" << blocks << " voices=" << surge->storage.activeVoiceCount
+              << " time=" << us / 1000.0 << "ms (" << (double)us / blocks << "us/block)"
+              << std::endl;
+}
+
+void hostBufferCopyBenchmark(int seconds)
+{
+    /*
+     * Streams a chord out through the main and both scene outputs in host sized buffers, once
+     * with the plugin wrapper's old per-sample copy loop and once copying whole runs to each
+     * block boundary as it does now. The engine work is the same in both, so the difference is
+     * the copy.
+     */
+    auto surge = Surge::Headless::createSurge(48000);
+    for (int n = 0; n < 4; ++n)
+    {
+        surge->playNote(0, 48 + n * 4, 100, 0);
+    }
+
+    std::vector<float> out[6];
+
+    for (int bufferSize : {64, 128, 256, 512, 1024})
+    {
+        for (auto &o : out)
+        {
+            o.assign(bufferSize, 0.f);
+        }
+
+        auto buffers = seconds * 48000 / bufferSize;
+
+        for (auto runs : {false, true})
+        {
+            int blockPos = 0;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int b = 0; b < buffers; ++b)
+            {
+                int i = 0;
+                while (i < bufferSize)
+                {
+                    if (blockPos == 0)
+                    {
+                        surge->process();
+                    }
+
+                    if (runs)
+                    {
+                        auto n = std::min(BLOCK_SIZE - blockPos, bufferSize - i);
+                        auto bytes = n * sizeof(float);
+
+                        memcpy(&out[0][i], &surge->output[0][blockPos], bytes);
+                        memcpy(&out[1][i], &surge->output[1][blockPos], bytes);
+                        for (int sc = 0; sc < 2; ++sc)
+                        {
+                            memcpy(&out[2 + sc * 2][i], &surge->sceneout[sc][0][blockPos], bytes);
+                            memcpy(&out[3 + sc * 2][i], &surge->sceneout[sc][1][blockPos], bytes);
+                        }
+
+                        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
+                        i += n;
+                    }
+                    else
+                    {
+                        out[0][i] = surge->output[0][blockPos];
+                        out[1][i] = surge->output[1][blockPos];
+                        for (int sc = 0; sc < 2; ++sc)
+                        {
+                            out[2 + sc * 2][i] = surge->sceneout[sc][0][blockPos];
+                            out[3 + sc * 2][i] = surge->sceneout[sc][1][blockPos];
+                        }
+
+                        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+                        i++;
+                    }
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+            std::cout << "bufferSize=" << bufferSize << " copy=" << (runs ? "runs" : "samples")
+                      << " buffers=" << buffers << " time=" << us / 1000.0 << "ms ("
+                      << (double)us / buffers << "us/buffer)" << std::endl;
+        }
+    }
+}
+
+void wavetableMipMapBenchmark()
+{
+    /*
+     * Loads every factory wavetable once, then times rebuilding all their mip levels with the
+     * reference implementation and with the vectorised, threaded one.
+     */
+    auto surge = Surge::Headless::createSurge(48000, true);
+    auto &storage = surge->storage;
+
+    std::vector<std::unique_ptr<Wavetable>> wts;
+    size_t samples = 0;
+
+    for (auto &p : storage.wt_list)
+    {
+        auto wt = std::make_unique<Wavetable>();
+        storage.load_wt(path_to_string(p.path), wt.get(), nullptr);
+
+        if (wt->everBuilt)
+        {
+            samples += (size_t)wt->size * wt->n_tables;
+            wts.push_back(std::move(wt));
+        }
+    }
+
+    for (auto reference : {true, false})
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto &wt : wts)
+        {
+            if (reference)
+                wt->MipMapWTReference();
+            else
+                wt->MipMapWT();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        std::cout << (reference ? "reference" : "vectorised") << " wavetables=" << wts.size()
+                  << " samples=" << samples << " time=" << us / 1000.0 << "ms" << std::endl;
+    }
+}
+
+void patchXMLLoadBenchmark()
+{
+    /*
+     * Saves every patch in the library as XML, both as written and with its parameters in
+     * reverse order, then times load_xml over each set. The reversed set is the worst case
+     * for finding each parameter's element, as patches with reordered or missing ones are.
+     */
+    auto surge = Surge::Headless::createSurge(48000, true);
+    auto &patch = surge->storage.getPatch();
+
+    std::vector<std::string> inOrder, reversed;
+
+    for (auto &p : surge->storage.patch_list)
+    {
+        if (!surge->loadPatchByPath(path_to_string(p.path).c_str(), -1, p.name.c_str()))
+        {
+            continue;
+        }
+
+        inOrder.push_back(patchXML(surge.get()));
+
+        TiXmlDocument doc;
+        doc.Parse(inOrder.back().c_str(), nullptr, TIXML_ENCODING_LEGACY);
+
+        if (!reverseParameters(doc))
+        {
+            inOrder.pop_back();
+            continue;
+        }
+
+        std::string r;
+        r << doc;
+        reversed.push_back(r);
+    }
+
+    for (auto rev : {false, true})
+    {
+        auto &xmls = rev ? reversed : inOrder;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto &x : xmls)
+        {
+            patch.load_xml(x.data(), x.size(), false);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        std::cout << (rev ? "reversed" : "in order") << " patches=" << xmls.size()
+                  << " time=" << us / 1000.0
+                  << "ms per patch=" << us / std::max<size_t>(xmls.size(), 1) << "us" << std::endl;
+    }
+}
+
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
@@ -34,6 +34,12 @@ void restreamTemplatesWithModifications();
 void statsFromPlayingEveryPatch();
 void filterAnalyzer(int ft, int fst, std::ostream &os);
 void generateNLFeedbackNorms();
+void fxStorageStartupBenchmark(int instances, bool shareTables);
+void sceneRenderBenchmark(int blocks);
+void voiceStressBenchmark(int blocks);
+void hostBufferCopyBenchmark(int seconds);
+void wavetableMipMapBenchmark();
+void patchXMLLoadBenchmark();
 [[noreturn]] void performancePlay(const std::string &patchName, int mode);
 } // namespace NonTest
 } // namespace Headless
@@ -77,5 +77,43 @@ void writeToStream(const float *data, int nSamples, int nChannels, std::ostream
     }
 }
 
+std::string patchXML(SurgeSynthesizer *surge)
+{
+    void *d{nullptr};
+    auto sz = surge->storage.getPatch().save_xml(&d);
+    auto res = std::string((char *)d, sz);
+    free(d);
+    return res;
+}
+
+bool reverseParameters(TiXmlDocument &doc)
+{
+    auto pe = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch"));
+    auto params = pe ? TINYXML_SAFE_TO_ELEMENT(pe->FirstChild("parameters")) : nullptr;
+
+    if (!params)
+    {
+        return false;
+    }
+
+    std::vector<TiXmlElement *> children;
+
+    for (auto c = params->FirstChildElement(); c; c = c->NextSiblingElement())
+    {
+        children.push_back(c);
+    }
+
+    TiXmlElement rev("parameters");
+
+    for (auto c = children.rbegin(); c != children.rend(); ++c)
+    {
+        rev.InsertEndChild(**c);
+    }
+
+    pe->ReplaceChild(params, rev);
+
+    return true;
+}
+
 } // namespace Headless
 } // namespace Surge
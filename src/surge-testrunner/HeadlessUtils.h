@@ -33,6 +33,15 @@ std::shared_ptr<SurgeSynthesizer> createSurge(int sr, bool loadAllPatches = fals
 
 void writeToStream(const float *data, int nSamples, int nChannels, std::ostream &str);
 
+// The current patch as save_xml writes it
+std::string patchXML(SurgeSynthesizer *surge);
+
+/*
+ * Reverses the order of the parameters in a patch parsed from patchXML, which is the worst case
+ * for load_xml finding each one's element. Says false if it has none.
+ */
+bool reverseParameters(TiXmlDocument &doc);
+
 /*
 ** One imagines expansions along these lines:
 
@@ -393,6 +393,101 @@ TEST_CASE("Every Oscillator Plays", "[dsp]")
     }
 }
 
+TEST_CASE("Queued Oscillator Snapshots Apply On The Audio Thread", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[1];
+
+    std::vector<std::pair<std::string, float>> heard;
+    surge->addAudioParamListener("test", [&heard](auto oname, auto fval, auto valstr) {
+        heard.emplace_back(oname, fval);
+    });
+
+    TiXmlElement e("snapshot");
+    e.SetDoubleAttribute("p0", 0.25);
+    e.SetAttribute("p0_deform_type", 1);
+    e.SetAttribute("retrigger", 1);
+
+    osc.queue_type = ot_sine;
+    REQUIRE(osc.queueSnapshot(&e));
+
+    // the audio thread hasn't applied it, so another one can't be written over it
+    TiXmlElement other("snapshot");
+    other.SetDoubleAttribute("p0", 0.75);
+    REQUIRE(!osc.queueSnapshot(&other));
+
+    // nothing is delivered until someone drains the queue
+    surge->process();
+    REQUIRE(heard.empty());
+    REQUIRE(osc.type.val.i == ot_sine);
+    REQUIRE(!osc.queue_snapshot_pending);
+    REQUIRE(osc.p[0].deform_type == 1);
+    REQUIRE(osc.retrigger.val.b);
+
+    if (osc.p[0].valtype == vt_float)
+        REQUIRE(osc.p[0].val.f == 0.25f);
+    else
+        REQUIRE(osc.p[0].val.i == 0);
+
+    surge->drainAudioParamEvents();
+    REQUIRE(heard.size() == 4);
+    REQUIRE(heard.front() == std::make_pair(std::string("/param/a/osc/2/type"), (float)ot_sine));
+    REQUIRE(heard.back() == std::make_pair(std::string("/param/a/osc/2/retrigger"), 1.f));
+
+    surge->deleteAudioParamListener("test");
+}
+
+TEST_CASE("Audio Thread Param Events Coalesce And Count Drops", "[dsp]")
+{
+    using ev = SurgeSynthesizer::AudioParamEvent;
+
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &patch = surge->storage.getPatch();
+    auto a = patch.scene[0].osc[0].pitch.id, b = patch.volume.id;
+
+    std::vector<std::pair<std::string, float>> heard;
+    surge->addAudioParamListener("test", [&heard](auto oname, auto fval, auto valstr) {
+        heard.emplace_back(oname, fval);
+    });
+
+    for (int i = 0; i < 100; ++i)
+    {
+        surge->queueAudioParamEvent(ev::PARAM_VALUE, a, i);
+        surge->queueAudioParamEvent(ev::PARAM_VALUE, b, -i);
+    }
+
+    surge->drainAudioParamEvents();
+
+    // the latest value of each, in the order they first changed
+    REQUIRE(heard.size() == 2);
+    REQUIRE(heard[0] == std::make_pair(patch.param_ptr[a]->oscName, 99.f));
+    REQUIRE(heard[1] == std::make_pair(patch.param_ptr[b]->oscName, -99.f));
+    REQUIRE(surge->audioParamEventStats.coalesced == 198);
+    REQUIRE(surge->audioParamEventStats.dropped == 0);
+
+    // with nobody draining, the queue fills up and the rest are dropped
+    auto cap = SurgeSynthesizer::audioParamEventCapacity;
+
+    for (size_t i = 0; i < cap + 100; ++i)
+        surge->queueAudioParamEvent(ev::PARAM_VALUE, a, i);
+
+    auto &st = surge->audioParamEventStats;
+    REQUIRE(st.dropped == 101);
+    REQUIRE(st.queued - st.drained == cap - 1);
+
+    heard.clear();
+    surge->drainAudioParamEvents();
+    REQUIRE(heard.size() == 1);
+    REQUIRE(heard[0].second == cap - 2);
+    REQUIRE(st.queued == st.drained);
+
+    surge->deleteAudioParamListener("test");
+}
+
 TEST_CASE("Untuned is 2^x", "[dsp]")
 {
     auto surge = Surge::Headless::createSurge(44100);
@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -31,7 +32,9 @@
 #include "catch2/catch_amalgamated.hpp"
 
 #include "UnitTestUtilities.h"
+#include "AllocationTracking.h"
 #include "AudioInputEffect.h"
+#include "EffectHandoff.h"
 
 using namespace Surge::Test;
 
@@ -1081,3 +1084,90 @@ TEST_CASE("Audio Input Effect", "[fx]")
         }
     }
 }
+
+TEST_CASE("FX Type Changes Don't Allocate On The Audio Thread", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto *storage = &surge->storage;
+    auto &patch = storage->getPatch();
+
+    // Builds an effect into fx[which] the way the FX plugin's message thread does
+    auto build = [&](int type, int which) {
+        auto *fxs = &patch.fx[which];
+        fxs->type.val.i = type;
+
+        for (int i = 0; i < n_fx_params; ++i)
+            fxs->p[i].set_type(ct_none);
+
+        std::shared_ptr<Effect> fx(spawn_effect(type, storage, fxs, patch.globaldata));
+
+        if (fx)
+        {
+            fx->init();
+            fx->init_ctrltypes();
+            fx->init_default_values();
+        }
+
+        patch.copy_globaldata(patch.globaldata);
+        return fx;
+    };
+
+    Surge::FX::EffectHandoff handoff;
+    float dataL alignas(16)[BLOCK_SIZE], dataR alignas(16)[BLOCK_SIZE];
+    int allocations{0};
+
+    // The audio thread's side, counted
+    auto runBlocks = [&](int n) {
+        for (int b = 0; b < n; ++b)
+        {
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                dataL[i] = 0.3f * std::sin(0.05f * (b * BLOCK_SIZE + i));
+                dataR[i] = 0.3f * std::cos(0.07f * (b * BLOCK_SIZE + i));
+            }
+
+            Surge::Test::ScopedAllocationCount count;
+            handoff.beginBlock();
+            handoff.process(dataL, dataR);
+            allocations += count.count();
+        }
+    };
+
+    int which = 0;
+    handoff.replace(build(fxt_delay, which));
+    runBlocks(4);
+    handoff.collect();
+    REQUIRE(allocations == 0);
+
+    for (int t = fxt_off; t < n_fx_types; ++t)
+    {
+        INFO("Switching to " << fx_type_names[t]);
+
+        // A crossfade, which the building side commits
+        which = 1 - which;
+        REQUIRE(handoff.offer(build(t, which), 8));
+        runBlocks(10);
+        REQUIRE(handoff.commit());
+        handoff.collect();
+        REQUIRE(allocations == 0);
+
+        // A straight replacement
+        which = 1 - which;
+        handoff.replace(build(t, which));
+        runBlocks(2);
+        handoff.collect();
+        REQUIRE(allocations == 0);
+
+        // A crossfade dropped halfway by a replacement
+        which = 1 - which;
+        REQUIRE(handoff.offer(build(fxt_off, which), 8));
+        runBlocks(3);
+        handoff.replace(build(t, 2));
+        runBlocks(2);
+        handoff.collect();
+        REQUIRE(handoff.ready());
+        REQUIRE(allocations == 0);
+    }
+}
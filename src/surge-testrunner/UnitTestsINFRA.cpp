@@ -25,6 +25,7 @@
 #include "HeadlessUtils.h"
 #include "BiquadFilter.h"
 #include "MemoryPool.h"
+#include "VoiceSlotList.h"
 
 #include "sst/plugininfra/strnatcmp.h"
 
@@ -181,6 +182,92 @@ TEST_CASE("Memory Pool Works", "[infra]")
     }
 }
 
+TEST_CASE("Voice Slot List Works", "[infra]")
+{
+    std::array<int, 8> slots{};
+    Surge::VoiceSlotList<int, 8> vl;
+    vl.setSlotBase(slots.data());
+
+    REQUIRE(vl.empty());
+
+    for (auto i : {5, 2, 7, 0})
+    {
+        vl.push_back(&slots[i]);
+    }
+    REQUIRE(vl.size() == 4);
+    REQUIRE(vl.front() == &slots[5]);
+    REQUIRE(vl.back() == &slots[0]);
+    REQUIRE(vl.activeSlots() == ((1 << 5) | (1 << 2) | (1 << 7) | (1 << 0)));
+
+    SECTION("Erase While Iterating Keeps Order")
+    {
+        auto it = vl.begin();
+        while (it != vl.end())
+        {
+            if (*it == &slots[2] || *it == &slots[0])
+                it = vl.erase(it);
+            else
+                ++it;
+        }
+        REQUIRE(vl.size() == 2);
+        REQUIRE(vl.front() == &slots[5]);
+        REQUIRE(vl.back() == &slots[7]);
+        REQUIRE(!vl.contains(&slots[2]));
+        REQUIRE(vl.contains(&slots[7]));
+        REQUIRE(vl.activeSlots() == ((1 << 5) | (1 << 7)));
+    }
+
+    SECTION("Remove And Reuse A Slot")
+    {
+        REQUIRE(vl.remove(&slots[7]));
+        REQUIRE(!vl.remove(&slots[7]));
+        vl.push_back(&slots[7]);
+
+        std::vector<int> order;
+        for (auto v : vl)
+            order.push_back(vl.slotOf(v));
+        REQUIRE(order == std::vector<int>{5, 2, 0, 7});
+
+        vl.clear();
+        REQUIRE(vl.empty());
+        REQUIRE(vl.activeSlots() == 0);
+    }
+}
+
+TEST_CASE("Storage Shares Read Only Tables", "[infra]")
+{
+    auto cfg = SurgeStorage::SurgeStorageConfig::fromDataPath("");
+    cfg.createUserDirectory = false;
+    cfg.scanWavetableAndPatches = false;
+
+    SECTION("Shared By Default")
+    {
+        std::weak_ptr<SurgeStorage::SharedTables> weakTables;
+        {
+            auto a = std::make_unique<SurgeStorage>(cfg);
+            auto b = std::make_unique<SurgeStorage>(cfg);
+            REQUIRE(a->sharedTables == b->sharedTables);
+            REQUIRE(a->sinctable == b->sinctable);
+            REQUIRE(&a->WindowWT == &b->WindowWT);
+            weakTables = a->sharedTables;
+        }
+        REQUIRE(weakTables.expired());
+    }
+
+    SECTION("Private On Request")
+    {
+        auto a = std::make_unique<SurgeStorage>(cfg);
+        cfg.shareReadOnlyTables = false;
+        auto b = std::make_unique<SurgeStorage>(cfg);
+        REQUIRE(a->sharedTables != b->sharedTables);
+        REQUIRE(a->sinctable != b->sinctable);
+        for (int i = 0; i < FIRipol_M * FIRipol_N; ++i)
+        {
+            REQUIRE(a->sinctable[i] == b->sinctable[i]);
+        }
+    }
+}
+
 TEST_CASE("strnatcmp With Spaces", "[infra]")
 {
     SECTION("Basic Comparison")
@@ -22,7 +22,9 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
+#include <random>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -34,6 +36,8 @@
 #include <thread>
 
 #include "UserDefaults.h"
+#include "PatchCache.h"
+#include "PatchPreloader.h"
 #include <unordered_map>
 
 using namespace Surge::Test;
@@ -97,6 +101,171 @@ TEST_CASE("All Factory Wavetables Are Loadable", "[io]")
     }
 }
 
+TEST_CASE("Identical Wavetables Share Their Data", "[io]")
+{
+    auto a = Surge::Headless::createSurge(44100);
+    auto b = Surge::Headless::createSurge(44100);
+    REQUIRE(a.get());
+    REQUIRE(b.get());
+
+    std::string metadata;
+    auto wa = &(a->storage.getPatch().scene[0].osc[0].wt);
+    auto wa2 = &(a->storage.getPatch().scene[1].osc[2].wt);
+    auto wb = &(b->storage.getPatch().scene[0].osc[1].wt);
+
+    a->storage.load_wt_wav_portable("resources/test-data/wav/05_BELL.WAV", wa, metadata);
+    a->storage.load_wt_wav_portable("resources/test-data/wav/05_BELL.WAV", wa2, metadata);
+    b->storage.load_wt_wav_portable("resources/test-data/wav/05_BELL.WAV", wb, metadata);
+
+    for (auto w : {wa2, wb})
+    {
+        REQUIRE(w->size == wa->size);
+        REQUIRE(w->n_tables == wa->n_tables);
+        REQUIRE(w->flags == wa->flags);
+
+        for (int l = 0; l < max_mipmap_levels; ++l)
+        {
+            for (int t = 0; t < wa->n_tables; ++t)
+            {
+                REQUIRE(w->TableF32WeakPointers[l][t] == wa->TableF32WeakPointers[l][t]);
+                REQUIRE(w->TableI16WeakPointers[l][t] == wa->TableI16WeakPointers[l][t]);
+            }
+        }
+    }
+
+    // a different wavetable gets its own data, and the one left behind is untouched
+    auto firstSample = wa->TableF32WeakPointers[1][3][17];
+    b->storage.load_wt_wav_portable("resources/test-data/wav/pluckalgo.wav", wb, metadata);
+    REQUIRE(wb->n_tables == 9);
+    REQUIRE(wb->TableF32WeakPointers[0][0] != wa->TableF32WeakPointers[0][0]);
+    REQUIRE(wa->TableF32WeakPointers[1][3][17] == firstSample);
+}
+
+TEST_CASE("Vectorised Mip Maps Match The Reference", "[io]")
+{
+    auto check = [](int n_samples, int n_tables, int flags, bool appendSilence) {
+        INFO("samples=" << n_samples << " tables=" << n_tables << " flags=" << flags);
+
+        wt_header wh;
+        memcpy(wh.tag, "vawt", 4);
+        wh.n_samples = n_samples;
+        wh.n_tables = n_tables;
+        wh.flags = flags;
+
+        std::minstd_rand gen(n_samples * 31 + n_tables);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        std::vector<float> f32(n_samples * n_tables);
+        std::vector<short> i16(n_samples * n_tables);
+        for (size_t i = 0; i < f32.size(); ++i)
+        {
+            f32[i] = dist(gen);
+            i16[i] = (short)(f32[i] * 16384);
+        }
+
+        Wavetable wt;
+        wt.BuildWT((flags & wtf_int16) ? (void *)i16.data() : (void *)f32.data(), wh,
+                   appendSilence);
+
+        std::vector<float> fastF;
+        std::vector<short> fastI;
+        auto collect = [&](std::vector<float> &f, std::vector<short> &i) {
+            f.clear();
+            i.clear();
+            for (int l = 1; l < max_mipmap_levels && (n_samples >> l) > 1; ++l)
+            {
+                for (int t = 0; t < wt.n_tables; ++t)
+                {
+                    auto lsize = n_samples >> l;
+                    f.insert(f.end(), wt.TableF32WeakPointers[l][t],
+                             wt.TableF32WeakPointers[l][t] + lsize);
+                    i.insert(i.end(), wt.TableI16WeakPointers[l][t],
+                             wt.TableI16WeakPointers[l][t] + lsize + 2 * FIRoffsetI16);
+                }
+            }
+        };
+
+        collect(fastF, fastI);
+        wt.MipMapWTReference();
+
+        std::vector<float> refF;
+        std::vector<short> refI;
+        collect(refF, refI);
+
+        REQUIRE(fastF.size() == refF.size());
+        REQUIRE(fastI == refI);
+        for (size_t i = 0; i < fastF.size(); ++i)
+        {
+            REQUIRE(fastF[i] == Approx(refF[i]).margin(1e-6));
+        }
+    };
+
+    check(2048, 8, 0, false);
+    check(1024, 100, 0, false);
+    check(2048, 100, 0, false);
+    check(256, 33, wtf_int16, false);
+    check(1024, 40, wtf_is_sample, true);
+    check(64, 5, wtf_is_sample, true);
+}
+
+TEST_CASE("Background Wavetable Loads", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+
+    surge->storage.setBackgroundWavetableLoading(true);
+    REQUIRE(surge->storage.getBackgroundWavetableLoading());
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[0];
+    osc.type.val.i = ot_wavetable;
+
+    auto idOf = [&](const std::string &name) {
+        for (int i = 0; i < surge->storage.wt_list.size(); ++i)
+        {
+            if (surge->storage.wt_list[i].name == name)
+                return i;
+        }
+        return -1;
+    };
+
+    auto first = idOf("Sine Power HQ");
+    auto second = idOf("Sine To Square");
+    REQUIRE(first >= 0);
+    REQUIRE(second >= 0);
+
+    auto processUntilLoaded = [&](int id) {
+        for (int i = 0; i < 5000 && osc.wt.current_id != id; ++i)
+        {
+            surge->process();
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(osc.wt.current_id == id);
+    };
+
+    osc.wt.queue_id = first;
+    surge->process();
+
+    // the request is taken at once, even though the table itself arrives later
+    REQUIRE(osc.wt.queue_id == -1);
+    processUntilLoaded(first);
+    REQUIRE(osc.wavetable_display_name == "Sine Power HQ");
+    REQUIRE(osc.wt.everBuilt);
+
+    // queue two in a row; only the last one may stick
+    osc.wt.queue_id = first;
+    surge->process();
+    osc.wt.queue_id = second;
+    surge->process();
+    processUntilLoaded(second);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        surge->process();
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(osc.wt.current_id == second);
+    REQUIRE(osc.wavetable_display_name == "Sine To Square");
+}
+
 TEST_CASE("All Patches Are Loadable", "[io]")
 {
     auto surge = Surge::Headless::createSurge(44100, true);
@@ -116,6 +285,216 @@ TEST_CASE("All Patches Are Loadable", "[io]")
     }
 }
 
+TEST_CASE("Patches With Reordered Or Missing Params Load", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+
+    auto &patch = surge->storage.getPatch();
+
+    REQUIRE(surge->storage.patch_list.size() > 10);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        surge->loadPatch(i * 7 % surge->storage.patch_list.size());
+        auto saved = Surge::Headless::patchXML(surge.get());
+
+        TiXmlDocument doc;
+        doc.Parse(saved.c_str(), nullptr, TIXML_ENCODING_LEGACY);
+        REQUIRE(Surge::Headless::reverseParameters(doc));
+
+        std::string reversed;
+        reversed << doc;
+
+        // reversed, every param still finds its own element
+        patch.init_default_values();
+        patch.load_xml(reversed.data(), reversed.size(), false);
+        REQUIRE(Surge::Headless::patchXML(surge.get()) == saved);
+
+        // and with one missing, the rest still do
+        auto pe = TINYXML_SAFE_TO_ELEMENT(doc.FirstChild("patch"));
+        auto params = TINYXML_SAFE_TO_ELEMENT(pe->FirstChild("parameters"));
+        auto gone = TINYXML_SAFE_TO_ELEMENT(params->FirstChild("volume"));
+        REQUIRE(gone);
+        params->RemoveChild(gone);
+
+        std::string missing;
+        missing << doc;
+
+        auto volume = patch.volume.val.f;
+
+        patch.init_default_values();
+        patch.volume.val.f = 0.123f;
+        patch.load_xml(missing.data(), missing.size(), false);
+        REQUIRE(patch.volume.val.f == 0.123f);
+
+        patch.volume.val.f = volume;
+        REQUIRE(Surge::Headless::patchXML(surge.get()) == saved);
+    }
+}
+
+TEST_CASE("Patches Reload From The Patch Cache", "[io]")
+{
+    auto dir = fs::temp_directory_path() / "surge-test-patch-cache";
+    fs::remove_all(dir);
+
+    auto surge = Surge::Headless::createSurge(44100, true);
+    auto ref = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    REQUIRE(ref.get());
+
+    surge->storage.setPatchCacheDirectory(dir);
+    REQUIRE(surge->storage.patchCache);
+    auto &stats = surge->storage.patchCache->stats;
+
+    auto n = (int)surge->storage.patch_list.size();
+    REQUIRE(n > 0);
+
+    for (int i = 0; i < n; i += 23)
+    {
+        INFO("Loading patch " << surge->storage.patch_list[i].name);
+
+        ref->loadPatch(i);
+        auto expected = Surge::Headless::patchXML(ref.get());
+
+        auto before = stats;
+        surge->loadPatch(i);
+        REQUIRE(stats.restored == before.restored);
+        REQUIRE(stats.stored + stats.uncacheable == before.stored + before.uncacheable + 1);
+        REQUIRE(Surge::Headless::patchXML(surge.get()) == expected);
+
+        bool stored = stats.stored > before.stored;
+
+        // something else in between, so the restore has to overwrite it all
+        ref->loadPatch((i + 1) % n);
+        ref->loadPatch(i);
+        expected = Surge::Headless::patchXML(ref.get());
+
+        surge->loadPatch((i + 1) % n);
+        auto restoredBefore = stats.restored, skippedBefore = stats.skipped;
+        surge->loadPatch(i);
+        REQUIRE(stats.restored == restoredBefore + (stored ? 1 : 0));
+
+        // one which failed its proof is marked, and isn't tried again
+        REQUIRE(stats.skipped == skippedBefore + (stored ? 0 : 1));
+        REQUIRE(Surge::Headless::patchXML(surge.get()) == expected);
+    }
+
+    REQUIRE(stats.stored > 0);
+    REQUIRE(stats.restored > 0);
+
+    // a snapshot is only good for the file it was made from
+    auto src = surge->storage.patch_list[0].path;
+    auto copy = dir / "copy.fxp";
+    fs::copy_file(src, copy);
+    auto restored = stats.restored;
+    surge->loadPatchByPath(path_to_string(copy).c_str(), -1, "copy");
+    REQUIRE(stats.restored == restored);
+
+    // snapshots past their age are pruned, and the rest are kept while under the size cap
+    auto stale = dir / "stale.sxpc";
+    {
+        std::ofstream out(stale, std::ios::binary);
+        out << "stale";
+    }
+    fs::last_write_time(stale, fs::file_time_type::clock::now() -
+                                   Surge::Storage::PatchCache::maxAge - std::chrono::hours(1));
+
+    surge->storage.patchCache->prune();
+    REQUIRE(!fs::exists(stale));
+
+    int kept = 0;
+    for (auto &e : fs::directory_iterator(dir))
+    {
+        kept += e.path().extension() == ".sxpc";
+    }
+    REQUIRE(kept >= stats.stored);
+
+    surge->storage.setPatchCacheDirectory({});
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Preloaded Patches Load From Memory", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    auto ref = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge.get());
+    REQUIRE(ref.get());
+
+    auto n = (int)surge->storage.patch_list.size();
+    REQUIRE(n > 2);
+
+    std::vector<int> ids{0, n / 2, n - 1};
+    surge->preloadPatches(ids);
+    REQUIRE(surge->patchPreloader);
+
+    auto isReady = [&surge](int id) {
+        return surge->patchPreloader->isReady(id, surge->storage.patch_list[id].path);
+    };
+
+    for (auto id : ids)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (!isReady(id) && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(isReady(id));
+    }
+
+    for (auto id : ids)
+    {
+        INFO("Loading patch " << surge->storage.patch_list[id].name);
+
+        ref->loadPatch(id);
+
+        surge->patchid_queue = id;
+        int blocks = 0;
+        while (surge->patchid_queue >= 0 && !surge->halt_engine && blocks < 100)
+        {
+            surge->process();
+            blocks++;
+        }
+
+        // the same fade out as any load before the loader thread takes over
+        REQUIRE(blocks < 100);
+
+        auto start = std::chrono::steady_clock::now();
+        while ((surge->patchid_queue >= 0 || surge->halt_engine) &&
+               std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(surge->patchid_queue == -1);
+        REQUIRE(!surge->halt_engine);
+        REQUIRE(surge->patchid == id);
+        REQUIRE(surge->storage.getPatch().name == surge->storage.patch_list[id].name);
+        REQUIRE(Surge::Headless::patchXML(surge.get()) == Surge::Headless::patchXML(ref.get()));
+
+        for (int i = 0; i < 10; i++)
+        {
+            surge->process();
+        }
+        REQUIRE(surge->masterfade == 1.f);
+    }
+
+    // an emptied set lets go of everything
+    surge->preloadPatches({});
+    REQUIRE(!isReady(ids[0]));
+
+    // and jogging keeps the patch it went to, and the ones either side of it, preloaded
+    surge->jogPatch(true);
+    auto jogged = surge->patchid_queue >= 0 ? surge->patchid_queue : surge->patchid;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!isReady(jogged) && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    REQUIRE(isReady(jogged));
+}
+
 TEST_CASE("DAW Streaming And Unstreaming", "[io][mpe][tun]")
 {
     // The basic plan of attack is, in a section, set up two surges,
@@ -605,6 +605,41 @@ end)FN");
     }
 }
 
+TEST_CASE("Returning A New State Table", "[formula]")
+{
+    SurgeStorage storage;
+    FormulaModulatorStorage fs;
+    fs.setFormula(R"FN(
+function init(state)
+   state.count = 0
+   return state
+end
+
+function process(state)
+    local res = { count = state.count + 1, intphase = -1 }
+    res.output = state.phase + state.intphase
+    res.use_envelope = (res.count % 2) == 0
+    return res
+end)FN");
+
+    Surge::Formula::EvaluatorState es;
+    Surge::Formula::prepareForEvaluation(&storage, &fs, es, true);
+
+    for (int i = 0; i < 20; ++i)
+    {
+        float r[Surge::Formula::max_formula_outputs];
+        Surge::Formula::valueAt(i % 2, 0.25, &storage, &fs, &es, r);
+
+        // the inputs land in whichever table the last call returned
+        REQUIRE(r[0] == Approx(0.25 + i % 2));
+        REQUIRE(es.useEnvelope == ((i + 1) % 2 == 0));
+    }
+
+    REQUIRE(std::get<float>(Surge::Formula::extractModStateKeyForTesting("count", es)) == 20);
+
+    Surge::Formula::cleanEvaluatorState(es);
+}
+
 TEST_CASE("Clamping", "[formula]")
 {
     SECTION("Test Clamped Function")
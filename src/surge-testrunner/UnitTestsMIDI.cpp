@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <random>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -1766,3 +1767,117 @@ TEST_CASE("Two On All Notes Off", "[midi]")
         REQUIRE(!g);
     }
 }
+
+TEST_CASE("Sample Accurate Note Onsets", "[midi]")
+{
+    // Render a note started eventSampleOffset samples into a block and report the first
+    // sample it makes a sound on
+    auto onsetFor = [](int offset) {
+        auto surge = surgeOnSaw();
+        REQUIRE(surge);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            surge->process();
+        }
+
+        for (int i = 0; i < BLOCK_SIZE; ++i)
+        {
+            REQUIRE(surge->output[0][i] == 0.f);
+        }
+
+        surge->eventSampleOffset = offset;
+        surge->playNote(0, 60, 127, 0);
+        surge->eventSampleOffset = 0;
+
+        for (int b = 0; b < 2; ++b)
+        {
+            surge->process();
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                if (std::fabs(surge->output[0][i]) > 1e-6)
+                {
+                    return b * BLOCK_SIZE + i;
+                }
+            }
+        }
+
+        return -1;
+    };
+
+    auto ref = onsetFor(0);
+    REQUIRE(ref >= 0);
+    REQUIRE(ref <= 1);
+
+    std::mt19937 gen(8675309);
+    std::uniform_int_distribution<int> distro(1, BLOCK_SIZE - 1);
+
+    for (int t = 0; t < 16; ++t)
+    {
+        auto offset = distro(gen);
+        INFO("Note on at offset " << offset);
+
+        auto onset = onsetFor(offset);
+        REQUIRE(onset >= 0);
+        REQUIRE(std::abs(onset - ref - offset) <= 1);
+    }
+}
+
+TEST_CASE("Sample Accurate Note Onsets Keep The Attack", "[midi]")
+{
+    // A note started at an offset should sound like one started at the block start, just later
+    static constexpr int nBlocks = 12;
+
+    auto renderFrom = [](int offset) {
+        auto surge = surgeOnSaw();
+        REQUIRE(surge);
+
+        // no free running phase or drift, so every render starts the same way
+        surge->storage.getPatch().scene[0].osc[0].retrigger.val.b = true;
+        surge->storage.getPatch().scene[0].drift.val.f = 0.f;
+
+        for (int i = 0; i < 20; ++i)
+        {
+            surge->process();
+        }
+
+        surge->eventSampleOffset = offset;
+        surge->playNote(0, 60, 127, 0);
+        surge->eventSampleOffset = 0;
+
+        std::vector<float> res;
+        for (int b = 0; b < nBlocks; ++b)
+        {
+            surge->process();
+            res.insert(res.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+        }
+        return res;
+    };
+
+    auto ref = renderFrom(0);
+    float peak = 0.f;
+    for (auto f : ref)
+    {
+        peak = std::max(peak, std::fabs(f));
+    }
+    REQUIRE(peak > 0.01);
+
+    for (int offset : {1, 7, 16, 25, BLOCK_SIZE - 1})
+    {
+        INFO("Note on at offset " << offset);
+        auto res = renderFrom(offset);
+
+        float bestError = peak;
+        for (int shift = offset - 1; shift <= offset + 1; ++shift)
+        {
+            float error = 0.f;
+            for (int i = 0; i < (int)ref.size() - shift - 1; ++i)
+            {
+                error = std::max(error, std::fabs(res[i + shift] - ref[i]));
+            }
+            bestError = std::min(bestError, error);
+        }
+        REQUIRE(bestError < 0.02 * peak);
+    }
+}
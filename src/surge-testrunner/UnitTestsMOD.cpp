@@ -23,6 +23,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -1435,3 +1437,104 @@ TEST_CASE("Mod LFO Is Well Behaved", "[mod]")
         }
     }
 }
+
+TEST_CASE("Modulation Routing Reaches Audio Thread As A Snapshot", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &patch = surge->storage.getPatch();
+    auto pid = patch.scene[0].osc[0].pitch.id;
+
+    for (int i = 0; i < 5; ++i)
+        surge->process();
+
+    auto &before = surge->storage.audioModulationRouting();
+    auto nBefore = before.voice[0].size();
+
+    surge->setModDepth01(pid, ms_lfo1, 0, 0, 0.3);
+    REQUIRE(patch.scene[0].modulation_voice.size() == nBefore + 1);
+
+    // Published, but the audio thread only picks it up at the next block
+    REQUIRE(&surge->storage.audioModulationRouting() == &before);
+    REQUIRE(before.voice[0].size() == nBefore);
+
+    surge->process();
+    auto &after = surge->storage.audioModulationRouting();
+    REQUIRE(after.version > before.version);
+    REQUIRE(after.voice[0].size() == nBefore + 1);
+    REQUIRE(after.voice[0].back().source_id == ms_lfo1);
+    REQUIRE(after.voice[0].back().destination_id == patch.param_ptr[pid]->param_id_in_scene);
+
+    surge->muteModulation(pid, ms_lfo1, 0, 0, true);
+    surge->process();
+    REQUIRE(surge->storage.audioModulationRouting().voice[0].back().muted);
+
+    surge->clearModulation(pid, ms_lfo1, 0, 0);
+    surge->process();
+    REQUIRE(surge->storage.audioModulationRouting().voice[0].size() == nBefore);
+}
+
+TEST_CASE("Routing Edits On The Audio Thread Are Published Off It", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &patch = surge->storage.getPatch();
+
+    Surge::Test::setFX(surge, 0, fxt_combulator);
+    surge->setModDepth01(patch.fx[0].p[2].id, ms_slfo1, 0, 0, 0.1);
+    surge->process();
+    REQUIRE(surge->storage.audioModulationRouting().global.size() == 1);
+
+    /*
+     * A type change lands in loadFx inside process(), which clears the routing onto the old
+     * effect. The publisher thread publishes that; the slot goes unmodulated until it has.
+     */
+    auto *pt = &(patch.fx[0].type);
+    surge->setParameter01(surge->idForParameter(pt),
+                          1.f * float(fxt_chorus4) / (pt->val_max.i - pt->val_min.i), false);
+    surge->process();
+    REQUIRE(patch.fx[0].type.val.i == fxt_chorus4);
+    REQUIRE(patch.modulation_global.empty());
+
+    for (int i = 0; i < 1000 && !surge->storage.audioModulationRouting().global.empty(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        surge->process();
+    }
+
+    REQUIRE(surge->storage.audioModulationRouting().global.empty());
+}
+
+TEST_CASE("Compiled Voice Modulation Routing", "[mod]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &sc = surge->storage.getPatch().scene[0];
+
+    for (auto &s : surge->storage.getPatch().scene)
+        s.modulation_voice.clear();
+    surge->storage.publishModulationRouting();
+
+    surge->setModDepth01(sc.osc[0].pitch.id, ms_lfo1, 0, 0, 0.3);
+    surge->setModDepth01(sc.osc[1].pitch.id, ms_velocity, 0, 0, 0.2);
+    surge->setModDepth01(sc.osc[2].pitch.id, ms_lfo1, 0, 0, 0.4);
+    surge->setModDepth01(sc.osc[0].p[0].id, ms_lfo1, 0, 1, 0.5);
+    surge->setModDepth01(sc.osc[0].p[1].id, ms_keytrack, 0, 0, 0.6);
+    surge->muteModulation(sc.osc[0].p[1].id, ms_keytrack, 0, 0, true);
+    surge->process();
+
+    auto &routing = surge->storage.audioModulationRouting();
+    auto &cr = routing.voiceCompiled[0];
+
+    // lfo1 output 0, velocity, lfo1 output 1; the muted keytrack routing is dropped
+    REQUIRE(cr.sourceId == std::vector<int>{ms_lfo1, ms_velocity, ms_lfo1});
+    REQUIRE(cr.sourceIndex == std::vector<int>{0, 0, 1});
+    REQUIRE(cr.sourceIsLFO == std::vector<char>{1, 0, 1});
+    REQUIRE(cr.sourceSlot == std::vector<int>{0, 1, 0, 2});
+    REQUIRE(cr.destination.size() == 4);
+    REQUIRE(cr.destination[2] == sc.osc[2].pitch.param_id_in_scene);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(cr.depth[i] == routing.voice[0][i].depth);
+    }
+
+    REQUIRE(routing.voiceCompiled[1].depth.empty());
+}
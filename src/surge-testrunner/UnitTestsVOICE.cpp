@@ -27,6 +27,7 @@
 
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "SineOscillator.h"
 
 #include "catch2/catch_amalgamated.hpp"
 
@@ -327,3 +328,173 @@ TEST_CASE("Play and release Frequency and Note ID", "[voice]")
         }
     }
 }
+
+namespace
+{
+std::shared_ptr<SurgeSynthesizer> surgeWithRandomScenes(bool parallel, int rngSeed, int sceneSeed)
+{
+    auto s = surgeOnSine();
+    s->storage.getPatch().scenemode.val.i = sm_dual;
+
+    // Give both scenes some per voice and per sample randomness so the RNG streams matter
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        s->storage.getPatch().scene[sc].osc[0].type.val.i = ot_classic;
+        s->storage.getPatch().scene[sc].drift.val.f = 1.f;
+        s->storage.getPatch().scene[sc].level_noise.val.f = 1.f;
+    }
+
+    s->storage.rngGen.g.seed(rngSeed);
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        s->storage.sceneRngGen[sc].g.seed(sceneSeed + sc);
+    }
+
+    s->setParallelSceneRendering(parallel);
+    return s;
+}
+
+// Plays the same sequence on both synths and reports whether every sample matched
+bool rendersIdentically(std::shared_ptr<SurgeSynthesizer> a, std::shared_ptr<SurgeSynthesizer> b)
+{
+    bool same = true;
+    auto play = [&](int blocks) {
+        for (int blk = 0; blk < blocks; ++blk)
+        {
+            a->process();
+            b->process();
+
+            for (int c = 0; c < 2; ++c)
+            {
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    same = same && a->output[c][i] == b->output[c][i];
+                }
+            }
+        }
+    };
+
+    for (auto &s : {a, b})
+    {
+        s->playNote(0, 60, 127, 0);
+        s->playNote(0, 67, 100, 0);
+    }
+    play(200);
+
+    for (auto &s : {a, b})
+    {
+        s->releaseNote(0, 60, 0);
+        s->playNote(0, 72, 90, 0);
+    }
+    play(200);
+
+    for (auto &s : {a, b})
+    {
+        s->allNotesOff();
+    }
+    play(500);
+
+    return same && a->storage.activeVoiceCount == b->storage.activeVoiceCount;
+}
+} // namespace
+
+TEST_CASE("Parallel Scene Rendering Matches Its Serial Fallback", "[voice]")
+{
+    auto threaded = surgeWithRandomScenes(true, 8675309, 1234);
+    auto fallback = surgeWithRandomScenes(true, 8675309, 1234);
+    REQUIRE(threaded->getParallelSceneRendering());
+
+    // An audio input client in scene B forces every block back onto the serial path; nothing
+    // reads the copied scene A output here, so only the threading differs
+    fallback->storage.otherscene_clients = 1;
+
+    REQUIRE(rendersIdentically(threaded, fallback));
+}
+
+TEST_CASE("Serial Scene Rendering Keeps The Baseline Random Stream", "[voice]")
+{
+    SECTION("Scene Generators Are Unused")
+    {
+        auto a = surgeWithRandomScenes(false, 8675309, 1234);
+        auto b = surgeWithRandomScenes(false, 8675309, 4321);
+        REQUIRE(rendersIdentically(a, b));
+    }
+
+    SECTION("The Storage Generator Drives The Output")
+    {
+        auto a = surgeWithRandomScenes(false, 8675309, 1234);
+        auto b = surgeWithRandomScenes(false, 90210, 1234);
+        REQUIRE(!rendersIdentically(a, b));
+    }
+
+    SECTION("Parallel Rendering Uses The Scene Generators")
+    {
+        auto a = surgeWithRandomScenes(true, 8675309, 1234);
+        auto b = surgeWithRandomScenes(true, 8675309, 4321);
+        REQUIRE(!rendersIdentically(a, b));
+    }
+}
+
+TEST_CASE("Batched Sine Oscillators Match Single Voices", "[voice]")
+{
+    auto makeSurge = [](int shape, int unison) {
+        auto s = surgeOnSine();
+        auto &osc = s->storage.getPatch().scene[0].osc[0];
+        osc.p[SineOscillator::sine_shape].val.i = shape;
+        osc.p[SineOscillator::sine_feedback].val.f = 0.3f;
+        osc.p[SineOscillator::sine_FMmode].val.i = 1;
+        osc.p[SineOscillator::sine_unison_voices].val.i = unison;
+        // so the unison voices start on the same phases in every synth
+        osc.retrigger.val.b = true;
+        return s;
+    };
+
+    for (auto [shape, unison] :
+         std::vector<std::pair<int, int>>{{0, 1}, {5, 1}, {17, 1}, {0, 3}, {5, 4}, {17, 7}})
+    {
+        DYNAMIC_SECTION("Sine shape " << shape << " with " << unison << " unison voices")
+        {
+            // Each of these notes renders in its own synth on the per voice path, and all of them
+            // share lanes in the chord synth, so the sum of the singles should be the chord
+            std::vector<int> notes = {48, 55, 60, 64, 67};
+            auto chord = makeSurge(shape, unison);
+            std::vector<std::shared_ptr<SurgeSynthesizer>> singles;
+
+            for (auto n : notes)
+            {
+                auto s = makeSurge(shape, unison);
+                s->playNote(0, n, 90, 0);
+                singles.push_back(s);
+                chord->playNote(0, n, 90, 0);
+            }
+
+            for (int b = 0; b < 4; ++b)
+            {
+                chord->process();
+                for (auto &s : singles)
+                    s->process();
+            }
+
+            REQUIRE(SurgeVoice::planBatchedOscillators(chord->voices[0].begin(),
+                                                       (int)chord->voices[0].size()));
+
+            for (int b = 0; b < 200; ++b)
+            {
+                chord->process();
+                for (auto &s : singles)
+                    s->process();
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int i = 0; i < BLOCK_SIZE; ++i)
+                    {
+                        float sum = 0.f;
+                        for (auto &s : singles)
+                            sum += s->output[c][i];
+                        REQUIRE(chord->output[c][i] == Approx(sum).margin(1e-5));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -73,6 +73,36 @@ int main(int argc, char **argv)
         {
             Surge::Headless::NonTest::performancePlay(argv[3], std::atoi(argv[4]));
         }
+        if (strcmp(argv[2], "--fx-storage-benchmark") == 0)
+        {
+            if (argc < 5)
+            {
+                std::cout << "Usage: --fx-storage-benchmark instances shareTables\n";
+                return 1;
+            }
+            Surge::Headless::NonTest::fxStorageStartupBenchmark(std::atoi(argv[3]),
+                                                                std::atoi(argv[4]) != 0);
+        }
+        if (strcmp(argv[2], "--scene-render-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::sceneRenderBenchmark(argc > 3 ? std::atoi(argv[3]) : 20000);
+        }
+        if (strcmp(argv[2], "--voice-stress-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::voiceStressBenchmark(argc > 3 ? std::atoi(argv[3]) : 20000);
+        }
+        if (strcmp(argv[2], "--host-copy-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::hostBufferCopyBenchmark(argc > 3 ? std::atoi(argv[3]) : 60);
+        }
+        if (strcmp(argv[2], "--wavetable-mipmap-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::wavetableMipMapBenchmark();
+        }
+        if (strcmp(argv[2], "--patch-xml-load-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::patchXMLLoadBenchmark();
+        }
         return 0;
     }
     else
@@ -87,6 +117,18 @@ int main(int argc, char **argv)
                 << "   --non-test --stats-from-every-patch    # play every patch and show RMS\n"
                 << "   --non-test --filter-analyzer ft fst    # analyze filter type/subtype for "
                    "response\n"
+                << "   --non-test --fx-storage-benchmark n s  # startup time and RSS for n FX "
+                   "storages, s=1 shares tables\n"
+                << "   --non-test --scene-render-benchmark n  # time n blocks with scenes "
+                   "rendered serially and in parallel\n"
+                << "   --non-test --voice-stress-benchmark n  # time n blocks of 64 voices "
+                   "with constant retriggering\n"
+                << "   --non-test --host-copy-benchmark n     # time n seconds of output "
+                   "copied per sample and in block runs\n"
+                << "   --non-test --wavetable-mipmap-benchmark # time mip-mapping every "
+                   "factory wavetable\n"
+                << "   --non-test --patch-xml-load-benchmark # time load_xml over every "
+                   "patch, as saved and with reversed params\n"
                 << "\n"
                 << "If you exclude the `--non-test` argument, standard catch2 arguments, below, "
                    "apply\n\n";
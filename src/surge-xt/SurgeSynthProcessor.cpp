@@ -77,6 +77,20 @@ SurgeSynthProcessor::SurgeSynthProcessor()
         return;
     }
 
+    // Keep wavetable file reads and mip-mapping off the audio thread
+    surge->storage.setBackgroundWavetableLoading(true);
+
+    // Reload patches from binary snapshots rather than parsing their XML every time
+    try
+    {
+        surge->storage.setPatchCacheDirectory(fs::temp_directory_path() / "SurgeXT" /
+                                              "PatchCache");
+    }
+    catch (const fs::filesystem_error &)
+    {
+        // no temp directory, so patches just load from XML
+    }
+
 #if BUILD_IS_DEBUG
     oss << "  - Data         : " << surge->storage.datapath.u8string() << "\n"
         << "  - User Data    : " << surge->storage.userDataPath.u8string() << std::endl;
@@ -637,64 +651,95 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         inputIsLatent = true;
     }
 
-    for (int i = 0; i < buffer.getNumSamples(); i++)
-    {
-        while (i == nextMidi)
-        {
-            applyMidi(*midiIt);
-            midiIt++;
+    auto applyNextMidi = [&]() {
+        applyMidi(*midiIt);
+        midiIt++;
 
-            if (midiIt == midiMessages.cend())
-            {
-                nextMidi = -1;
-            }
-            else
-            {
-                nextMidi = (*midiIt).samplePosition;
-            }
+        if (midiIt == midiMessages.cend())
+        {
+            nextMidi = -1;
         }
+        else
+        {
+            nextMidi = (*midiIt).samplePosition;
+        }
+    };
 
-        auto outL = mainOutput.getWritePointer(0, i);
-        auto outR = mainOutput.getWritePointer(1, i);
+    bool sampleAccurate = surge->sampleAccurateMIDI;
 
-        if (blockPos == 0 && incL && incR)
-        {
-            surge->process_input = true;
+    /*
+     * Step through the buffer in runs which end at a block boundary, the end of the buffer or
+     * the next event, copying each run to and from the engine's block buffers in one go.
+     */
+    int i = 0;
 
-            if (inputIsLatent)
-            {
-                memcpy(&(surge->input[0][0]), inputLatentBuffer[0], BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inputLatentBuffer[1], BLOCK_SIZE * sizeof(float));
-            }
-            else
+    while (i < sc)
+    {
+        if (sampleAccurate)
+        {
+            // apply the events for the whole coming block before rendering it, each at its offset
+            // into the block. Ones from samples we've already rendered land at its start.
+            if (blockPos == 0)
             {
-                auto inL = incL + i;
-                auto inR = incR + i;
+                while (nextMidi >= 0 && nextMidi < i + BLOCK_SIZE)
+                {
+                    surge->eventSampleOffset = std::max(nextMidi - i, 0);
+                    applyNextMidi();
+                }
 
-                memcpy(&(surge->input[0][0]), inL, BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inR, BLOCK_SIZE * sizeof(float));
+                surge->eventSampleOffset = 0;
             }
         }
         else
         {
-            surge->process_input = false;
+            while (i == nextMidi)
+            {
+                applyNextMidi();
+            }
         }
 
         if (blockPos == 0)
         {
+            surge->process_input = incL && incR;
+
+            if (surge->process_input)
+            {
+                if (inputIsLatent)
+                {
+                    memcpy(&(surge->input[0][0]), inputLatentBuffer[0],
+                           BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), inputLatentBuffer[1],
+                           BLOCK_SIZE * sizeof(float));
+                }
+                else
+                {
+                    memcpy(&(surge->input[0][0]), incL + i, BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), incR + i, BLOCK_SIZE * sizeof(float));
+                }
+            }
+
             surge->process();
             surge->time_data.ppqPos +=
                 (double)BLOCK_SIZE * surge->time_data.tempo / (60. * surge->storage.samplerate);
         }
 
+        auto n = std::min(BLOCK_SIZE - blockPos, sc - i);
+
+        if (!sampleAccurate && nextMidi > i)
+        {
+            n = std::min(n, nextMidi - i);
+        }
+
+        auto bytes = n * sizeof(float);
+
         if (inputIsLatent && incL && incR)
         {
-            inputLatentBuffer[0][blockPos] = incL[i];
-            inputLatentBuffer[1][blockPos] = incR[i];
+            memcpy(&inputLatentBuffer[0][blockPos], incL + i, bytes);
+            memcpy(&inputLatentBuffer[1][blockPos], incR + i, bytes);
         }
 
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
+        memcpy(mainOutput.getWritePointer(0, i), &surge->output[0][blockPos], bytes);
+        memcpy(mainOutput.getWritePointer(1, i), &surge->output[1][blockPos], bytes);
 
         if (surge->activateExtraOutputs)
         {
@@ -705,8 +750,8 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
                 if (sAL && sAR)
                 {
-                    *sAL = surge->sceneout[0][0][blockPos];
-                    *sAR = surge->sceneout[0][1][blockPos];
+                    memcpy(sAL, &surge->sceneout[0][0][blockPos], bytes);
+                    memcpy(sAR, &surge->sceneout[0][1][blockPos], bytes);
                 }
             }
 
@@ -717,13 +762,14 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
                 if (sBL && sBR)
                 {
-                    *sBL = surge->sceneout[1][0][blockPos];
-                    *sBR = surge->sceneout[1][1][blockPos];
+                    memcpy(sBL, &surge->sceneout[1][0][blockPos], bytes);
+                    memcpy(sBR, &surge->sceneout[1][1][blockPos], bytes);
                 }
             }
         }
 
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
+        i += n;
     }
 
     // This should, in theory, never happen, but better safe than sorry
@@ -1121,7 +1167,13 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
             haveSceneOut = false;
     }
 
-    for (int s = 0; s < process->frames_count; ++s)
+    bool sampleAccurate = surge->sampleAccurateMIDI;
+
+    // events only land on block boundaries here, so each run goes to the end of a block
+    int s = 0;
+    int frames = process->frames_count;
+
+    while (s < frames)
     {
         if (blockPos == 0)
         {
@@ -1129,6 +1181,11 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
             {
                 auto evt = ev->get(ev, currev);
 
+                if (sampleAccurate)
+                {
+                    surge->eventSampleOffset = std::max((int)evt->time - s, 0);
+                }
+
                 process_clap_event(evt);
 
                 currev++;
@@ -1141,6 +1198,8 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                     nextevtime = -1;
                 }
             }
+
+            surge->eventSampleOffset = 0;
         }
 
         if (blockPos == 0)
@@ -1178,27 +1237,30 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
                 }
             }
         }
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
-        outL++;
-        outR++;
+
+        auto n = std::min(BLOCK_SIZE - blockPos, frames - s);
+        auto bytes = n * sizeof(float);
+
+        memcpy(outL, &surge->output[0][blockPos], bytes);
+        memcpy(outR, &surge->output[1][blockPos], bytes);
+        outL += n;
+        outR += n;
 
         if (haveSceneOut)
         {
-            *sceneAL = surge->sceneout[0][0][blockPos];
-            *sceneAR = surge->sceneout[0][1][blockPos];
-            *sceneBL = surge->sceneout[1][0][blockPos];
-            *sceneBR = surge->sceneout[1][1][blockPos];
-
-            sceneAL++;
-            sceneAR++;
-            sceneBL++;
-            sceneBR++;
+            memcpy(sceneAL, &surge->sceneout[0][0][blockPos], bytes);
+            memcpy(sceneAR, &surge->sceneout[0][1][blockPos], bytes);
+            memcpy(sceneBL, &surge->sceneout[1][0][blockPos], bytes);
+            memcpy(sceneBR, &surge->sceneout[1][1][blockPos], bytes);
+
+            sceneAL += n;
+            sceneAR += n;
+            sceneBL += n;
+            sceneBR += n;
         }
 
-        // TO DO: Scene Output
-
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
+        s += n;
     }
 
     // just in case
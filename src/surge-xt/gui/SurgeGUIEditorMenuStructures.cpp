@@ -1323,6 +1323,18 @@ juce::PopupMenu SurgeGUIEditor::makeWorkflowMenu(const juce::Point<int> &where)
 
     makeScopeEntry(wfMenu);
 
+    wfMenu.addSeparator();
+
+    bool parallelScenes = synth->getParallelSceneRendering();
+
+    wfMenu.addItem(Surge::GUI::toOSCase("Render Scenes on Separate Threads"), true, parallelScenes,
+                   [this, parallelScenes]() {
+                       Surge::Storage::updateUserDefaultValue(
+                           &(this->synth->storage), Surge::Storage::ParallelSceneRendering,
+                           !parallelScenes);
+                       synth->setParallelSceneRendering(!parallelScenes);
+                   });
+
     return wfMenu;
 }
 
@@ -1710,6 +1722,16 @@ juce::PopupMenu SurgeGUIEditor::makeMidiMenu(const juce::Point<int> &where)
                             this->synth->midiSoftTakeover = !softTakeover;
                         });
 
+    bool sampleAccurate = this->synth->sampleAccurateMIDI;
+
+    midiSubMenu.addItem(Surge::GUI::toOSCase("Sample Accurate Note Onsets and Controllers"), true,
+                        sampleAccurate, [this, sampleAccurate]() {
+                            Surge::Storage::updateUserDefaultValue(
+                                &(this->synth->storage), Surge::Storage::SampleAccurateMIDI,
+                                !sampleAccurate);
+                            this->synth->sampleAccurateMIDI = !sampleAccurate;
+                        });
+
     midiSubMenu.addSeparator();
 
     midiSubMenu.addItem(Surge::GUI::toOSCase("Save MIDI Mapping As..."), [this, where]() {
@@ -0,0 +1,167 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_SURGE_XT_GUI_WIDGETS_BACKGROUNDCURVERENDERER_H
+#define SURGE_SRC_SURGE_XT_GUI_WIDGETS_BACKGROUNDCURVERENDERER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "juce_gui_basics/juce_gui_basics.h"
+
+namespace Surge
+{
+namespace Widgets
+{
+inline void hashCombine(uint64_t &h, uint64_t v)
+{
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+}
+
+inline uint64_t hashFloat(float f) { return std::hash<float>{}(f); }
+
+/*
+ * Holds the curve a display last rendered, keyed by a hash of what it was rendered from, and
+ * renders new ones on a thread of its own. A paint asks for the curve for its current key; if the
+ * one held is for some other key it gets that one anyway, and a job for its key is queued in place
+ * of any queued job which hasn't started yet. Once a render is done, onRendered is called on the
+ * message thread so the display can paint again. So dragging a control repaints the last finished
+ * curve straight away, while the thread renders whatever value the control is at whenever it's
+ * free, rather than every value in between being rendered on the message thread.
+ *
+ * render is called on the render thread with a job of its own and returns false to drop the
+ * curve, when what it was asked to render has gone away in the meantime. Destroy the renderer
+ * before anything render uses.
+ */
+template <typename Job, typename Curve> struct BackgroundCurveRenderer
+{
+    using render_t = std::function<bool(Job &, Curve &)>;
+
+    BackgroundCurveRenderer(juce::Component *owner, render_t render,
+                            std::function<void()> onRendered)
+        : owner(owner), render(std::move(render)), onRendered(std::move(onRendered))
+    {
+        thread = std::thread([this]() { run(); });
+    }
+
+    ~BackgroundCurveRenderer()
+    {
+        {
+            std::lock_guard<std::mutex> g(m);
+            quitting = true;
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    /*
+     * The latest curve, which may be for another key or null if nothing has been rendered yet.
+     * makeJob() is only called when key isn't already rendered or on its way. Message thread.
+     */
+    template <typename F> std::shared_ptr<const Curve> get(uint64_t key, F &&makeJob)
+    {
+        std::lock_guard<std::mutex> g(m);
+
+        bool have = latest && latestKey == key;
+        bool coming = (pending && pendingKey == key) || (running && runningKey == key);
+
+        if (!have && !coming)
+        {
+            pending = std::make_unique<Job>(makeJob());
+            pendingKey = key;
+            cv.notify_one();
+        }
+
+        return latest;
+    }
+
+  private:
+    void run()
+    {
+        while (true)
+        {
+            std::unique_ptr<Job> job;
+            uint64_t key;
+
+            {
+                std::unique_lock<std::mutex> l(m);
+                cv.wait(l, [this]() { return pending || quitting; });
+
+                if (quitting)
+                {
+                    return;
+                }
+
+                job = std::move(pending);
+                key = pendingKey;
+                running = true;
+                runningKey = key;
+            }
+
+            auto c = std::make_shared<Curve>();
+            bool keep = render(*job, *c);
+
+            {
+                std::lock_guard<std::mutex> g(m);
+
+                running = false;
+
+                if (keep)
+                {
+                    latest = std::move(c);
+                    latestKey = key;
+                }
+            }
+
+            if (keep)
+            {
+                // owner was wrapped on the message thread and is only checked back there
+                juce::MessageManager::callAsync([o = owner, f = onRendered]() {
+                    if (o)
+                    {
+                        f();
+                    }
+                });
+            }
+        }
+    }
+
+    juce::Component::SafePointer<juce::Component> owner;
+    render_t render;
+    std::function<void()> onRendered;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::unique_ptr<Job> pending;
+    std::shared_ptr<const Curve> latest;
+    uint64_t pendingKey{0}, latestKey{0}, runningKey{0};
+    bool running{false}, quitting{false};
+    std::thread thread;
+};
+} // namespace Widgets
+} // namespace Surge
+
+#endif // SURGE_SRC_SURGE_XT_GUI_WIDGETS_BACKGROUNDCURVERENDERER_H
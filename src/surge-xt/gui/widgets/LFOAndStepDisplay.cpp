@@ -26,9 +26,9 @@
 #include "SurgeGUIEditor.h"
 #include "SurgeGUIUtils.h"
 #include "SurgeJUCEHelpers.h"
+#include "DebugHelpers.h"
 #include "RuntimeFont.h"
 #include <algorithm>
-#include <chrono>
 #include "widgets/MenuCustomComponents.h"
 #include "AccessibleHelpers.h"
 #include "overlays/TypeinParamEditor.h"
@@ -37,25 +37,6 @@ namespace Surge
 {
 namespace Widgets
 {
-
-struct TimeB
-{
-    TimeB(std::string i) : tag(i) { start = std::chrono::high_resolution_clock::now(); }
-
-    ~TimeB()
-    {
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = end - start;
-
-        auto durationFloat =
-            std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-        // std::cout << "Block in " << tag << " took " << durationFloat << "us" << std::endl;
-        // FIX - record this so I can report
-    }
-    std::string tag;
-    std::chrono::time_point<std::chrono::high_resolution_clock> start;
-};
-
 LFOAndStepDisplay::LFOAndStepDisplay(SurgeGUIEditor *e)
     : juce::Component(), WidgetBaseMixin<LFOAndStepDisplay>(this), guiEditor(e)
 {
@@ -66,6 +47,13 @@ LFOAndStepDisplay::LFOAndStepDisplay(SurgeGUIEditor *e)
     backingImage = std::make_unique<juce::Image>(juce::Image::PixelFormat::ARGB, 50, 50, true);
     waveformIsUpdated = true;
 
+    waveRenderer = std::make_unique<BackgroundCurveRenderer<WaveJob, WaveCurve>>(
+        this, [this](auto &job, auto &curve) { return renderWave(job, curve); },
+        [this]() {
+            forceRepaint = true;
+            repaint();
+        });
+
     typeLayer = std::make_unique<OverlayAsAccessibleContainer>("LFO Type");
     addAndMakeVisible(*typeLayer);
     for (int i = 0; i < n_lfo_types; ++i)
@@ -409,7 +397,7 @@ void LFOAndStepDisplay::resized()
 
 void LFOAndStepDisplay::paint(juce::Graphics &g)
 {
-    TimeB paint("outerPaint");
+    Surge::Debug::TimeB paint("outerPaint");
 
     if (ss && lfodata->shape.val.i == lt_stepseq)
     {
@@ -492,54 +480,159 @@ void LFOAndStepDisplay::setZoomFactor(int zoom)
     zoomFactor = zoom;
 }
 
-void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
+uint64_t LFOAndStepDisplay::waveKey()
 {
-    TimeB mainTimer("-- paintWaveform");
+    uint64_t h = 0;
 
-    juce::Path deactPath, path, eupath, edpath;
-    bool drawBeats = isAnythingTemposynced();
+    auto *p = &lfodata->rate;
+
+    while (p <= &lfodata->release)
+    {
+        hashCombine(h, p->val.i);
+        hashCombine(h, p->temposync);
+        hashCombine(h, p->deactivated);
+        hashCombine(h, p->extend_range);
+        hashCombine(h, p->deform_type);
+        hashCombine(h, p->absolute);
+        ++p;
+    }
+
+    hashCombine(h, lfodata->lfoExtraAmplitude);
+    hashCombine(h, modIndex);
+    hashCombine(h, lfoid < n_lfos_voice);
+    hashCombine(h, waveform_display.getWidth());
+    hashCombine(h, hashFloat(storage->samplerate));
+    hashCombine(h, hashFloat(storage->temposyncratio));
+    hashCombine(h, useAmpWave());
+
+    if (ss && lfodata->shape.val.i == lt_stepseq)
+    {
+        for (auto s : ss->steps)
+        {
+            hashCombine(h, hashFloat(s));
+        }
+
+        hashCombine(h, ss->loop_start);
+        hashCombine(h, ss->loop_end);
+        hashCombine(h, hashFloat(ss->shuffle));
+        hashCombine(h, ss->trigmask);
+    }
+
+    if (ms && lfodata->shape.val.i == lt_mseg)
+    {
+        hashCombine(h, ms->endpointMode);
+        hashCombine(h, ms->editMode);
+        hashCombine(h, ms->loopMode);
+        hashCombine(h, ms->loop_start);
+        hashCombine(h, ms->loop_end);
+        hashCombine(h, ms->n_activeSegments);
+        hashCombine(h, hashFloat(ms->totalDuration));
+        hashCombine(h, hashFloat(ms->envelopeModeDuration));
+        hashCombine(h, hashFloat(ms->envelopeModeNV1));
+
+        for (int i = 0; i < ms->n_activeSegments; ++i)
+        {
+            auto &s = ms->segments[i];
+
+            for (auto f : {s.duration, s.v0, s.nv1, s.cpduration, s.cpv, s.dragcpv, s.dragcpratio,
+                           ms->segmentStart[i], ms->segmentEnd[i]})
+            {
+                hashCombine(h, hashFloat(f));
+            }
+
+            hashCombine(h, s.type);
+            hashCombine(h, s.useDeform);
+            hashCombine(h, s.invertDeform);
+            hashCombine(h, s.retriggerFEG);
+            hashCombine(h, s.retriggerAEG);
+        }
+    }
+
+    return h;
+}
+
+bool LFOAndStepDisplay::useAmpWave()
+{
+    return skin->getVersion() >= 2 &&
+           Surge::Storage::getUserDefaultValue(
+               storage, Surge::Storage::ShowGhostedLFOWaveReference, 1);
+}
+
+LFOAndStepDisplay::WaveJob LFOAndStepDisplay::makeWaveJob()
+{
+    WaveJob job;
+
+    job.lfo = *lfodata;
+    job.hasSS = ss != nullptr;
+    job.hasMS = ms != nullptr;
+
+    if (ss)
+    {
+        job.ss = *ss;
+    }
+
+    if (ms)
+    {
+        job.ms = *ms;
+    }
+
+    job.modIndex = modIndex;
+    job.width = waveform_display.getWidth();
+    job.temposyncratio = storage->temposyncratio;
+    job.isVoice = lfoid < n_lfos_voice;
+    job.useAmpWave = useAmpWave();
+
+    return job;
+}
+
+bool LFOAndStepDisplay::renderWave(WaveJob &job, WaveCurve &c)
+{
+    Surge::Debug::TimeB renderTimer("-- renderWave");
+
+    auto *lfo = &job.lfo;
+    auto *jss = job.hasSS ? &job.ss : nullptr;
+    auto *jms = job.hasMS ? &job.ms : nullptr;
+    bool isFormula = lfo->shape.val.i == lt_formula;
 
     pdata tp[n_scene_params], tpd[n_scene_params];
 
-    tp[lfodata->delay.param_id_in_scene].i = lfodata->delay.val.i;
-    tp[lfodata->attack.param_id_in_scene].i = lfodata->attack.val.i;
-    tp[lfodata->hold.param_id_in_scene].i = lfodata->hold.val.i;
-    tp[lfodata->decay.param_id_in_scene].i = lfodata->decay.val.i;
-    tp[lfodata->sustain.param_id_in_scene].i = lfodata->sustain.val.i;
-    tp[lfodata->release.param_id_in_scene].i = lfodata->release.val.i;
+    tp[lfo->delay.param_id_in_scene].i = lfo->delay.val.i;
+    tp[lfo->attack.param_id_in_scene].i = lfo->attack.val.i;
+    tp[lfo->hold.param_id_in_scene].i = lfo->hold.val.i;
+    tp[lfo->decay.param_id_in_scene].i = lfo->decay.val.i;
+    tp[lfo->sustain.param_id_in_scene].i = lfo->sustain.val.i;
+    tp[lfo->release.param_id_in_scene].i = lfo->release.val.i;
 
-    tp[lfodata->magnitude.param_id_in_scene].i = lfodata->magnitude.val.i;
-    tp[lfodata->rate.param_id_in_scene].i = lfodata->rate.val.i;
-    tp[lfodata->shape.param_id_in_scene].i = lfodata->shape.val.i;
-    tp[lfodata->start_phase.param_id_in_scene].i = lfodata->start_phase.val.i;
-    tp[lfodata->deform.param_id_in_scene].i = lfodata->deform.val.i;
-    tp[lfodata->trigmode.param_id_in_scene].i = lm_keytrigger;
+    tp[lfo->magnitude.param_id_in_scene].i = lfo->magnitude.val.i;
+    tp[lfo->rate.param_id_in_scene].i = lfo->rate.val.i;
+    tp[lfo->shape.param_id_in_scene].i = lfo->shape.val.i;
+    tp[lfo->start_phase.param_id_in_scene].i = lfo->start_phase.val.i;
+    tp[lfo->deform.param_id_in_scene].i = lfo->deform.val.i;
+    tp[lfo->trigmode.param_id_in_scene].i = lm_keytrigger;
 
     float susTime = 0.5;
-    bool msegRelease = false;
-    float msegReleaseAt = 0;
-    float lfoEnvelopeDAHDTime = pow(2.0f, lfodata->delay.val.f) + pow(2.0f, lfodata->attack.val.f) +
-                                pow(2.0f, lfodata->hold.val.f) + pow(2.0f, lfodata->decay.val.f);
+    float lfoEnvelopeDAHDTime = pow(2.0f, lfo->delay.val.f) + pow(2.0f, lfo->attack.val.f) +
+                                pow(2.0f, lfo->hold.val.f) + pow(2.0f, lfo->decay.val.f);
 
-    if (lfodata->shape.val.i == lt_mseg)
+    if (lfo->shape.val.i == lt_mseg && jms)
     {
         // We want the sus time to get us through at least one loop
-        if (ms->loopMode == MSEGStorage::GATED_LOOP && ms->editMode == MSEGStorage::ENVELOPE &&
-            ms->loop_end >= 0)
+        if (jms->loopMode == MSEGStorage::GATED_LOOP && jms->editMode == MSEGStorage::ENVELOPE &&
+            jms->loop_end >= 0)
         {
-            float loopEndsAt = ms->segmentEnd[ms->loop_end];
+            float loopEndsAt = jms->segmentEnd[jms->loop_end];
             susTime = std::max(0.5f, loopEndsAt - lfoEnvelopeDAHDTime);
-            msegReleaseAt = lfoEnvelopeDAHDTime + susTime;
-            msegRelease = true;
+            c.msegReleaseAt = lfoEnvelopeDAHDTime + susTime;
+            c.msegRelease = true;
         }
     }
 
-    float totalEnvTime = lfoEnvelopeDAHDTime + std::min(pow(2.0f, lfodata->release.val.f), 4.f) +
+    float totalEnvTime = lfoEnvelopeDAHDTime + std::min(pow(2.0f, lfo->release.val.f), 4.f) +
                          0.5; // susTime; this is now 0.5 to keep the envelope fixed in gate mode
 
-    float rateInHz = pow(2.0, (double)lfodata->rate.val.f);
-    if (lfodata->rate.temposync)
-        rateInHz *= storage->temposyncratio;
+    float rateInHz = pow(2.0, (double)lfo->rate.val.f);
+    if (lfo->rate.temposync)
+        rateInHz *= job.temposyncratio;
 
     /*
      * What we want is no more than 50 wavelengths. So
@@ -555,58 +648,64 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
     // std::cout << _D(totalEnvTime) << std::endl;
     // std::cout << _D(rateInHz) << _D(1.0/rateInHz) << _D(totalEnvTime*rateInHz) << std::endl;
 
-    LFOModulationSource *tlfo = new LFOModulationSource();
-    LFOModulationSource *tFullWave = nullptr;
-    tlfo->assign(storage, lfodata, tp, 0, ss, ms, fs, true);
-    populateLFOMS(tlfo);
+    // Only formulas need the patch's controller state, and they're rendered on the message thread
+    auto setupLFOMS = [&](LFOModulationSource *s) {
+        if (isFormula)
+        {
+            populateLFOMS(s);
+        }
+        else
+        {
+            s->setIsVoice(job.isVoice);
+        }
+    };
+
+    auto tlfo = std::make_unique<LFOModulationSource>();
+    std::unique_ptr<LFOModulationSource> tFullWave;
+    tlfo->assign(storage, lfo, tp, 0, jss, jms, fs, true);
+    setupLFOMS(tlfo.get());
     tlfo->attack();
 
     LFOStorage deactivateStorage;
-    bool hasFullWave = false, waveIsAmpWave = false;
 
-    if (lfodata->rate.deactivated)
+    if (lfo->rate.deactivated)
     {
-        hasFullWave = true;
-        deactivateStorage = *lfodata;
+        c.hasFullWave = true;
+        deactivateStorage = *lfo;
         std::copy(std::begin(tp), std::end(tp), std::begin(tpd));
 
         auto desiredRate = log2(1.f / totalEnvTime);
-        if (lfodata->shape.val.i == lt_mseg)
+        if (lfo->shape.val.i == lt_mseg && jms)
         {
-            desiredRate = log2(ms->totalDuration / totalEnvTime);
+            desiredRate = log2(jms->totalDuration / totalEnvTime);
         }
 
         deactivateStorage.rate.deactivated = false;
         deactivateStorage.rate.val.f = desiredRate;
         deactivateStorage.start_phase.val.f = 0;
-        tpd[lfodata->start_phase.param_id_in_scene].f = 0;
-        tpd[lfodata->rate.param_id_in_scene].f = desiredRate;
-        tFullWave = new LFOModulationSource();
-        tFullWave->assign(storage, &deactivateStorage, tpd, 0, ss, ms, fs, true);
-        populateLFOMS(tFullWave);
+        tpd[lfo->start_phase.param_id_in_scene].f = 0;
+        tpd[lfo->rate.param_id_in_scene].f = desiredRate;
+        tFullWave = std::make_unique<LFOModulationSource>();
+        tFullWave->assign(storage, &deactivateStorage, tpd, 0, jss, jms, fs, true);
+        setupLFOMS(tFullWave.get());
         tFullWave->attack();
     }
-    else if (lfodata->magnitude.val.f != lfodata->magnitude.val_max.f && skin->getVersion() >= 2)
+    else if (lfo->magnitude.val.f != lfo->magnitude.val_max.f && job.useAmpWave)
     {
-        bool useAmpWave = Surge::Storage::getUserDefaultValue(
-            storage, Surge::Storage::ShowGhostedLFOWaveReference, 1);
-        if (useAmpWave)
-        {
-            hasFullWave = true;
-            waveIsAmpWave = true;
-            deactivateStorage = *lfodata;
-            std::copy(std::begin(tp), std::end(tp), std::begin(tpd));
+        c.hasFullWave = true;
+        c.waveIsAmpWave = true;
+        deactivateStorage = *lfo;
+        std::copy(std::begin(tp), std::end(tp), std::begin(tpd));
 
-            deactivateStorage.magnitude.val.f = 1.f;
-            tpd[lfodata->magnitude.param_id_in_scene].f = 1.f;
-            tFullWave = new LFOModulationSource();
-            tFullWave->assign(storage, &deactivateStorage, tpd, 0, ss, ms, fs, true);
-            populateLFOMS(tFullWave);
-            tFullWave->attack();
-        }
+        deactivateStorage.magnitude.val.f = 1.f;
+        tpd[lfo->magnitude.param_id_in_scene].f = 1.f;
+        tFullWave = std::make_unique<LFOModulationSource>();
+        tFullWave->assign(storage, &deactivateStorage, tpd, 0, jss, jms, fs, true);
+        setupLFOMS(tFullWave.get());
+        tFullWave->attack();
     }
 
-    if (lfodata->shape.val.i == lt_formula)
+    if (isFormula)
     {
         if (!tlfo->formulastate.useEnvelope)
         {
@@ -614,18 +713,12 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
         }
     }
 
-    bool drawEnvelope = !lfodata->delay.deactivated;
-
-    if (skin->hasColor(Colors::LFO::Waveform::Background))
-    {
-        g.setColour(skin->getColor(Colors::LFO::Waveform::Background));
-        g.fillRect(waveform_display);
-    }
+    c.drawEnvelope = !lfo->delay.deactivated;
 
-    int minSamples = (1 << 0) * (int)(waveform_display.getWidth());
+    int minSamples = (1 << 0) * job.width;
     int totalSamples =
         std::max((int)minSamples, (int)(totalEnvTime * storage->samplerate / BLOCK_SIZE));
-    float drawnTime = totalSamples * storage->samplerate_inv * BLOCK_SIZE;
+    c.drawnTime = totalSamples * storage->samplerate_inv * BLOCK_SIZE;
 
     // OK so let's assume we want about 1000 pixels worth tops in
     int averagingWindow = (int)(totalSamples / 1000.0) + 1;
@@ -634,9 +727,7 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
     int susCountdown = -1;
 
     float priorval = 0.f, priorwval = 0.f;
-
-    bool warnForInvalid{false};
-    std::string invalidMessage;
+    bool unipolar = lfo->unipolar.val.b;
 
     for (int i = 0; i < totalSamples; i += averagingWindow)
     {
@@ -657,13 +748,13 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
                 tFullWave->process_block();
             }
 
-            if (lfodata->shape.val.i == lt_formula)
+            if (isFormula)
             {
                 if (!tlfo->formulastate.isFinite ||
                     (tFullWave && !tFullWave->formulastate.isFinite))
                 {
-                    warnForInvalid = true;
-                    invalidMessage = "Formula produced nan or inf";
+                    c.warnForInvalid = true;
+                    c.invalidMessage = "Formula produced nan or inf";
                 }
             }
 
@@ -685,11 +776,11 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
                 susCountdown--;
             }
 
-            val += tlfo->get_output(modIndex);
+            val += tlfo->get_output(job.modIndex);
 
             if (tFullWave)
             {
-                auto v = tFullWave->get_output(modIndex);
+                auto v = tFullWave->get_output(job.modIndex);
 
                 minwval = std::min(v, minwval);
                 maxwval = std::max(v, maxwval);
@@ -698,17 +789,17 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
 
             if (s == 0)
             {
-                firstval = tlfo->get_output(modIndex);
+                firstval = tlfo->get_output(job.modIndex);
             }
 
             if (s == averagingWindow - 1)
             {
-                lastval = tlfo->get_output(modIndex);
+                lastval = tlfo->get_output(job.modIndex);
             }
 
-            minval = std::min(tlfo->get_output(modIndex), minval);
-            maxval = std::max(tlfo->get_output(modIndex), maxval);
-            eval += tlfo->env_val * lfodata->magnitude.get_extended(lfodata->magnitude.val.f);
+            minval = std::min(tlfo->get_output(job.modIndex), minval);
+            maxval = std::max(tlfo->get_output(job.modIndex), maxval);
+            eval += tlfo->env_val * lfo->magnitude.get_extended(lfo->magnitude.val.f);
         }
 
         val = val / averagingWindow;
@@ -725,17 +816,17 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
 
         if (i == 0)
         {
-            path.startNewSubPath(xc, val);
-            eupath.startNewSubPath(xc, euval);
+            c.path.startNewSubPath(xc, val);
+            c.eupath.startNewSubPath(xc, euval);
 
-            if (!isUnipolar())
+            if (!unipolar)
             {
-                edpath.startNewSubPath(xc, edval);
+                c.edpath.startNewSubPath(xc, edval);
             }
 
             if (tFullWave)
             {
-                deactPath.startNewSubPath(xc, wval);
+                c.deactPath.startNewSubPath(xc, wval);
             }
 
             priorval = val;
@@ -756,12 +847,12 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
                 secondval = minval;
             }
 
-            path.lineTo(xc - 0.1 * valScale / totalSamples, firstval);
-            path.lineTo(xc + 0.1 * valScale / totalSamples, secondval);
+            c.path.lineTo(xc - 0.1 * valScale / totalSamples, firstval);
+            c.path.lineTo(xc + 0.1 * valScale / totalSamples, secondval);
 
             priorval = val;
-            eupath.lineTo(xc, euval);
-            edpath.lineTo(xc, edval);
+            c.eupath.lineTo(xc, euval);
+            c.edpath.lineTo(xc, edval);
 
             // We can skip the ordering thing since we know we have set rate here to a low rate
             if (tFullWave)
@@ -773,28 +864,63 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
                     firstval = maxwval;
                     secondval = minwval;
                 }
-                deactPath.lineTo(xc - 0.1 * valScale / totalSamples, firstval);
-                deactPath.lineTo(xc + 0.1 * valScale / totalSamples, secondval);
+                c.deactPath.lineTo(xc - 0.1 * valScale / totalSamples, firstval);
+                c.deactPath.lineTo(xc + 0.1 * valScale / totalSamples, secondval);
                 priorwval = wval;
             }
         }
     }
 
-    if (lfodata->shape.val.i == lt_formula)
+    if (isFormula)
     {
-        drawEnvelope = tlfo->formulastate.useEnvelope;
+        c.drawEnvelope = tlfo->formulastate.useEnvelope;
     }
 
     tlfo->completedModulation();
 
-    delete tlfo;
-
     if (tFullWave)
     {
         tFullWave->completedModulation();
-        delete tFullWave;
     }
 
+    return true;
+}
+
+void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
+{
+    Surge::Debug::TimeB mainTimer("-- paintWaveform");
+
+    bool drawBeats = isAnythingTemposynced();
+
+    if (skin->hasColor(Colors::LFO::Waveform::Background))
+    {
+        g.setColour(skin->getColor(Colors::LFO::Waveform::Background));
+        g.fillRect(waveform_display);
+    }
+
+    /*
+     * Formulas run in the display's Lua state, which belongs to the message thread, and can
+     * read patch state the key doesn't cover, so they're still simulated here whenever the
+     * waveform is redrawn. Everything else comes from the cache, or is the last curve rendered
+     * while a new one is on its way.
+     */
+    std::shared_ptr<const WaveCurve> curve;
+
+    if (isFormula())
+    {
+        auto job = makeWaveJob();
+        auto fc = std::make_shared<WaveCurve>();
+
+        renderWave(job, *fc);
+        curve = fc;
+    }
+    else
+    {
+        curve = waveRenderer->get(waveKey(), [this]() { return makeWaveJob(); });
+    }
+
+    float valScale = 100.0;
+
     auto at =
         juce::AffineTransform()
             .scale(waveform_display.getWidth() / valScale, waveform_display.getHeight() / valScale)
@@ -841,14 +967,22 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
         }
     }
 
-    if (drawEnvelope)
+    // nothing's been rendered yet, and the render thread will have us paint again once it has
+    if (!curve)
+    {
+        return;
+    }
+
+    auto drawnTime = curve->drawnTime;
+
+    if (curve->drawEnvelope)
     {
         g.setColour(skin->getColor(Colors::LFO::Waveform::Envelope));
-        g.strokePath(eupath, juce::PathStrokeType(1.f), at);
+        g.strokePath(curve->eupath, juce::PathStrokeType(1.f), at);
 
         if (!isUnipolar())
         {
-            g.strokePath(edpath, juce::PathStrokeType(1.f), at);
+            g.strokePath(curve->edpath, juce::PathStrokeType(1.f), at);
         }
     }
 
@@ -925,22 +1059,22 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
         }
     }
 
-    if (hasFullWave)
+    if (curve->hasFullWave)
     {
-        if (waveIsAmpWave)
+        if (curve->waveIsAmpWave)
         {
             g.setColour(skin->getColor(Colors::LFO::Waveform::GhostedWave));
             auto dotted = juce::Path();
             auto st = juce::PathStrokeType(0.3, juce::PathStrokeType::beveled,
                                            juce::PathStrokeType::butt);
             float dashLength[2] = {4.f, 2.f};
-            st.createDashedStroke(dotted, deactPath, dashLength, 2, at);
+            st.createDashedStroke(dotted, curve->deactPath, dashLength, 2, at);
             g.strokePath(dotted, st);
         }
         else
         {
             g.setColour(skin->getColor(Colors::LFO::Waveform::DeactivatedWave));
-            g.strokePath(deactPath,
+            g.strokePath(curve->deactPath,
                          juce::PathStrokeType(0.5f, juce::PathStrokeType::beveled,
                                               juce::PathStrokeType::butt),
                          at);
@@ -948,9 +1082,10 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
     }
 
     g.setColour(skin->getColor(Colors::LFO::Waveform::Wave));
-    g.strokePath(
-        path, juce::PathStrokeType(1.f, juce::PathStrokeType::beveled, juce::PathStrokeType::butt),
-        at);
+    g.strokePath(curve->path,
+                 juce::PathStrokeType(1.f, juce::PathStrokeType::beveled,
+                                      juce::PathStrokeType::butt),
+                 at);
 
     // lower ruler calculation
     // find time delta
@@ -1002,10 +1137,10 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
      * with the MSEG but I wrote it to debug and we may change our mind so keeping this code
      * here
      */
-    if (msegRelease && false)
+    if (curve->msegRelease && false)
     {
 #if SHOW_RELEASE_TIMES
-        float xp = msegReleaseAt / drawnTime * valScale;
+        float xp = curve->msegReleaseAt / drawnTime * valScale;
         was a vstgui Point sp(xp, valScale * 0.9), ep(xp, valScale * 0.1);
         tf.transform(sp);
         tf.transform(ep);
@@ -1014,11 +1149,11 @@ void LFOAndStepDisplay::paintWaveform(juce::Graphics &g)
 #endif
     }
 
-    if (warnForInvalid)
+    if (curve->warnForInvalid)
     {
         g.setColour(skin->getColor(Colors::LFO::Waveform::Wave));
         g.setFont(skin->fontManager->getLatoAtSize(14, juce::Font::bold));
-        g.drawText(invalidMessage, waveform_display.withTrimmedBottom(30),
+        g.drawText(curve->invalidMessage, waveform_display.withTrimmedBottom(30),
                    juce::Justification::centred);
     }
 }
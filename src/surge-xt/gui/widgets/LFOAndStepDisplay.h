@@ -24,6 +24,7 @@
 #define SURGE_SRC_SURGE_XT_GUI_WIDGETS_LFOANDSTEPDISPLAY_H
 
 #include "WidgetBaseMixin.h"
+#include "BackgroundCurveRenderer.h"
 #include "SurgeStorage.h"
 
 #include "juce_gui_basics/juce_gui_basics.h"
@@ -273,6 +274,38 @@ struct LFOAndStepDisplay : public juce::Component,
 
     SurgeGUIEditor *guiEditor;
 
+    /*
+     * The waveform is simulated on waveRenderer's thread from copies of the LFO, step sequencer
+     * and MSEG storage, and the curves kept under a hash of what they were simulated from.
+     */
+    struct WaveJob
+    {
+        LFOStorage lfo;
+        StepSequencerStorage ss;
+        MSEGStorage ms;
+        bool hasSS{false}, hasMS{false};
+        int modIndex{0}, width{0};
+        float temposyncratio{1};
+        bool isVoice{false}, useAmpWave{false};
+    };
+
+    struct WaveCurve
+    {
+        juce::Path path, eupath, edpath, deactPath;
+        bool hasFullWave{false}, waveIsAmpWave{false}, drawEnvelope{true};
+        bool warnForInvalid{false}, msegRelease{false};
+        float drawnTime{0}, msegReleaseAt{0};
+        std::string invalidMessage;
+    };
+
+    uint64_t waveKey();
+    bool useAmpWave();
+    WaveJob makeWaveJob();
+    bool renderWave(WaveJob &job, WaveCurve &curve);
+
+    // last, so it stops rendering before anything it renders with goes away
+    std::unique_ptr<BackgroundCurveRenderer<WaveJob, WaveCurve>> waveRenderer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LFOAndStepDisplay);
 };
 } // namespace Widgets
@@ -34,6 +34,7 @@
 #include "widgets/MenuCustomComponents.h"
 #include "AccessibleHelpers.h"
 #include "UserDefaults.h"
+#include "DebugHelpers.h"
 #include "fmt/core.h"
 
 // Change this to 0 to disable WTSE component, to disable for release: change value, test, and push
@@ -150,6 +151,10 @@ OscillatorWaveformDisplay::OscillatorWaveformDisplay()
     };
 
     customEditorAccOverlay = std::move(ol);
+
+    waveRenderer = std::make_unique<BackgroundCurveRenderer<WaveJob, WaveCurve>>(
+        this, [this](auto &job, auto &curve) { return renderWave(job, curve); },
+        [this]() { repaint(); });
 }
 
 OscillatorWaveformDisplay::~OscillatorWaveformDisplay() = default;
@@ -172,12 +177,7 @@ void OscillatorWaveformDisplay::paint(juce::Graphics &g)
 
     if (!skipEntireOscillator)
     {
-        auto osc = setupOscillator();
-
-        if (!osc)
-        {
-            return;
-        }
+        Surge::Debug::TimeB paintTimer("oscPaint");
 
         int totalSamples = (1 << 3) * (int)getWidth();
         int averagingWindow = 4; // < and Mult of BlockSizeOS
@@ -212,63 +212,32 @@ void OscillatorWaveformDisplay::paint(juce::Graphics &g)
             // That's a strange non-monotonic tuning. Oh well.
         }
 
-        bool use_display = osc->allow_display();
-
-        if (use_display)
-        {
-            osc->init(disp_pitch_rs, true, true);
-        }
+        auto curve = waveRenderer->get(waveKey(disp_pitch_rs, totalSamples), [&]() {
+            return makeWaveJob(disp_pitch_rs, totalSamples, averagingWindow);
+        });
 
-        int block_pos = BLOCK_SIZE;
+        // until the first render is back there's nothing to draw but the frame
         juce::Path wavePath;
 
-        float oscTmp alignas(16)[2][BLOCK_SIZE_OS];
-        sst::filters::HalfRate::HalfRateFilter hr(6, true);
-        hr.load_coefficients();
-        hr.reset();
-
-        for (int i = 0; i < totalSamples; i += averagingWindow)
+        if (curve)
         {
-            if (use_display && block_pos >= BLOCK_SIZE)
-            {
-                // Lock it even if we aren't wavetable. It's fine.
-                storage->waveTableDataMutex.lock();
-                osc->process_block(disp_pitch_rs);
-                memcpy(oscTmp[0], osc->output, sizeof(oscTmp[0]));
-                memcpy(oscTmp[1], osc->output, sizeof(oscTmp[1]));
-                hr.process_block_D2(oscTmp[0], oscTmp[1], BLOCK_SIZE_OS);
-                block_pos = 0;
-                storage->waveTableDataMutex.unlock();
-            }
-
-            float val = 0.f;
+            auto n = curve->vals.size();
 
-            if (use_display)
+            for (size_t i = 0; i < n; ++i)
             {
-                for (int j = 0; j < averagingWindow; ++j)
+                float xc = 1.f * i / n;
+
+                if (i == 0)
                 {
-                    val += oscTmp[0][block_pos];
-                    block_pos++;
+                    wavePath.startNewSubPath(xc, curve->vals[i]);
+                }
+                else
+                {
+                    wavePath.lineTo(xc, curve->vals[i]);
                 }
-
-                val = val / averagingWindow;
-            }
-
-            float xc = 1.f * i / totalSamples;
-
-            if (i == 0)
-            {
-                wavePath.startNewSubPath(xc, val);
-            }
-            else
-            {
-                wavePath.lineTo(xc, val);
             }
         }
 
-        osc->~Oscillator();
-        osc = nullptr;
-
         auto yMargin = 2 * usesWT;
         auto h = getHeight() - usesWT * wtbheight - 2 * yMargin;
         auto xMargin = 2;
@@ -543,6 +512,148 @@ void OscillatorWaveformDisplay::repaintBasedOnOscMuteState()
     return spawn_osc(oscdata->type.val.i, storage, oscdata, tp, tp, oscbuffer);
 }
 
+uint64_t OscillatorWaveformDisplay::waveKey(float pitch, int totalSamples)
+{
+    uint64_t h = 0;
+
+    hashCombine(h, oscdata->type.val.i);
+    hashCombine(h, totalSamples);
+    // covers the sample rate and tuning as well as the pitch
+    hashCombine(h, hashFloat(storage->note_to_pitch(pitch)));
+
+    for (int i = 0; i < n_osc_params; i++)
+    {
+        auto &p = oscdata->p[i];
+
+        hashCombine(h, p.val.i);
+        hashCombine(h, p.deform_type);
+        hashCombine(h, p.extend_range);
+        hashCombine(h, p.absolute);
+        hashCombine(h, p.deactivated);
+    }
+
+    hashCombine(h, oscdata->extraConfig.nData);
+
+    for (int i = 0; i < oscdata->extraConfig.nData; i++)
+    {
+        hashCombine(h, hashFloat(oscdata->extraConfig.data[i]));
+    }
+
+    {
+        // a dropped or scripted wavetable has no id, so what it was built from tells them apart
+        std::lock_guard<std::mutex> g(storage->waveTableDataMutex);
+
+        hashCombine(h, oscdata->wt.current_id);
+        hashCombine(h, oscdata->wt.contentHash());
+        hashCombine(h, oscdata->wt.size);
+        hashCombine(h, oscdata->wt.n_tables);
+        hashCombine(h, oscdata->wt.flags);
+    }
+
+    return h;
+}
+
+OscillatorWaveformDisplay::WaveJob
+OscillatorWaveformDisplay::makeWaveJob(float pitch, int totalSamples, int averagingWindow)
+{
+    WaveJob job;
+
+    job.osc = std::make_unique<OscillatorStorage>();
+    auto &o = *job.osc;
+
+    o.type = oscdata->type;
+    o.pitch = oscdata->pitch;
+    o.octave = oscdata->octave;
+
+    for (int i = 0; i < n_osc_params; i++)
+    {
+        o.p[i] = oscdata->p[i];
+    }
+
+    o.keytrack = oscdata->keytrack;
+    o.retrigger = oscdata->retrigger;
+    o.extraConfig = oscdata->extraConfig;
+
+    {
+        // the loader may be swapping in another wavetable
+        std::lock_guard<std::mutex> g(storage->waveTableDataMutex);
+        o.wt.Copy(&oscdata->wt);
+    }
+
+    job.pitch = pitch;
+    job.totalSamples = totalSamples;
+    job.averagingWindow = averagingWindow;
+    job.tp[o.pitch.param_id_in_scene].f = 0;
+
+    for (int i = 0; i < n_osc_params; i++)
+    {
+        job.tp[o.p[i].param_id_in_scene].i = o.p[i].val.i;
+    }
+
+    return job;
+}
+
+bool OscillatorWaveformDisplay::renderWave(WaveJob &job, WaveCurve &curve)
+{
+    Surge::Debug::TimeB renderTimer("-- renderWave");
+
+    auto osc = spawn_osc(job.osc->type.val.i, storage, job.osc.get(), job.tp, job.tp,
+                         renderOscbuffer);
+
+    if (!osc)
+    {
+        return false;
+    }
+
+    bool use_display = osc->allow_display();
+
+    if (use_display)
+    {
+        osc->init(job.pitch, true, true);
+    }
+
+    int block_pos = BLOCK_SIZE;
+
+    float oscTmp alignas(16)[2][BLOCK_SIZE_OS];
+    sst::filters::HalfRate::HalfRateFilter hr(6, true);
+    hr.load_coefficients();
+    hr.reset();
+
+    curve.vals.reserve(job.totalSamples / job.averagingWindow + 1);
+
+    for (int i = 0; i < job.totalSamples; i += job.averagingWindow)
+    {
+        if (use_display && block_pos >= BLOCK_SIZE)
+        {
+            // the job's wavetable holds on to its data, so there's nothing to lock
+            osc->process_block(job.pitch);
+            memcpy(oscTmp[0], osc->output, sizeof(oscTmp[0]));
+            memcpy(oscTmp[1], osc->output, sizeof(oscTmp[1]));
+            hr.process_block_D2(oscTmp[0], oscTmp[1], BLOCK_SIZE_OS);
+            block_pos = 0;
+        }
+
+        float val = 0.f;
+
+        if (use_display)
+        {
+            for (int j = 0; j < job.averagingWindow; ++j)
+            {
+                val += oscTmp[0][block_pos];
+                block_pos++;
+            }
+
+            val = val / job.averagingWindow;
+        }
+
+        curve.vals.push_back(val);
+    }
+
+    osc->~Oscillator();
+
+    return true;
+}
+
 void OscillatorWaveformDisplay::populateMenu(juce::PopupMenu &contextMenu, int selectedItem,
                                              bool singleCategory)
 {
@@ -27,6 +27,7 @@
 #include "Parameter.h"
 #include "SurgeStorage.h"
 #include "WidgetBaseMixin.h"
+#include "BackgroundCurveRenderer.h"
 
 #include "juce_gui_basics/juce_gui_basics.h"
 #include "Oscillator.h"
@@ -138,6 +139,35 @@ struct OscillatorWaveformDisplay : public juce::Component,
     int lastWavetableId{-1};
     std::string lastWavetableFilename;
 
+    /*
+     * The wave is rendered by running the oscillator on waveRenderer's thread from a copy of the
+     * oscillator storage, which shares the built wavetable data rather than copying it, keyed by
+     * a hash of everything which shapes it, so repaints which change none of that reuse the last
+     * render.
+     */
+    struct WaveJob
+    {
+        std::unique_ptr<OscillatorStorage> osc;
+        float pitch{0};
+        int totalSamples{0}, averagingWindow{1};
+        pdata tp[n_scene_params];
+    };
+
+    struct WaveCurve
+    {
+        std::vector<float> vals;
+    };
+
+    uint64_t waveKey(float pitch, int totalSamples);
+    WaveJob makeWaveJob(float pitch, int totalSamples, int averagingWindow);
+    bool renderWave(WaveJob &job, WaveCurve &curve);
+
+    // only ever touched by waveRenderer's thread
+    unsigned char renderOscbuffer alignas(16)[oscillator_buffer_size];
+
+    // last, so it stops rendering before anything it renders with goes away
+    std::unique_ptr<BackgroundCurveRenderer<WaveJob, WaveCurve>> waveRenderer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscillatorWaveformDisplay);
 };
 
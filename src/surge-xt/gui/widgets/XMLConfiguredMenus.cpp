@@ -378,7 +378,7 @@ void OscillatorMenu::loadSnapshot(int type, TiXmlElement *e, int idx)
         sge->enqueueAccessibleAnnouncement(announce);
     }
     osc->queue_type = type;
-    osc->queue_xmldata = e;
+    osc->queueSnapshot(e);
 }
 
 void OscillatorMenu::setOscillatorStorage(OscillatorStorage *o)
@@ -44,6 +44,8 @@ OpenSoundControl::OpenSoundControl() {}
 
 OpenSoundControl::~OpenSoundControl()
 {
+    stopTimer();
+
     if (listening)
     {
         stopListening(false);
@@ -1284,22 +1286,12 @@ bool OpenSoundControl::initOSCOut(int port, std::string ipaddr)
 
     // Add a listener for parameter changes that happen on the audio thread
     //  (e.g. MIDI-'learned' parameters being changed by incoming MIDI messages)
+    // The audio thread only queues these; our timer drains them on the message thread.
     synth->addAudioParamListener(
-        "OSC_OUT", [this, ssp = sspPtr](std::string oname, float fval, std::string valstr) {
-            assert(juce::MessageManager::getInstanceWithoutCreating());
-            auto *mm = juce::MessageManager::getInstanceWithoutCreating();
-            if (mm)
-            {
-                mm->callAsync([ssp, oname, fval, valstr]() {
-                    ssp->param_change_to_OSC(oname, 1, fval, 0., 0., valstr);
-                });
-            }
-            else
-            {
-                std::cerr << "The juce message manager is not running. You are misconfigured"
-                          << std::endl;
-            }
+        "OSC_OUT", [ssp = sspPtr](std::string oname, float fval, std::string valstr) {
+            ssp->param_change_to_OSC(oname, 1, fval, 0., 0., valstr);
         });
+    startTimer(20);
 
     // Add a listener for modulation changes
     synth->addModulationAPIListener(this);
@@ -1324,6 +1316,7 @@ void OpenSoundControl::stopSending(bool updateOSCStartInStorage)
     synth->storage.oscSending = false;
 
     synth->deletePatchLoadedListener("OSC_OUT");
+    stopTimer();
     synth->deleteAudioParamListener("OSC_OUT");
     sspPtr->deleteParamChangeListener("OSC_OUT");
 
@@ -1333,6 +1326,14 @@ void OpenSoundControl::stopSending(bool updateOSCStartInStorage)
     }
 }
 
+void OpenSoundControl::timerCallback()
+{
+    if (synth)
+    {
+        synth->drainAudioParamEvents();
+    }
+}
+
 void OpenSoundControl::send(juce::OSCMessage om, bool needsMessageThread)
 {
     if (sendingOSC)
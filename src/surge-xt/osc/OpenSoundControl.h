@@ -51,7 +51,8 @@ namespace OSC
 
 class OpenSoundControl : public juce::OSCReceiver,
                          public SurgeSynthesizer::ModulationAPIListener,
-                         juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+                         juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>,
+                         juce::Timer
 {
   public:
     OpenSoundControl();
@@ -90,6 +91,9 @@ class OpenSoundControl : public juce::OSCReceiver,
 
     void modOSCout(std::string addr, std::string oscName, float val, bool reportMute);
 
+    // Delivers the parameter changes the audio thread queued while we are sending
+    void timerCallback() override;
+
   private:
     SurgeSynthesizer *synth{nullptr};
     SurgeSynthProcessor *sspPtr{nullptr};